@@ -209,15 +209,38 @@ DRFLAC_API const char* drflac_version_string(void);
 
 /*
 As data is read from the client it is placed into an internal buffer for fast
-access. This controls the size of that buffer. Larger values means more speed,
-but also more memory. In my testing there is diminishing returns after about
-4KB, but you can fiddle with this to suit your own needs. Must be a multiple
-of 8.
+access. This controls the default size of that buffer. Larger values means more
+speed, but also more memory. In my testing there is diminishing returns after
+about 4KB, but you can fiddle with this to suit your own needs. Must be a
+multiple of 8. Use drflac_open_with_buffer_size() to choose the size at run time
+instead.
 */
 #ifndef DR_FLAC_BUFFER_SIZE
 #define DR_FLAC_BUFFER_SIZE 4096
 #endif
 
+/*
+When opening a decoder with a metadata callback, the picture data of PICTURE
+blocks at least this many bytes in size is not loaded. The callback is given
+the size and position of the picture data instead, which can then be loaded
+with drflac_read_picture_data() if it's needed. Set to 0, the default, to
+always load picture data. Picture data in Ogg streams is always loaded.
+*/
+#ifndef DR_FLAC_LAZY_PICTURE_SIZE
+#define DR_FLAC_LAZY_PICTURE_SIZE 0
+#endif
+
+/*
+The decoder remembers the position of each FLAC frame it decodes so that seeking
+back to it later doesn't require a search. For Ogg streams it instead remembers
+the pages it passes over while seeking. This is the maximum number of positions
+it will remember, which at 18 bytes each bounds the memory used. Set this to 0
+to disable it. Indexes built with drflac_build_seek_index() are not limited.
+*/
+#ifndef DR_FLAC_SEEK_INDEX_MAX_ENTRIES
+#define DR_FLAC_SEEK_INDEX_MAX_ENTRIES 65536
+#endif
+
 /* Check if we can enable 64-bit optimizations. */
 #if defined(_WIN64) || defined(_LP64) || defined(__LP64__)
 #define DRFLAC_64BIT
@@ -270,6 +293,13 @@ typedef enum {
 
 typedef enum { drflac_seek_origin_start, drflac_seek_origin_current } drflac_seek_origin;
 
+typedef enum {
+  drflac_md5_match,       /* The decoded audio matches the MD5 in STREAMINFO. */
+  drflac_md5_mismatch,    /* The decoded audio does not match. */
+  drflac_md5_incomplete,  /* Not all of the audio has been decoded in order. */
+  drflac_md5_unavailable  /* The encoder did not store an MD5. */
+} drflac_md5_result;
+
 /* Packing is important on this structure because we map this directly to the
  * raw data within the SEEKTABLE metadata block. */
 #pragma pack(2)
@@ -357,6 +387,13 @@ typedef struct {
       uint32_t indexColorCount;
       uint32_t pictureDataSize;
       const uint8_t* pPictureData;
+
+      /*
+      The position of the picture data in bytes from the start of the stream,
+      for use with drflac_read_picture_data(). This is 0 for Ogg streams.
+      pPictureData is NULL when the picture data was not loaded.
+      */
+      uint64_t pictureDataOffset;
     } picture;
   } data;
 } drflac_metadata;
@@ -452,6 +489,14 @@ typedef struct {
   size_t currentReadPos;
 } drflac__memory_stream;
 
+/* Structure for internal use. Used for verifying the MD5 of the decoded audio.
+ */
+typedef struct {
+  uint32_t state[4];
+  uint64_t byteCount;
+  uint8_t block[64];
+} drflac__md5_context;
+
 /* Structure for internal use. Used for bit streaming. */
 typedef struct {
   /* The function to call when more data needs to be read. */
@@ -463,6 +508,21 @@ typedef struct {
   /* The user data to pass around to onRead and onSeek. */
   void* pUserData;
 
+  /*
+  When set, the stream is backed by a contiguous block of memory and the L1
+  cache is reloaded directly from it rather than going through onRead() and the
+  L2 cache. The read position is shared with onRead() and onSeek(), which must
+  be operating on the same memory stream.
+  */
+  drflac__memory_stream* pDirectStream;
+
+  /*
+  The position of the client's read pointer relative to the start of the stream.
+  This is used to work out the byte position of each FLAC frame for seek
+  indexing and is only meaningful for native streams.
+  */
+  uint64_t clientBytePos;
+
   /*
   The number of unaligned bytes in the L2 cache. This will always be 0 until the
   end of the stream is hit. At the end of the stream there will be a number of
@@ -485,9 +545,11 @@ typedef struct {
   /*
   The cached data which was most recently read from the client. There are two
   levels of cache. Data flows as such: Client -> L2 -> L1. The L2 -> L1 movement
-  is aligned and runs on a fast path in just a few instructions.
+  is aligned and runs on a fast path in just a few instructions. The L2 cache is
+  an offset of drflac::pExtraData and its size is set when the decoder is opened.
   */
-  drflac_cache_t cacheL2[DR_FLAC_BUFFER_SIZE / sizeof(drflac_cache_t)];
+  drflac_cache_t* cacheL2;
+  uint32_t cacheL2LineCount;
   drflac_cache_t cache;
 
   /*
@@ -571,6 +633,10 @@ typedef struct {
   /* The list of sub-frames within the frame. There is one sub-frame for each
    * channel, and there's a maximum of 8 channels. */
   drflac_subframe subframes[8];
+
+  /* Set when drflac_read_next_flac_frame() has converted the decoded samples
+   * in place, in which case they can no longer be read as subframe data. */
+  bool isConvertedInPlace;
 } drflac_frame;
 
 typedef struct {
@@ -583,6 +649,10 @@ typedef struct {
   /* Memory allocation callbacks. */
   drlibs_allocation_callbacks allocationCallbacks;
 
+  /* The size in bytes of the allocation holding this object and pExtraData.
+   * Used by drflac_reopen() to decide whether the allocation can be reused. */
+  uint32_t allocationSize;
+
   /* The sample rate. Will be set to something like 44100. */
   uint32_t sampleRate;
 
@@ -604,6 +674,9 @@ typedef struct {
   The total number of PCM Frames making up the stream. Can be 0 in which case
   it's still a valid stream, but just means the total PCM frame count is
   unknown. Likely the case with streams like internet radio.
+
+  For a chained Ogg stream this only covers the links that have been found so
+  far, and the format members above describe the current link.
   */
   uint64_t totalPCMFrameCount;
 
@@ -636,16 +709,59 @@ typedef struct {
    * there is no seek table. */
   drflac_seekpoint* pSeekpoints;
 
+  /*
+  An index of FLAC frame positions, stored in the same format as the seek table
+  and sorted by PCM frame. Frames are added as they're decoded, up to
+  DR_FLAC_SEEK_INDEX_MAX_ENTRIES, and drflac_build_seek_index() fills in the
+  whole stream. This is allocated separately with the allocation callbacks.
+
+  For Ogg streams this is an index of pages instead. flacFrameOffset is the
+  position of the page relative to the start of the Ogg stream and
+  pcmFrameCount is the position of the frame within the page. Pages are added
+  as they're passed over while seeking.
+  */
+  drflac_seekpoint* pSeekIndex;
+  uint32_t seekIndexCount;
+  uint32_t seekIndexCapacity;
+
+  /* The MD5 of the unencoded audio from the STREAMINFO block. All zeros if it
+   * was not computed by the encoder. */
+  uint8_t md5[16];
+
+  /* The running MD5 of the decoded audio. Only used when enabled with
+   * drflac_enable_md5_verification(). */
+  drflac__md5_context md5Context;
+
+  /* The index of the PCM frame the MD5 is expecting next. Frames are only
+   * hashed when they are decoded in order starting from this one. */
+  uint64_t md5NextPCMFrame;
+
   /* Internal use only. Only used with Ogg containers. Points to a drflac_oggbs
    * object. This is an offset of pExtraData. */
   void* _oggbs;
 
+  /* Internal use only. One bit per channel for the channels that are not
+   * decoded. Set with drflac_set_channel_mask(). */
+  uint8_t _skippedChannelMask;
+
   /* Internal use only. Used for profiling and testing different seeking modes.
    */
   bool _noSeekTableSeek : 1;
   bool _noBinarySearchSeek : 1;
   bool _noBruteForceSeek : 1;
 
+  /* Internal use only. Set when memoryStream points to a file mapping created
+   * by drflac_open_file_mmap() which needs to be unmapped by drflac_close(). */
+  bool _isMappedFile : 1;
+
+  /* Internal use only. MD5 verification state. _isMD5AtEnd is set when the end
+   * of the stream is reached straight after the last hashed frame.
+   * _isMD5Mismatched is set when an earlier link of a chained Ogg stream did
+   * not match. */
+  bool _isMD5Enabled : 1;
+  bool _isMD5AtEnd : 1;
+  bool _isMD5Mismatched : 1;
+
   /* The bit streamer. The raw FLAC data is fed through this object. */
   drflac_bs bs;
 
@@ -654,6 +770,46 @@ typedef struct {
   uint8_t pExtraData[1];
 } drflac;
 
+/*
+A view into the decoder's own sample buffers for a single FLAC frame. See
+drflac_read_next_flac_frame().
+*/
+typedef struct {
+  /* The index of the first PCM frame in the view. */
+  uint64_t firstPCMFrame;
+
+  /* The number of PCM frames in the view. */
+  uint32_t pcmFrameCount;
+
+  /* The number of channels. Only the first `channels` items in ppSamples are valid. */
+  uint32_t channels;
+
+  /* One pointer per channel, each pointing to `pcmFrameCount` signed 32-bit samples. */
+  const int32_t* ppSamples[8];
+} drflac_frame_view;
+
+/*
+Peak and level figures for a single FLAC frame. See
+drflac_read_next_flac_frame_summary().
+*/
+typedef struct {
+  /* The index of the first PCM frame that was summarised. */
+  uint64_t firstPCMFrame;
+
+  /* The number of PCM frames that were summarised. */
+  uint32_t pcmFrameCount;
+
+  /* The number of channels. Only the first `channels` items in each array are valid. */
+  uint32_t channels;
+
+  /* The lowest and highest sample of each channel, normalised to [-1, 1). */
+  float minSample[8];
+  float maxSample[8];
+
+  /* The root mean square of each channel, normalised the same way. */
+  float rms[8];
+} drflac_frame_summary;
+
 /*
 Opens a FLAC decoder.
 
@@ -692,6 +848,13 @@ open a native or Ogg encapsulated FLAC, both of which should work seamlessly
 without any manual intervention. Ogg encapsulation also works with multiplexed
 streams which basically means it can play FLAC encoded audio tracks in videos.
 
+Chained Ogg streams, where one FLAC stream follows another, are decoded as a
+single stream. Each link can have a different format, so the sample rate,
+channel count and bits per sample can change as decoding reaches a new link. A
+read never returns audio from two links with different formats, so check the
+format after a short read. Links are found as decoding reaches them, and
+drflac_build_seek_index() finds all of them up front.
+
 This is the lowest level function for opening a FLAC stream. You can also use
 `drflac_open_file()` and `drflac_open_memory()` to open the stream from a file
 or from a block of memory respectively.
@@ -810,6 +973,11 @@ pointer to a `drflac_metadata` object which is a union containing the data of
 all relevant metadata blocks. Use the `type` member to discriminate against the
 different metadata types.
 
+With a chained Ogg stream, `onMeta` is also called from the read functions when
+decoding reaches the next link, starting with its STREAMINFO block. This is how
+a change of format is announced. Links found while seeking or building a seek
+index aren't reported.
+
 The STREAMINFO block must be present for this to succeed. Use
 `drflac_open_with_metadata_relaxed()` to open a FLAC stream where the header may
 not be present.
@@ -850,6 +1018,276 @@ drflac_open_with_metadata_relaxed(drflac_read_proc onRead, drflac_seek_proc onSe
                                   void* pUserData,
                                   const drlibs_allocation_callbacks* pAllocationCallbacks);
 
+/*
+The same as drflac_open_with_metadata(), except the size of the buffer used for
+reading from the client is chosen at run time.
+
+
+Parameters
+----------
+onRead (in)
+    The function to call when data needs to be read from the client.
+
+onSeek (in)
+    The function to call when the read position of the client data needs to
+move.
+
+onMeta (in, optional)
+    The function to call for every metadata block. Can be NULL.
+
+pUserData (in, optional)
+    A pointer to application defined data that will be passed to onRead, onSeek
+and onMeta.
+
+bufferSizeInBytes (in)
+    The number of bytes to request from onRead at a time. Pass 0 to use
+DR_FLAC_BUFFER_SIZE.
+
+pAllocationCallbacks (in, optional)
+    A pointer to application defined callbacks for managing memory allocations.
+
+
+Return Value
+------------
+A pointer to an object representing the decoder, or NULL if an error occurred.
+
+
+Remarks
+-------
+The buffer is allocated along with the decoder so this does not add an extra
+allocation. It's rounded down to a multiple of sizeof(drflac_cache_t), which
+is 8 bytes on 64-bit builds and 4 bytes otherwise, and this will fail if it's
+larger than 1GB.
+
+Large buffers reduce the number of calls to onRead, which is useful when each
+read is expensive such as network backed storage. Small buffers reduce the
+memory used by each decoder, which is useful when many low bitrate streams are
+open at the same time.
+
+
+See Also
+--------
+drflac_open_file_with_buffer_size()
+drflac_open_with_metadata()
+*/
+DRFLAC_API drflac*
+drflac_open_with_buffer_size(drflac_read_proc onRead, drflac_seek_proc onSeek,
+                             drflac_meta_proc onMeta, void* pUserData, size_t bufferSizeInBytes,
+                             const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/*
+Retrieves the number of bytes drflac_open_preallocated() needs for the given
+stream.
+
+
+Parameters
+----------
+onRead (in)
+    The function to call when data needs to be read from the client.
+
+onSeek (in)
+    The function to call when the read position of the client data needs to
+move.
+
+onMeta (in, optional)
+    The metadata callback that will be passed to drflac_open_preallocated(), or
+NULL if there won't be one. It is not called.
+
+pUserData (in, optional)
+    A pointer to application defined data that will be passed to onRead and
+onSeek.
+
+pSizeInBytes (out)
+    Receives the required size in bytes.
+
+
+Return Value
+------------
+DRFLAC_TRUE if successful; DRFLAC_FALSE if the stream could not be opened.
+
+
+Remarks
+-------
+This reads the metadata block headers, STREAMINFO and SEEKTABLE of the stream
+and then seeks the client back to the start, ready for
+drflac_open_preallocated(). Nothing is allocated.
+
+With a metadata callback each metadata block is loaded into the same memory
+before the decoder is placed there, so when onMeta is not NULL the size is also
+at least as large as the largest metadata block.
+
+
+See Also
+--------
+drflac_open_preallocated()
+*/
+DRFLAC_API bool drflac_get_preallocated_size(drflac_read_proc onRead, drflac_seek_proc onSeek,
+                                             drflac_meta_proc onMeta, void* pUserData,
+                                             size_t* pSizeInBytes);
+
+/*
+Opens a FLAC decoder inside memory provided by the caller.
+
+
+Parameters
+----------
+onRead (in)
+    The function to call when data needs to be read from the client.
+
+onSeek (in)
+    The function to call when the read position of the client data needs to
+move.
+
+onMeta (in, optional)
+    The function to call for every metadata block. Can be NULL.
+
+pUserData (in, optional)
+    A pointer to application defined data that will be passed to onRead, onSeek
+and onMeta.
+
+pMemory (in)
+    The memory to place the decoder in. Must be aligned to 16 bytes.
+
+memorySizeInBytes (in)
+    The size of the memory pointed to by pMemory. Use
+drflac_get_preallocated_size() to find out how much is needed.
+
+
+Return Value
+------------
+A pointer to an object representing the decoder, or NULL if an error occurred.
+This will be equal to pMemory when successful.
+
+
+Remarks
+-------
+The decoder never allocates memory, which makes it suitable for threads where
+calling malloc() is not allowed. Features that need to allocate fail gracefully
+instead. In particular, the seek index is not populated while decoding and
+drflac_build_seek_index() and drflac_load_seek_index() will fail. Likewise the
+table of links in a chained Ogg stream can't grow, so a chained stream ends
+after its first link as if that were the whole stream.
+
+Use drflac_close() when finished with the decoder. It will not free the
+memory, which remains owned by the caller. The decoder can also be passed to
+drflac_reopen(), in which case the new stream must fit inside the same memory,
+as must its metadata blocks when there's a metadata callback.
+
+
+See Also
+--------
+drflac_get_preallocated_size()
+drflac_close()
+*/
+DRFLAC_API drflac* drflac_open_preallocated(drflac_read_proc onRead, drflac_seek_proc onSeek,
+                                            drflac_meta_proc onMeta, void* pUserData,
+                                            void* pMemory, size_t memorySizeInBytes);
+
+/*
+Reads the STREAMINFO block and, optionally, the other metadata blocks of a
+stream without opening a decoder.
+
+
+Parameters
+----------
+onRead (in)
+    The function to call when data needs to be read from the client.
+
+onSeek (in)
+    The function to call when the read position of the client data needs to
+move.
+
+onMeta (in, optional)
+    The function to call for every metadata block. Can be NULL.
+
+pUserData (in, optional)
+    A pointer to application defined data that will be passed to onRead, onSeek
+and onMeta.
+
+pStreamInfo (out, optional)
+    Receives the contents of the STREAMINFO block.
+
+pAllocationCallbacks (in, optional)
+    A pointer to application defined callbacks for managing memory allocations.
+
+
+Return Value
+------------
+DRFLAC_TRUE if successful; DRFLAC_FALSE if the stream is not a valid FLAC
+stream or a metadata block could not be read.
+
+
+Remarks
+-------
+This is intended for scanning large numbers of files. Nothing is decoded and
+no decoder is allocated. When onMeta is NULL, reading stops after the STREAMINFO
+block and nothing is allocated at all. Otherwise each metadata block is loaded
+into a temporary buffer for the duration of the callback, the same as
+drflac_open_with_metadata().
+
+The picture data of PICTURE blocks is never loaded, regardless of
+DR_FLAC_LAZY_PICTURE_SIZE. Only the fields in front of it are. In the callback,
+`pPictureData` will be NULL, `pictureDataSize` and `pictureDataOffset` will
+locate the picture data in the stream and `pRawData` and `rawDataSize` will
+only cover the fields that were loaded.
+
+Unlike drflac_open_with_metadata(), the STREAMINFO block is never optional, so
+this will fail on streams that only open in relaxed mode.
+
+
+See Also
+--------
+drflac_probe_file()
+drflac_probe_memory()
+drflac_open_with_metadata()
+*/
+DRFLAC_API bool drflac_probe(drflac_read_proc onRead, drflac_seek_proc onSeek,
+                             drflac_meta_proc onMeta, void* pUserData,
+                             drflac_streaminfo* pStreamInfo,
+                             const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/*
+Reads picture data that was not loaded when the decoder was opened.
+
+
+Parameters
+----------
+pFlac (in)
+    The decoder.
+
+pictureDataOffset (in)
+    The `pictureDataOffset` member of the PICTURE metadata block.
+
+pBufferOut (out)
+    A pointer to the buffer that will receive the picture data.
+
+bytesToRead (in)
+    The number of bytes to read. This is normally the `pictureDataSize` member
+of the PICTURE metadata block.
+
+
+Return Value
+------------
+The number of bytes actually read. Returns 0 on error, or if the stream is Ogg.
+
+
+Remarks
+-------
+The picture data is read directly from the client and the decoder is left
+exactly where it was, so this can be called at any time. Make a note of
+`pictureDataOffset` and `pictureDataSize` in the metadata callback, which will
+have NULL `pPictureData` for pictures of at least DR_FLAC_LAZY_PICTURE_SIZE
+bytes.
+
+
+See Also
+--------
+DR_FLAC_LAZY_PICTURE_SIZE
+drflac_open_with_metadata()
+*/
+DRFLAC_API size_t drflac_read_picture_data(drflac* pFlac, uint64_t pictureDataOffset,
+                                           void* pBufferOut, size_t bytesToRead);
+
 /*
 Closes the given FLAC decoder.
 
@@ -875,9 +1313,73 @@ drflac_open_file_with_metadata()
 drflac_open_file_with_metadata_w()
 drflac_open_memory()
 drflac_open_memory_with_metadata()
+drflac_reopen()
 */
 DRFLAC_API void drflac_close(drflac* pFlac);
 
+/*
+Closes the stream of the given decoder and opens a new one in its place,
+reusing the decoder's memory.
+
+
+Parameters
+----------
+pFlac (in, optional)
+    The decoder to reuse. Can be NULL, in which case this is the same as
+drflac_open_with_metadata() with default allocation callbacks.
+
+onRead (in)
+    The function to call when data needs to be read from the client.
+
+onSeek (in)
+    The function to call when the read position of the client data needs to
+move.
+
+onMeta (in, optional)
+    The function to call for every metadata block. Can be NULL.
+
+pUserData (in, optional)
+    A pointer to application defined data that will be passed to onRead, onSeek
+and onMeta.
+
+
+Return Value
+------------
+A pointer to the decoder of the new stream, or NULL if an error occurred.
+
+
+Remarks
+-------
+This is the equivalent of calling drflac_close() followed by
+drflac_open_with_metadata(), but without freeing and allocating the decoder.
+The existing allocation is used as-is if the new stream fits inside it. If it
+doesn't, the allocation is resized with the decoder's allocation callbacks, in
+which case the returned pointer will be different to pFlac. The allocation
+callbacks, the size of the read buffer and the memory of the seek index carry
+over from the old decoder. Everything else is reset, including MD5
+verification.
+
+A decoder opened with drflac_open_preallocated() stays in the caller's memory,
+which metadata blocks are again loaded into before the decoder. This fails if
+the new stream doesn't fit.
+
+In all cases pFlac must not be used after calling this. Use the return value
+instead. If an error occurs the old decoder is freed as if drflac_close() had
+been called.
+
+This is useful for pooling decoders when many short streams are opened and
+closed in quick succession.
+
+
+See Also
+--------
+drflac_reopen_file()
+drflac_reopen_memory()
+drflac_close()
+*/
+DRFLAC_API drflac* drflac_reopen(drflac* pFlac, drflac_read_proc onRead, drflac_seek_proc onSeek,
+                                 drflac_meta_proc onMeta, void* pUserData);
+
 /*
 Reads sample data from the given FLAC decoder, output as interleaved signed
 32-bit PCM.
@@ -905,6 +1407,10 @@ Remarks
 -------
 pBufferOut can be null, in which case the call will act as a seek, and the
 return value will be the number of frames seeked.
+
+With a chained Ogg stream this and the other read functions also return early
+at the start of a link with a different format. The decoder's format members
+describe the new link by the time this returns.
 */
 DRFLAC_API uint64_t drflac_read_pcm_frames_s32(drflac* pFlac, uint64_t framesToRead,
                                                     int32_t* pBufferOut);
@@ -977,7 +1483,8 @@ DRFLAC_API uint64_t drflac_read_pcm_frames_f32(drflac* pFlac, uint64_t framesToR
                                                     float* pBufferOut);
 
 /*
-Seeks to the PCM frame at the given index.
+Reads sample data from the given FLAC decoder, output as planar signed 32-bit
+PCM with each channel written to its own buffer.
 
 
 Parameters
@@ -985,7 +1492,255 @@ Parameters
 pFlac (in)
     The decoder.
 
-pcmFrameIndex (in)
+framesToRead (in)
+    The number of PCM frames to read.
+
+ppBuffersOut (out, optional)
+    An array of `pFlac->channels` pointers, one per channel, each of which will
+    receive `framesToRead` samples.
+
+
+Return Value
+------------
+Returns the number of PCM frames actually read. If the return value is less than
+`framesToRead` it has reached the end.
+
+
+Remarks
+-------
+ppBuffersOut can be null, in which case the call will act as a seek, and the
+return value will be the number of frames seeked. Otherwise every channel
+pointer must be valid.
+
+The decoder stores each channel separately internally so this avoids the
+interleaving step entirely. Use this instead of de-interleaving the output of
+drflac_read_pcm_frames_s32() yourself.
+
+
+See Also
+--------
+drflac_read_pcm_frames_s16_planar()
+drflac_read_pcm_frames_f32_planar()
+drflac_read_pcm_frames_s32()
+*/
+DRFLAC_API uint64_t drflac_read_pcm_frames_s32_planar(drflac* pFlac, uint64_t framesToRead,
+                                                      int32_t** ppBuffersOut);
+
+/* Same as drflac_read_pcm_frames_s32_planar(), except outputs signed 16-bit
+ * integer samples. This is lossy for streams with more than 16 bits per sample.
+ */
+DRFLAC_API uint64_t drflac_read_pcm_frames_s16_planar(drflac* pFlac, uint64_t framesToRead,
+                                                      int16_t** ppBuffersOut);
+
+/* Same as drflac_read_pcm_frames_s32_planar(), except outputs 32-bit floating
+ * point samples. */
+DRFLAC_API uint64_t drflac_read_pcm_frames_f32_planar(drflac* pFlac, uint64_t framesToRead,
+                                                      float** ppBuffersOut);
+
+/*
+Decodes the next FLAC frame and returns pointers to the decoded samples without
+copying them out of the decoder.
+
+
+Parameters
+----------
+pFlac (in)
+    The decoder.
+
+pView (out)
+    Receives the location and size of the decoded samples.
+
+
+Return Value
+------------
+`DRFLAC_TRUE` if successful; `DRFLAC_FALSE` if the end of the stream has been
+reached or an error occurred.
+
+
+Remarks
+-------
+Samples are planar signed 32-bit PCM, in the same format as
+drflac_read_pcm_frames_s32_planar(). The pointers in pView point into the
+decoder's internal buffers and are only valid until the next call that reads
+from or seeks the decoder. Do not modify them.
+
+The decoder is advanced to the end of the frame. If the current frame has been
+partially consumed by one of the drflac_read_pcm_frames_*() APIs only the
+remaining PCM frames are returned, in which case pView->firstPCMFrame will not
+be on a frame boundary.
+
+This is useful for consumers that only need to scan the audio, such as
+loudness meters or fingerprinting, where one FLAC frame at a time is fine.
+
+
+See Also
+--------
+drflac_read_pcm_frames_s32_planar()
+*/
+DRFLAC_API bool drflac_read_next_flac_frame(drflac* pFlac, drflac_frame_view* pView);
+
+/*
+Decodes the next FLAC frame and summarises it as the minimum, maximum and RMS of
+each channel. This is intended for drawing waveform overviews.
+
+
+Parameters
+----------
+pFlac (in)
+    The decoder.
+
+pSummary (out)
+    Receives the summary of the frame.
+
+
+Return Value
+------------
+`DRFLAC_TRUE` if successful; `DRFLAC_FALSE` if the end of the stream has been
+reached or an error occurred.
+
+
+Remarks
+-------
+The figures are worked out from the decoder's own sample buffers so no PCM is
+converted or interleaved. Channels that are coded as a single constant value,
+which is typical of silence, are summarised from that value alone.
+
+Normalisation is the same as drflac_read_pcm_frames_f32(), so a full scale
+sample is -1. The figures are exact apart from rounding to float.
+
+The decoder is advanced to the end of the frame in the same way as
+drflac_read_next_flac_frame(), so the two can be mixed with the
+drflac_read_pcm_frames_*() APIs. Channels excluded with
+drflac_set_channel_mask() are summarised as silence.
+
+
+See Also
+--------
+drflac_read_next_flac_frame()
+drflac_set_channel_mask()
+*/
+DRFLAC_API bool drflac_read_next_flac_frame_summary(drflac* pFlac, drflac_frame_summary* pSummary);
+
+/*
+Enables verification of the decoded audio against the MD5 in the STREAMINFO
+block.
+
+
+Parameters
+----------
+pFlac (in)
+    The decoder.
+
+
+Return Value
+------------
+`DRFLAC_TRUE` if successful; `DRFLAC_FALSE` if the stream does not have an MD5.
+
+
+Remarks
+-------
+Once enabled, every FLAC frame is fed into the MD5 as it is decoded by any of
+the drflac_read_pcm_frames_*() APIs or drflac_read_next_flac_frame(). Call
+drflac_get_md5_result() when the stream has been read to the end to find out
+whether or not it matched.
+
+The hash is computed on the decoded samples before any format conversion, so
+the result is the same regardless of which read API is used. Whole FLAC frames
+are hashed in stream order, so seeking backwards is fine, but seeking forward
+past frames that have not been decoded yet leaves a gap. Frames after a gap are
+not hashed until the gap has been filled by seeking back and decoding it, and
+until then the result will be `drflac_md5_incomplete`.
+
+This should be called before reading any audio. It adds the cost of an MD5 of
+the raw audio to decoding, so it's off by default.
+
+Each link of a chained Ogg stream has its own MD5. A link is checked as decoding
+leaves it, and a mismatch is reported by drflac_get_md5_result() from then on.
+
+
+See Also
+--------
+drflac_get_md5_result()
+*/
+DRFLAC_API bool drflac_enable_md5_verification(drflac* pFlac);
+
+/*
+Retrieves the result of MD5 verification.
+
+
+Parameters
+----------
+pFlac (in)
+    The decoder.
+
+
+Return Value
+------------
+`drflac_md5_match` or `drflac_md5_mismatch` if the whole stream has been
+decoded in order. `drflac_md5_incomplete` if verification is not enabled, the
+end of the stream has not been reached or frames were skipped.
+`drflac_md5_unavailable` if the encoder did not store an MD5.
+
+
+See Also
+--------
+drflac_enable_md5_verification()
+*/
+DRFLAC_API drflac_md5_result drflac_get_md5_result(drflac* pFlac);
+
+/*
+Selects which channels are decoded.
+
+
+Parameters
+----------
+pFlac (in)
+    The decoder.
+
+channelMask (in)
+    One bit per channel, with bit 0 being the first channel. Set a bit to
+    decode that channel. Pass 0xFFFFFFFF to decode every channel.
+
+
+Return Value
+------------
+`DRFLAC_TRUE` if successful; `DRFLAC_FALSE` if pFlac is NULL or channelMask
+does not select any of the 8 channels a FLAC stream can have.
+
+
+Remarks
+-------
+The subframes of channels outside the mask are skipped over without running
+prediction, which makes decoding cheaper roughly in proportion to the number of
+channels dropped. This is useful for pulling one or two channels out of a 5.1
+or 7.1 stream.
+
+The read APIs still output every channel. The samples of channels outside the
+mask are meaningless and should be ignored. For stereo streams using
+left/side, right/side or mid/side coding a channel can depend on both
+subframes, in which case both are decoded anyway.
+
+This takes effect from the next FLAC frame that is decoded. Since skipped
+channels can't be hashed, MD5 verification will report `drflac_md5_incomplete`
+while any channel is being skipped.
+
+
+See Also
+--------
+drflac_read_next_flac_frame()
+*/
+DRFLAC_API bool drflac_set_channel_mask(drflac* pFlac, uint32_t channelMask);
+
+/*
+Seeks to the PCM frame at the given index.
+
+
+Parameters
+----------
+pFlac (in)
+    The decoder.
+
+pcmFrameIndex (in)
     The index of the PCM frame to seek to. See notes below.
 
 
@@ -995,6 +1750,114 @@ Return Value
 */
 DRFLAC_API bool drflac_seek_to_pcm_frame(drflac* pFlac, uint64_t pcmFrameIndex);
 
+/*
+Scans the stream and builds an index of the position of every FLAC frame so
+that subsequent seeks are exact.
+
+
+Parameters
+----------
+pFlac (in)
+    The decoder.
+
+
+Return Value
+------------
+`DRFLAC_TRUE` if successful; `DRFLAC_FALSE` otherwise.
+
+
+Remarks
+-------
+Without a SEEKTABLE, drflac_seek_to_pcm_frame() needs to search the stream on
+every call. Once an index has been built, seeking is a binary search of the
+index followed by decoding a single FLAC frame. This is intended for things like
+scrubbing where many random seeks are performed on the same stream.
+
+The scan parses each frame without decoding it, but still needs to read the
+entire stream. The decoder's read position is restored when this returns. The
+index is allocated with the decoder's allocation callbacks and is freed by
+drflac_close(). Save it with drflac_save_seek_index() to avoid rebuilding it
+next time the stream is opened.
+
+For Ogg streams the index maps PCM frames to the pages containing the start of
+a frame and only the page headers are looked at. A seek then reads a single
+page before decoding frames from there. Without an index, a seek bisects the
+link by granule position to get within a page or so of the sample, and pages
+are added as each seek scans over them, so seeking back to somewhere already
+scanned is just as quick. Building the index also finds every link of a chained stream,
+after which seeking into a later link goes straight to it.
+
+
+See Also
+--------
+drflac_save_seek_index()
+drflac_load_seek_index()
+drflac_seek_to_pcm_frame()
+*/
+DRFLAC_API bool drflac_build_seek_index(drflac* pFlac);
+
+/*
+Serializes the decoder's seek index.
+
+
+Parameters
+----------
+pFlac (in)
+    The decoder.
+
+pData (out, optional)
+    The buffer to write the serialized index to. Can be NULL, in which case the
+    required size is returned.
+
+dataSize (in)
+    The size in bytes of pData.
+
+
+Return Value
+------------
+The number of bytes written, or the required size if pData is NULL. Returns 0 if
+the decoder does not have an index or the buffer is too small.
+
+
+See Also
+--------
+drflac_build_seek_index()
+drflac_load_seek_index()
+*/
+DRFLAC_API size_t drflac_save_seek_index(drflac* pFlac, void* pData, size_t dataSize);
+
+/*
+Loads a seek index that was previously serialized with drflac_save_seek_index().
+
+
+Parameters
+----------
+pFlac (in)
+    The decoder.
+
+pData (in)
+    The serialized index.
+
+dataSize (in)
+    The size in bytes of pData.
+
+
+Return Value
+------------
+`DRFLAC_TRUE` if successful; `DRFLAC_FALSE` otherwise.
+
+
+Remarks
+-------
+This will fail if the index does not look like it belongs to this stream. The
+check is only based on the container, the position of the first frame and the
+total PCM frame count so it's not bulletproof. Any seek that lands on a frame that doesn't
+match the index will fall back to the normal seeking methods.
+
+The data is copied so pData does not need to remain valid.
+*/
+DRFLAC_API bool drflac_load_seek_index(drflac* pFlac, const void* pData, size_t dataSize);
+
 #ifndef DR_FLAC_NO_STDIO
 /*
 Opens a FLAC decoder from the file at the given path.
@@ -1081,6 +1944,131 @@ drflac_open_file_with_metadata(const char* pFileName, drflac_meta_proc onMeta, v
 DRFLAC_API drflac*
 drflac_open_file_with_metadata_w(const wchar_t* pFileName, drflac_meta_proc onMeta, void* pUserData,
                                  const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/*
+Opens a FLAC decoder from the file at the given path, reading it in chunks of
+the given size.
+
+
+Remarks
+-------
+Look at the documentation for drflac_open_with_buffer_size() and
+drflac_open_file_with_metadata() for more information. onMeta can be NULL.
+
+
+See Also
+--------
+drflac_open_with_buffer_size()
+drflac_open_file_with_metadata()
+*/
+DRFLAC_API drflac*
+drflac_open_file_with_buffer_size(const char* pFileName, drflac_meta_proc onMeta, void* pUserData,
+                                  size_t bufferSizeInBytes,
+                                  const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/*
+Reuses the given decoder for the file at the given path.
+
+
+Remarks
+-------
+Look at the documentation for drflac_reopen() for details on how the decoder
+is reused. pFlac can be NULL and onMeta can be NULL.
+
+
+See Also
+--------
+drflac_reopen()
+drflac_open_file_with_metadata()
+*/
+DRFLAC_API drflac* drflac_reopen_file(drflac* pFlac, const char* pFileName, drflac_meta_proc onMeta,
+                                      void* pUserData);
+
+/*
+Reads the metadata of the file at the given path without opening a decoder.
+
+
+Remarks
+-------
+Look at the documentation for drflac_probe() for more information. pUserData
+is passed to onMeta.
+
+
+See Also
+--------
+drflac_probe()
+*/
+DRFLAC_API bool drflac_probe_file(const char* pFileName, drflac_meta_proc onMeta, void* pUserData,
+                                  drflac_streaminfo* pStreamInfo,
+                                  const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/*
+Opens a FLAC decoder from the file at the given path by mapping it into memory.
+
+
+Parameters
+----------
+pFileName (in)
+    The path of the file to open, either absolute or relative to the current
+directory.
+
+pAllocationCallbacks (in, optional)
+    A pointer to application defined callbacks for managing memory allocations.
+
+
+Return Value
+------------
+A pointer to an object representing the decoder.
+
+
+Remarks
+-------
+Close the decoder with drflac_close(), which will also unmap the file.
+
+The bit streamer reads directly from the mapping in the same way as
+drflac_open_memory(), so no data is copied into the decoder's internal buffer
+and no read calls are made to the operating system once the pages are resident.
+This is useful when many decoders are streaming from files that are already in
+the page cache.
+
+The file handle itself is closed as soon as the mapping has been established.
+The file should not be truncated while the decoder is open.
+
+On platforms without support for memory mapped files, or when DR_FLAC_NO_MMAP
+is defined, this is equivalent to drflac_open_file().
+
+
+See Also
+--------
+drflac_open_file_mmap_with_metadata()
+drflac_open_file()
+drflac_open_memory()
+drflac_close()
+*/
+DRFLAC_API drflac* drflac_open_file_mmap(const char* pFileName,
+                                         const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/*
+Opens a FLAC decoder by mapping the file at the given path into memory and
+notifies the caller of the metadata chunks (album art, etc.)
+
+
+Remarks
+-------
+Look at the documentation for drflac_open_file_mmap() and
+drflac_open_with_metadata() for more information.
+
+
+See Also
+--------
+drflac_open_file_mmap()
+drflac_open_with_metadata()
+drflac_close()
+*/
+DRFLAC_API drflac*
+drflac_open_file_mmap_with_metadata(const char* pFileName, drflac_meta_proc onMeta,
+                                    void* pUserData,
+                                    const drlibs_allocation_callbacks* pAllocationCallbacks);
 #endif
 
 /*
@@ -1158,6 +2146,45 @@ drflac_open_memory_with_metadata(const void* pData, size_t dataSize, drflac_meta
                                  void* pUserData,
                                  const drlibs_allocation_callbacks* pAllocationCallbacks);
 
+/*
+Reuses the given decoder for a pre-allocated block of memory.
+
+
+Remarks
+-------
+Look at the documentation for drflac_reopen() for details on how the decoder
+is reused. pFlac can be NULL and onMeta can be NULL.
+
+A decoder opened with drflac_open_file_mmap() can be passed in here, in which
+case its file mapping is released.
+
+
+See Also
+--------
+drflac_reopen()
+drflac_open_memory_with_metadata()
+*/
+DRFLAC_API drflac* drflac_reopen_memory(drflac* pFlac, const void* pData, size_t dataSize,
+                                        drflac_meta_proc onMeta, void* pUserData);
+
+/*
+Reads the metadata of a FLAC stream held in memory without opening a decoder.
+
+
+Remarks
+-------
+Look at the documentation for drflac_probe() for more information. pUserData
+is passed to onMeta.
+
+
+See Also
+--------
+drflac_probe()
+*/
+DRFLAC_API bool drflac_probe_memory(const void* pData, size_t dataSize, drflac_meta_proc onMeta,
+                                    void* pUserData, drflac_streaminfo* pStreamInfo,
+                                    const drlibs_allocation_callbacks* pAllocationCallbacks);
+
 /* High Level APIs */
 
 /*
@@ -1236,6 +2263,219 @@ DRFLAC_API float* drflac_open_memory_and_read_pcm_frames_f32(
     const void* data, size_t dataSize, unsigned int* channels, unsigned int* sampleRate,
     uint64_t* totalPCMFrameCount, const drlibs_allocation_callbacks* pAllocationCallbacks);
 
+/* Callback for a single job of a parallel decode. */
+typedef void (*drflac_job_proc)(void* pJobUserData, uint32_t jobIndex);
+
+/*
+Callback for running the jobs of a parallel decode.
+
+Parameters
+----------
+pUserData (in)
+    The user data that was passed to drflac_decode_parallel_*().
+
+onJob (in)
+    The function to call for each job.
+
+pJobUserData (in)
+    The value to pass as the first parameter of onJob.
+
+jobCount (in)
+    The number of jobs. onJob() must be called exactly once for each index in
+    the range [0, jobCount).
+
+Remarks
+-------
+This function must not return until every job has completed. The jobs are
+independent of each other and can be run in any order on any thread.
+*/
+typedef void (*drflac_run_jobs_proc)(void* pUserData, drflac_job_proc onJob, void* pJobUserData,
+                                     uint32_t jobCount);
+
+/*
+Fully decodes a FLAC stream from a block of memory by splitting it into
+multiple jobs that can be run in parallel.
+
+Parameters
+----------
+pData (in)
+    A pointer to the raw encoded FLAC data.
+
+dataSize (in)
+    The size in bytes of `pData`.
+
+jobCount (in)
+    The number of slices to split the stream into. This would normally be the
+    number of threads available.
+
+onRunJobs (in, optional)
+    The function to call to run the jobs. When NULL the jobs are run one after
+    the other on the calling thread.
+
+pUserData (in, optional)
+    A pointer to application defined data that will be passed to onRunJobs.
+
+pAllocationCallbacks (in, optional)
+    A pointer to application defined callbacks for managing memory allocations.
+    These will be called from inside the jobs and must be thread-safe.
+
+Return Value
+------------
+A pointer to the sample data as interleaved signed 32-bit PCM, or NULL if an
+error occurred. The returned data must be freed with drflac_free().
+
+Remarks
+-------
+Each job opens its own decoder on `pData`, seeks to the start of its slice and
+decodes directly into the output buffer. Seeking is fastest when the stream
+has a SEEKTABLE, but falls back to a binary search otherwise.
+
+If the total PCM frame count is not stored in the stream the whole stream is
+decoded on the calling thread as if by drflac_open_memory_and_read_pcm_frames_s32().
+
+If the stream holds fewer PCM frames than the total in STREAMINFO, the frames
+that were decoded are returned and `totalPCMFrameCount` is set to their count,
+the same as drflac_open_memory_and_read_pcm_frames_s32().
+
+See Also
+--------
+drflac_open_memory_and_read_pcm_frames_s32()
+drflac_free()
+*/
+DRFLAC_API int32_t* drflac_decode_parallel_s32(
+    const void* pData, size_t dataSize, uint32_t jobCount, drflac_run_jobs_proc onRunJobs,
+    void* pUserData, unsigned int* channels, unsigned int* sampleRate,
+    uint64_t* totalPCMFrameCount, const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/* Same as drflac_decode_parallel_s32(), except returns signed 16-bit integer
+ * samples. */
+DRFLAC_API int16_t* drflac_decode_parallel_s16(
+    const void* pData, size_t dataSize, uint32_t jobCount, drflac_run_jobs_proc onRunJobs,
+    void* pUserData, unsigned int* channels, unsigned int* sampleRate,
+    uint64_t* totalPCMFrameCount, const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/* Same as drflac_decode_parallel_s32(), except returns 32-bit floating-point
+ * samples. */
+DRFLAC_API float* drflac_decode_parallel_f32(
+    const void* pData, size_t dataSize, uint32_t jobCount, drflac_run_jobs_proc onRunJobs,
+    void* pUserData, unsigned int* channels, unsigned int* sampleRate,
+    uint64_t* totalPCMFrameCount, const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/* A FLAC stream held in memory, for use with drflac_decode_batch_*(). */
+typedef struct {
+  /* A pointer to the raw encoded FLAC data. */
+  const void* pData;
+
+  /* The size in bytes of pData. */
+  size_t dataSize;
+} drflac_batch_input;
+
+/* Where a stream ended up in the arena of drflac_decode_batch_*(). */
+typedef struct {
+  /* The index of the stream's first sample in the arena. */
+  uint64_t offset;
+
+  /*
+  The number of PCM frames set aside for the stream, which is the total from
+  its STREAMINFO block. After decoding, this is the number of PCM frames that
+  were actually decoded.
+  */
+  uint64_t pcmFrameCount;
+
+  /* The format of the stream. Both are 0 if the stream couldn't be opened. */
+  uint32_t sampleRate;
+  uint32_t channels;
+} drflac_batch_output;
+
+/*
+Decodes many small FLAC streams held in memory into a single block of memory.
+
+
+Parameters
+----------
+pInputs (in)
+    The streams to decode.
+
+inputCount (in)
+    The number of items in `pInputs`.
+
+pArena (out, optional)
+    The buffer that will receive the decoded samples of every stream as
+    interleaved signed 32-bit PCM. When NULL, only `pOutputs` is filled in.
+
+arenaSizeInSamples (in)
+    The size of `pArena` in samples (not bytes or PCM frames).
+
+pOutputs (out)
+    Receives the position and format of each stream in the arena. Must have
+    room for `inputCount` items.
+
+jobCount (in)
+    The number of jobs to split the streams between. This would normally be the
+    number of threads available.
+
+onRunJobs (in, optional)
+    The function to call to run the jobs. When NULL the jobs are run one after
+    the other on the calling thread.
+
+pUserData (in, optional)
+    A pointer to application defined data that will be passed to onRunJobs.
+
+pAllocationCallbacks (in, optional)
+    A pointer to application defined callbacks for managing memory allocations.
+    These will be called from inside the jobs and must be thread-safe.
+
+
+Return Value
+------------
+The size of the arena in samples. 0 if `pArena` is too small, in which case
+nothing is decoded.
+
+
+Remarks
+-------
+Call this with `pArena` set to NULL to find out how big the arena needs to be,
+then again with the arena. The streams are laid out one after the other in the
+order they were given, each taking the number of PCM frames in its STREAMINFO
+block. Only the STREAMINFO block is read to do this. A stream that doesn't
+store its length, or that can't be opened, takes no space and isn't decoded.
+
+Each job decodes a run of consecutive streams holding roughly the same number
+of samples as the others. A job opens a single decoder and reuses it for each
+of its streams with drflac_reopen_memory(), so there's very little set up per
+stream. If a stream ends early or has an error, the rest of its space in the
+arena is filled with silence and `pcmFrameCount` is the number of PCM frames
+that were decoded.
+
+
+See Also
+--------
+drflac_open_memory_and_read_pcm_frames_s32()
+drflac_decode_parallel_s32()
+drflac_reopen_memory()
+*/
+DRFLAC_API uint64_t drflac_decode_batch_s32(
+    const drflac_batch_input* pInputs, uint32_t inputCount, int32_t* pArena,
+    uint64_t arenaSizeInSamples, drflac_batch_output* pOutputs, uint32_t jobCount,
+    drflac_run_jobs_proc onRunJobs, void* pUserData,
+    const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/* Same as drflac_decode_batch_s32(), except decodes to signed 16-bit integer
+ * samples. */
+DRFLAC_API uint64_t drflac_decode_batch_s16(
+    const drflac_batch_input* pInputs, uint32_t inputCount, int16_t* pArena,
+    uint64_t arenaSizeInSamples, drflac_batch_output* pOutputs, uint32_t jobCount,
+    drflac_run_jobs_proc onRunJobs, void* pUserData,
+    const drlibs_allocation_callbacks* pAllocationCallbacks);
+
+/* Same as drflac_decode_batch_s32(), except decodes to 32-bit floating-point
+ * samples. */
+DRFLAC_API uint64_t drflac_decode_batch_f32(
+    const drflac_batch_input* pInputs, uint32_t inputCount, float* pArena,
+    uint64_t arenaSizeInSamples, drflac_batch_output* pOutputs, uint32_t jobCount,
+    drflac_run_jobs_proc onRunJobs, void* pUserData,
+    const drlibs_allocation_callbacks* pAllocationCallbacks);
+
 /*
 Frees memory that was allocated internally by dr_flac.
 
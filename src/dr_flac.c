@@ -16,6 +16,26 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Memory mapping for drflac_open_file_mmap(). */
+#if !defined(DR_FLAC_NO_STDIO) && !defined(DR_FLAC_NO_MMAP)
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#define DRFLAC_HAS_MMAP
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DRFLAC_HAS_MMAP
+#endif
+#endif
+
 #ifdef _MSC_VER
 #define DRFLAC_INLINE __forceinline
 #elif defined(__GNUC__)
@@ -70,6 +90,12 @@ disable SSE on GCC 4.2 and below.
 #if _MSC_VER >= 1600 && !defined(DRFLAC_NO_SSE41) /* 2010 */
 #define DRFLAC_SUPPORT_SSE41
 #endif
+#if _MSC_VER >= 1700 && !defined(DRFLAC_NO_AVX2) /* 2012 */
+#define DRFLAC_SUPPORT_AVX2
+#endif
+#if _MSC_VER >= 1500 && !defined(DRFLAC_NO_PCLMUL) /* 2008 */
+#define DRFLAC_SUPPORT_PCLMUL
+#endif
 #elif defined(__clang__) ||                                                                        \
     (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 3)))
 /* Assume GNUC-style. */
@@ -79,6 +105,12 @@ disable SSE on GCC 4.2 and below.
 #if defined(__SSE4_1__) && !defined(DRFLAC_NO_SSE41)
 #define DRFLAC_SUPPORT_SSE41
 #endif
+#if defined(__AVX2__) && !defined(DRFLAC_NO_AVX2)
+#define DRFLAC_SUPPORT_AVX2
+#endif
+#if defined(__PCLMUL__) && !defined(DRFLAC_NO_PCLMUL)
+#define DRFLAC_SUPPORT_PCLMUL
+#endif
 #endif
 
 /* If at this point we still haven't determined compiler support for the
@@ -92,11 +124,27 @@ disable SSE on GCC 4.2 and below.
 #endif
 #endif
 
-#if defined(DRFLAC_SUPPORT_SSE41)
+/* AVX2 is only ever selected ahead of SSE4.1 so it requires it. */
+#if defined(DRFLAC_SUPPORT_AVX2) && !defined(DRFLAC_SUPPORT_SSE41)
+#undef DRFLAC_SUPPORT_AVX2
+#endif
+
+/* The PCLMUL CRC works on a whole 64-bit cache line at a time. */
+#if defined(DRFLAC_SUPPORT_PCLMUL) &&                                                              \
+    (!defined(DRFLAC_SUPPORT_SSE2) || !defined(DRFLAC_X64) || !defined(DRFLAC_64BIT))
+#undef DRFLAC_SUPPORT_PCLMUL
+#endif
+
+#if defined(DRFLAC_SUPPORT_AVX2)
+#include <immintrin.h>
+#elif defined(DRFLAC_SUPPORT_SSE41)
 #include <smmintrin.h>
 #elif defined(DRFLAC_SUPPORT_SSE2)
 #include <emmintrin.h>
 #endif
+#if defined(DRFLAC_SUPPORT_PCLMUL)
+#include <wmmintrin.h>
+#endif
 #endif
 
 #if defined(DRFLAC_ARM)
@@ -211,6 +259,57 @@ static DRFLAC_INLINE bool drflac_has_sse41(void) {
 #endif
 }
 
+static DRFLAC_INLINE bool drflac_has_avx2(void) {
+#if defined(DRFLAC_SUPPORT_AVX2)
+#if (defined(DRFLAC_X64) || defined(DRFLAC_X86)) && !defined(DRFLAC_NO_AVX2)
+#if defined(__AVX2__)
+  return DRFLAC_TRUE; /* If the compiler is allowed to freely generate AVX2
+                         code we can assume support. */
+#else
+#if defined(DRFLAC_NO_CPUID) || !defined(_MSC_VER)
+  return DRFLAC_FALSE;
+#else
+  /*
+  AVX2 needs both the CPU flag (leaf 7, EBX bit 5) and the OS to be saving the
+  YMM registers on context switches which we check with XGETBV.
+  */
+  int info[4];
+  drflac__cpuid(info, 1);
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+    return DRFLAC_FALSE; /* No OSXSAVE or no AVX. */
+  }
+  if ((_xgetbv(0) & 0x06) != 0x06) { return DRFLAC_FALSE; }
+
+  drflac__cpuid(info, 7);
+  return (info[1] & (1 << 5)) != 0;
+#endif
+#endif
+#else
+  return DRFLAC_FALSE; /* AVX2 is only supported on x86 and x64 architectures.
+                        */
+#endif
+#else
+  return DRFLAC_FALSE; /* No compiler support. */
+#endif
+}
+
+static DRFLAC_INLINE bool drflac_has_pclmul(void) {
+#if defined(DRFLAC_SUPPORT_PCLMUL)
+#if defined(__PCLMUL__)
+  return DRFLAC_TRUE; /* If the compiler is allowed to freely generate PCLMUL
+                         code we can assume support. */
+#elif defined(DRFLAC_NO_CPUID)
+  return DRFLAC_FALSE;
+#else
+  int info[4];
+  drflac__cpuid(info, 1);
+  return (info[2] & (1 << 1)) != 0;
+#endif
+#else
+  return DRFLAC_FALSE; /* No compiler support. */
+#endif
+}
+
 #if defined(_MSC_VER) && _MSC_VER >= 1500 && (defined(DRFLAC_X86) || defined(DRFLAC_X64)) &&       \
     !defined(__clang__)
 #define DRFLAC_HAS_LZCNT_INTRINSIC
@@ -279,6 +378,9 @@ extern __inline uint64_t _watcom_bswap64(uint64_t);
 #ifndef DRFLAC_COPY_MEMORY
 #define DRFLAC_COPY_MEMORY(dst, src, sz) memcpy((dst), (src), (sz))
 #endif
+#ifndef DRFLAC_MOVE_MEMORY
+#define DRFLAC_MOVE_MEMORY(dst, src, sz) memmove((dst), (src), (sz))
+#endif
 #ifndef DRFLAC_ZERO_MEMORY
 #define DRFLAC_ZERO_MEMORY(p, sz) memset((p), 0, (sz))
 #endif
@@ -286,6 +388,16 @@ extern __inline uint64_t _watcom_bswap64(uint64_t);
 #define DRFLAC_ZERO_OBJECT(p) DRFLAC_ZERO_MEMORY((p), sizeof(*(p)))
 #endif
 
+#if defined(SIZE_MAX)
+#define DRFLAC_SIZE_MAX SIZE_MAX
+#else
+#if defined(DRFLAC_64BIT)
+#define DRFLAC_SIZE_MAX ((uint64_t)0xFFFFFFFFFFFFFFFF)
+#else
+#define DRFLAC_SIZE_MAX 0xFFFFFFFF
+#endif
+#endif
+
 #define DRFLAC_MAX_SIMD_VECTOR_SIZE 64 /* 64 for AVX-512 in the future. */
 
 typedef int32_t drflac_result;
@@ -387,9 +499,14 @@ DRFLAC_API const char* drflac_version_string(void) { return DRFLAC_VERSION_STRIN
 static bool drflac__gIsLZCNTSupported = DRFLAC_FALSE;
 #endif
 
+#if defined(DRFLAC_SUPPORT_PCLMUL)
+static bool drflac__gIsPCLMULSupported = DRFLAC_FALSE;
+#endif
+
 #ifndef DRFLAC_NO_CPUID
 static bool drflac__gIsSSE2Supported = DRFLAC_FALSE;
 static bool drflac__gIsSSE41Supported = DRFLAC_FALSE;
+static bool drflac__gIsAVX2Supported = DRFLAC_FALSE;
 
 /*
 I've had a bug report that Clang's ThreadSanitizer presents a warning in this
@@ -416,6 +533,14 @@ DRFLAC_NO_THREAD_SANITIZE static void drflac__init_cpu_caps(void) {
     /* SSE4.1 */
     drflac__gIsSSE41Supported = drflac_has_sse41();
 
+    /* AVX2 */
+    drflac__gIsAVX2Supported = drflac_has_avx2();
+
+    /* PCLMUL */
+#if defined(DRFLAC_SUPPORT_PCLMUL)
+    drflac__gIsPCLMULSupported = drflac_has_pclmul();
+#endif
+
     /* Initialized. */
     isCPUCapsInitialized = DRFLAC_TRUE;
   }
@@ -617,6 +742,167 @@ static uint16_t drflac__crc16_table[] = {
     0x0220, 0x8225, 0x822F, 0x022A, 0x823B, 0x023E, 0x0234, 0x8231, 0x8213, 0x0216, 0x021C, 0x8219,
     0x0208, 0x820D, 0x8207, 0x0202};
 
+/*
+Slicing tables for the CRC-16. Entry [n-1] is the CRC of a byte followed by n zero bytes, which
+lets a whole cache line be processed with one lookup per byte and no serial dependency between
+them.
+*/
+static uint16_t drflac__crc16_slice_tables[7][256] = {
+    {0x0000, 0x8603, 0x8C03, 0x0A00, 0x9803, 0x1E00, 0x1400, 0x9203, 0xB003, 0x3600, 0x3C00, 0xBA03,
+     0x2800, 0xAE03, 0xA403, 0x2200, 0xE003, 0x6600, 0x6C00, 0xEA03, 0x7800, 0xFE03, 0xF403, 0x7200,
+     0x5000, 0xD603, 0xDC03, 0x5A00, 0xC803, 0x4E00, 0x4400, 0xC203, 0x4003, 0xC600, 0xCC00, 0x4A03,
+     0xD800, 0x5E03, 0x5403, 0xD200, 0xF000, 0x7603, 0x7C03, 0xFA00, 0x6803, 0xEE00, 0xE400, 0x6203,
+     0xA000, 0x2603, 0x2C03, 0xAA00, 0x3803, 0xBE00, 0xB400, 0x3203, 0x1003, 0x9600, 0x9C00, 0x1A03,
+     0x8800, 0x0E03, 0x0403, 0x8200, 0x8006, 0x0605, 0x0C05, 0x8A06, 0x1805, 0x9E06, 0x9406, 0x1205,
+     0x3005, 0xB606, 0xBC06, 0x3A05, 0xA806, 0x2E05, 0x2405, 0xA206, 0x6005, 0xE606, 0xEC06, 0x6A05,
+     0xF806, 0x7E05, 0x7405, 0xF206, 0xD006, 0x5605, 0x5C05, 0xDA06, 0x4805, 0xCE06, 0xC406, 0x4205,
+     0xC005, 0x4606, 0x4C06, 0xCA05, 0x5806, 0xDE05, 0xD405, 0x5206, 0x7006, 0xF605, 0xFC05, 0x7A06,
+     0xE805, 0x6E06, 0x6406, 0xE205, 0x2006, 0xA605, 0xAC05, 0x2A06, 0xB805, 0x3E06, 0x3406, 0xB205,
+     0x9005, 0x1606, 0x1C06, 0x9A05, 0x0806, 0x8E05, 0x8405, 0x0206, 0x8009, 0x060A, 0x0C0A, 0x8A09,
+     0x180A, 0x9E09, 0x9409, 0x120A, 0x300A, 0xB609, 0xBC09, 0x3A0A, 0xA809, 0x2E0A, 0x240A, 0xA209,
+     0x600A, 0xE609, 0xEC09, 0x6A0A, 0xF809, 0x7E0A, 0x740A, 0xF209, 0xD009, 0x560A, 0x5C0A, 0xDA09,
+     0x480A, 0xCE09, 0xC409, 0x420A, 0xC00A, 0x4609, 0x4C09, 0xCA0A, 0x5809, 0xDE0A, 0xD40A, 0x5209,
+     0x7009, 0xF60A, 0xFC0A, 0x7A09, 0xE80A, 0x6E09, 0x6409, 0xE20A, 0x2009, 0xA60A, 0xAC0A, 0x2A09,
+     0xB80A, 0x3E09, 0x3409, 0xB20A, 0x900A, 0x1609, 0x1C09, 0x9A0A, 0x0809, 0x8E0A, 0x840A, 0x0209,
+     0x000F, 0x860C, 0x8C0C, 0x0A0F, 0x980C, 0x1E0F, 0x140F, 0x920C, 0xB00C, 0x360F, 0x3C0F, 0xBA0C,
+     0x280F, 0xAE0C, 0xA40C, 0x220F, 0xE00C, 0x660F, 0x6C0F, 0xEA0C, 0x780F, 0xFE0C, 0xF40C, 0x720F,
+     0x500F, 0xD60C, 0xDC0C, 0x5A0F, 0xC80C, 0x4E0F, 0x440F, 0xC20C, 0x400C, 0xC60F, 0xCC0F, 0x4A0C,
+     0xD80F, 0x5E0C, 0x540C, 0xD20F, 0xF00F, 0x760C, 0x7C0C, 0xFA0F, 0x680C, 0xEE0F, 0xE40F, 0x620C,
+     0xA00F, 0x260C, 0x2C0C, 0xAA0F, 0x380C, 0xBE0F, 0xB40F, 0x320C, 0x100C, 0x960F, 0x9C0F, 0x1A0C,
+     0x880F, 0x0E0C, 0x040C, 0x820F},
+    {0x0000, 0x8017, 0x802B, 0x003C, 0x8053, 0x0044, 0x0078, 0x806F, 0x80A3, 0x00B4, 0x0088, 0x809F,
+     0x00F0, 0x80E7, 0x80DB, 0x00CC, 0x8143, 0x0154, 0x0168, 0x817F, 0x0110, 0x8107, 0x813B, 0x012C,
+     0x01E0, 0x81F7, 0x81CB, 0x01DC, 0x81B3, 0x01A4, 0x0198, 0x818F, 0x8283, 0x0294, 0x02A8, 0x82BF,
+     0x02D0, 0x82C7, 0x82FB, 0x02EC, 0x0220, 0x8237, 0x820B, 0x021C, 0x8273, 0x0264, 0x0258, 0x824F,
+     0x03C0, 0x83D7, 0x83EB, 0x03FC, 0x8393, 0x0384, 0x03B8, 0x83AF, 0x8363, 0x0374, 0x0348, 0x835F,
+     0x0330, 0x8327, 0x831B, 0x030C, 0x8503, 0x0514, 0x0528, 0x853F, 0x0550, 0x8547, 0x857B, 0x056C,
+     0x05A0, 0x85B7, 0x858B, 0x059C, 0x85F3, 0x05E4, 0x05D8, 0x85CF, 0x0440, 0x8457, 0x846B, 0x047C,
+     0x8413, 0x0404, 0x0438, 0x842F, 0x84E3, 0x04F4, 0x04C8, 0x84DF, 0x04B0, 0x84A7, 0x849B, 0x048C,
+     0x0780, 0x8797, 0x87AB, 0x07BC, 0x87D3, 0x07C4, 0x07F8, 0x87EF, 0x8723, 0x0734, 0x0708, 0x871F,
+     0x0770, 0x8767, 0x875B, 0x074C, 0x86C3, 0x06D4, 0x06E8, 0x86FF, 0x0690, 0x8687, 0x86BB, 0x06AC,
+     0x0660, 0x8677, 0x864B, 0x065C, 0x8633, 0x0624, 0x0618, 0x860F, 0x8A03, 0x0A14, 0x0A28, 0x8A3F,
+     0x0A50, 0x8A47, 0x8A7B, 0x0A6C, 0x0AA0, 0x8AB7, 0x8A8B, 0x0A9C, 0x8AF3, 0x0AE4, 0x0AD8, 0x8ACF,
+     0x0B40, 0x8B57, 0x8B6B, 0x0B7C, 0x8B13, 0x0B04, 0x0B38, 0x8B2F, 0x8BE3, 0x0BF4, 0x0BC8, 0x8BDF,
+     0x0BB0, 0x8BA7, 0x8B9B, 0x0B8C, 0x0880, 0x8897, 0x88AB, 0x08BC, 0x88D3, 0x08C4, 0x08F8, 0x88EF,
+     0x8823, 0x0834, 0x0808, 0x881F, 0x0870, 0x8867, 0x885B, 0x084C, 0x89C3, 0x09D4, 0x09E8, 0x89FF,
+     0x0990, 0x8987, 0x89BB, 0x09AC, 0x0960, 0x8977, 0x894B, 0x095C, 0x8933, 0x0924, 0x0918, 0x890F,
+     0x0F00, 0x8F17, 0x8F2B, 0x0F3C, 0x8F53, 0x0F44, 0x0F78, 0x8F6F, 0x8FA3, 0x0FB4, 0x0F88, 0x8F9F,
+     0x0FF0, 0x8FE7, 0x8FDB, 0x0FCC, 0x8E43, 0x0E54, 0x0E68, 0x8E7F, 0x0E10, 0x8E07, 0x8E3B, 0x0E2C,
+     0x0EE0, 0x8EF7, 0x8ECB, 0x0EDC, 0x8EB3, 0x0EA4, 0x0E98, 0x8E8F, 0x8D83, 0x0D94, 0x0DA8, 0x8DBF,
+     0x0DD0, 0x8DC7, 0x8DFB, 0x0DEC, 0x0D20, 0x8D37, 0x8D0B, 0x0D1C, 0x8D73, 0x0D64, 0x0D58, 0x8D4F,
+     0x0CC0, 0x8CD7, 0x8CEB, 0x0CFC, 0x8C93, 0x0C84, 0x0CB8, 0x8CAF, 0x8C63, 0x0C74, 0x0C48, 0x8C5F,
+     0x0C30, 0x8C27, 0x8C1B, 0x0C0C},
+    {0x0000, 0x9403, 0xA803, 0x3C00, 0xD003, 0x4400, 0x7800, 0xEC03, 0x2003, 0xB400, 0x8800, 0x1C03,
+     0xF000, 0x6403, 0x5803, 0xCC00, 0x4006, 0xD405, 0xE805, 0x7C06, 0x9005, 0x0406, 0x3806, 0xAC05,
+     0x6005, 0xF406, 0xC806, 0x5C05, 0xB006, 0x2405, 0x1805, 0x8C06, 0x800C, 0x140F, 0x280F, 0xBC0C,
+     0x500F, 0xC40C, 0xF80C, 0x6C0F, 0xA00F, 0x340C, 0x080C, 0x9C0F, 0x700C, 0xE40F, 0xD80F, 0x4C0C,
+     0xC00A, 0x5409, 0x6809, 0xFC0A, 0x1009, 0x840A, 0xB80A, 0x2C09, 0xE009, 0x740A, 0x480A, 0xDC09,
+     0x300A, 0xA409, 0x9809, 0x0C0A, 0x801D, 0x141E, 0x281E, 0xBC1D, 0x501E, 0xC41D, 0xF81D, 0x6C1E,
+     0xA01E, 0x341D, 0x081D, 0x9C1E, 0x701D, 0xE41E, 0xD81E, 0x4C1D, 0xC01B, 0x5418, 0x6818, 0xFC1B,
+     0x1018, 0x841B, 0xB81B, 0x2C18, 0xE018, 0x741B, 0x481B, 0xDC18, 0x301B, 0xA418, 0x9818, 0x0C1B,
+     0x0011, 0x9412, 0xA812, 0x3C11, 0xD012, 0x4411, 0x7811, 0xEC12, 0x2012, 0xB411, 0x8811, 0x1C12,
+     0xF011, 0x6412, 0x5812, 0xCC11, 0x4017, 0xD414, 0xE814, 0x7C17, 0x9014, 0x0417, 0x3817, 0xAC14,
+     0x6014, 0xF417, 0xC817, 0x5C14, 0xB017, 0x2414, 0x1814, 0x8C17, 0x803F, 0x143C, 0x283C, 0xBC3F,
+     0x503C, 0xC43F, 0xF83F, 0x6C3C, 0xA03C, 0x343F, 0x083F, 0x9C3C, 0x703F, 0xE43C, 0xD83C, 0x4C3F,
+     0xC039, 0x543A, 0x683A, 0xFC39, 0x103A, 0x8439, 0xB839, 0x2C3A, 0xE03A, 0x7439, 0x4839, 0xDC3A,
+     0x3039, 0xA43A, 0x983A, 0x0C39, 0x0033, 0x9430, 0xA830, 0x3C33, 0xD030, 0x4433, 0x7833, 0xEC30,
+     0x2030, 0xB433, 0x8833, 0x1C30, 0xF033, 0x6430, 0x5830, 0xCC33, 0x4035, 0xD436, 0xE836, 0x7C35,
+     0x9036, 0x0435, 0x3835, 0xAC36, 0x6036, 0xF435, 0xC835, 0x5C36, 0xB035, 0x2436, 0x1836, 0x8C35,
+     0x0022, 0x9421, 0xA821, 0x3C22, 0xD021, 0x4422, 0x7822, 0xEC21, 0x2021, 0xB422, 0x8822, 0x1C21,
+     0xF022, 0x6421, 0x5821, 0xCC22, 0x4024, 0xD427, 0xE827, 0x7C24, 0x9027, 0x0424, 0x3824, 0xAC27,
+     0x6027, 0xF424, 0xC824, 0x5C27, 0xB024, 0x2427, 0x1827, 0x8C24, 0x802E, 0x142D, 0x282D, 0xBC2E,
+     0x502D, 0xC42E, 0xF82E, 0x6C2D, 0xA02D, 0x342E, 0x082E, 0x9C2D, 0x702E, 0xE42D, 0xD82D, 0x4C2E,
+     0xC028, 0x542B, 0x682B, 0xFC28, 0x102B, 0x8428, 0xB828, 0x2C2B, 0xE02B, 0x7428, 0x4828, 0xDC2B,
+     0x3028, 0xA42B, 0x982B, 0x0C28},
+    {0x0000, 0x807B, 0x80F3, 0x0088, 0x81E3, 0x0198, 0x0110, 0x816B, 0x83C3, 0x03B8, 0x0330, 0x834B,
+     0x0220, 0x825B, 0x82D3, 0x02A8, 0x8783, 0x07F8, 0x0770, 0x870B, 0x0660, 0x861B, 0x8693, 0x06E8,
+     0x0440, 0x843B, 0x84B3, 0x04C8, 0x85A3, 0x05D8, 0x0550, 0x852B, 0x8F03, 0x0F78, 0x0FF0, 0x8F8B,
+     0x0EE0, 0x8E9B, 0x8E13, 0x0E68, 0x0CC0, 0x8CBB, 0x8C33, 0x0C48, 0x8D23, 0x0D58, 0x0DD0, 0x8DAB,
+     0x0880, 0x88FB, 0x8873, 0x0808, 0x8963, 0x0918, 0x0990, 0x89EB, 0x8B43, 0x0B38, 0x0BB0, 0x8BCB,
+     0x0AA0, 0x8ADB, 0x8A53, 0x0A28, 0x9E03, 0x1E78, 0x1EF0, 0x9E8B, 0x1FE0, 0x9F9B, 0x9F13, 0x1F68,
+     0x1DC0, 0x9DBB, 0x9D33, 0x1D48, 0x9C23, 0x1C58, 0x1CD0, 0x9CAB, 0x1980, 0x99FB, 0x9973, 0x1908,
+     0x9863, 0x1818, 0x1890, 0x98EB, 0x9A43, 0x1A38, 0x1AB0, 0x9ACB, 0x1BA0, 0x9BDB, 0x9B53, 0x1B28,
+     0x1100, 0x917B, 0x91F3, 0x1188, 0x90E3, 0x1098, 0x1010, 0x906B, 0x92C3, 0x12B8, 0x1230, 0x924B,
+     0x1320, 0x935B, 0x93D3, 0x13A8, 0x9683, 0x16F8, 0x1670, 0x960B, 0x1760, 0x971B, 0x9793, 0x17E8,
+     0x1540, 0x953B, 0x95B3, 0x15C8, 0x94A3, 0x14D8, 0x1450, 0x942B, 0xBC03, 0x3C78, 0x3CF0, 0xBC8B,
+     0x3DE0, 0xBD9B, 0xBD13, 0x3D68, 0x3FC0, 0xBFBB, 0xBF33, 0x3F48, 0xBE23, 0x3E58, 0x3ED0, 0xBEAB,
+     0x3B80, 0xBBFB, 0xBB73, 0x3B08, 0xBA63, 0x3A18, 0x3A90, 0xBAEB, 0xB843, 0x3838, 0x38B0, 0xB8CB,
+     0x39A0, 0xB9DB, 0xB953, 0x3928, 0x3300, 0xB37B, 0xB3F3, 0x3388, 0xB2E3, 0x3298, 0x3210, 0xB26B,
+     0xB0C3, 0x30B8, 0x3030, 0xB04B, 0x3120, 0xB15B, 0xB1D3, 0x31A8, 0xB483, 0x34F8, 0x3470, 0xB40B,
+     0x3560, 0xB51B, 0xB593, 0x35E8, 0x3740, 0xB73B, 0xB7B3, 0x37C8, 0xB6A3, 0x36D8, 0x3650, 0xB62B,
+     0x2200, 0xA27B, 0xA2F3, 0x2288, 0xA3E3, 0x2398, 0x2310, 0xA36B, 0xA1C3, 0x21B8, 0x2130, 0xA14B,
+     0x2020, 0xA05B, 0xA0D3, 0x20A8, 0xA583, 0x25F8, 0x2570, 0xA50B, 0x2460, 0xA41B, 0xA493, 0x24E8,
+     0x2640, 0xA63B, 0xA6B3, 0x26C8, 0xA7A3, 0x27D8, 0x2750, 0xA72B, 0xAD03, 0x2D78, 0x2DF0, 0xAD8B,
+     0x2CE0, 0xAC9B, 0xAC13, 0x2C68, 0x2EC0, 0xAEBB, 0xAE33, 0x2E48, 0xAF23, 0x2F58, 0x2FD0, 0xAFAB,
+     0x2A80, 0xAAFB, 0xAA73, 0x2A08, 0xAB63, 0x2B18, 0x2B90, 0xABEB, 0xA943, 0x2938, 0x29B0, 0xA9CB,
+     0x28A0, 0xA8DB, 0xA853, 0x2828},
+    {0x0000, 0xF803, 0x7003, 0x8800, 0xE006, 0x1805, 0x9005, 0x6806, 0x4009, 0xB80A, 0x300A, 0xC809,
+     0xA00F, 0x580C, 0xD00C, 0x280F, 0x8012, 0x7811, 0xF011, 0x0812, 0x6014, 0x9817, 0x1017, 0xE814,
+     0xC01B, 0x3818, 0xB018, 0x481B, 0x201D, 0xD81E, 0x501E, 0xA81D, 0x8021, 0x7822, 0xF022, 0x0821,
+     0x6027, 0x9824, 0x1024, 0xE827, 0xC028, 0x382B, 0xB02B, 0x4828, 0x202E, 0xD82D, 0x502D, 0xA82E,
+     0x0033, 0xF830, 0x7030, 0x8833, 0xE035, 0x1836, 0x9036, 0x6835, 0x403A, 0xB839, 0x3039, 0xC83A,
+     0xA03C, 0x583F, 0xD03F, 0x283C, 0x8047, 0x7844, 0xF044, 0x0847, 0x6041, 0x9842, 0x1042, 0xE841,
+     0xC04E, 0x384D, 0xB04D, 0x484E, 0x2048, 0xD84B, 0x504B, 0xA848, 0x0055, 0xF856, 0x7056, 0x8855,
+     0xE053, 0x1850, 0x9050, 0x6853, 0x405C, 0xB85F, 0x305F, 0xC85C, 0xA05A, 0x5859, 0xD059, 0x285A,
+     0x0066, 0xF865, 0x7065, 0x8866, 0xE060, 0x1863, 0x9063, 0x6860, 0x406F, 0xB86C, 0x306C, 0xC86F,
+     0xA069, 0x586A, 0xD06A, 0x2869, 0x8074, 0x7877, 0xF077, 0x0874, 0x6072, 0x9871, 0x1071, 0xE872,
+     0xC07D, 0x387E, 0xB07E, 0x487D, 0x207B, 0xD878, 0x5078, 0xA87B, 0x808B, 0x7888, 0xF088, 0x088B,
+     0x608D, 0x988E, 0x108E, 0xE88D, 0xC082, 0x3881, 0xB081, 0x4882, 0x2084, 0xD887, 0x5087, 0xA884,
+     0x0099, 0xF89A, 0x709A, 0x8899, 0xE09F, 0x189C, 0x909C, 0x689F, 0x4090, 0xB893, 0x3093, 0xC890,
+     0xA096, 0x5895, 0xD095, 0x2896, 0x00AA, 0xF8A9, 0x70A9, 0x88AA, 0xE0AC, 0x18AF, 0x90AF, 0x68AC,
+     0x40A3, 0xB8A0, 0x30A0, 0xC8A3, 0xA0A5, 0x58A6, 0xD0A6, 0x28A5, 0x80B8, 0x78BB, 0xF0BB, 0x08B8,
+     0x60BE, 0x98BD, 0x10BD, 0xE8BE, 0xC0B1, 0x38B2, 0xB0B2, 0x48B1, 0x20B7, 0xD8B4, 0x50B4, 0xA8B7,
+     0x00CC, 0xF8CF, 0x70CF, 0x88CC, 0xE0CA, 0x18C9, 0x90C9, 0x68CA, 0x40C5, 0xB8C6, 0x30C6, 0xC8C5,
+     0xA0C3, 0x58C0, 0xD0C0, 0x28C3, 0x80DE, 0x78DD, 0xF0DD, 0x08DE, 0x60D8, 0x98DB, 0x10DB, 0xE8D8,
+     0xC0D7, 0x38D4, 0xB0D4, 0x48D7, 0x20D1, 0xD8D2, 0x50D2, 0xA8D1, 0x80ED, 0x78EE, 0xF0EE, 0x08ED,
+     0x60EB, 0x98E8, 0x10E8, 0xE8EB, 0xC0E4, 0x38E7, 0xB0E7, 0x48E4, 0x20E2, 0xD8E1, 0x50E1, 0xA8E2,
+     0x00FF, 0xF8FC, 0x70FC, 0x88FF, 0xE0F9, 0x18FA, 0x90FA, 0x68F9, 0x40F6, 0xB8F5, 0x30F5, 0xC8F6,
+     0xA0F0, 0x58F3, 0xD0F3, 0x28F0},
+    {0x0000, 0x8113, 0x8223, 0x0330, 0x8443, 0x0550, 0x0660, 0x8773, 0x8883, 0x0990, 0x0AA0, 0x8BB3,
+     0x0CC0, 0x8DD3, 0x8EE3, 0x0FF0, 0x9103, 0x1010, 0x1320, 0x9233, 0x1540, 0x9453, 0x9763, 0x1670,
+     0x1980, 0x9893, 0x9BA3, 0x1AB0, 0x9DC3, 0x1CD0, 0x1FE0, 0x9EF3, 0xA203, 0x2310, 0x2020, 0xA133,
+     0x2640, 0xA753, 0xA463, 0x2570, 0x2A80, 0xAB93, 0xA8A3, 0x29B0, 0xAEC3, 0x2FD0, 0x2CE0, 0xADF3,
+     0x3300, 0xB213, 0xB123, 0x3030, 0xB743, 0x3650, 0x3560, 0xB473, 0xBB83, 0x3A90, 0x39A0, 0xB8B3,
+     0x3FC0, 0xBED3, 0xBDE3, 0x3CF0, 0xC403, 0x4510, 0x4620, 0xC733, 0x4040, 0xC153, 0xC263, 0x4370,
+     0x4C80, 0xCD93, 0xCEA3, 0x4FB0, 0xC8C3, 0x49D0, 0x4AE0, 0xCBF3, 0x5500, 0xD413, 0xD723, 0x5630,
+     0xD143, 0x5050, 0x5360, 0xD273, 0xDD83, 0x5C90, 0x5FA0, 0xDEB3, 0x59C0, 0xD8D3, 0xDBE3, 0x5AF0,
+     0x6600, 0xE713, 0xE423, 0x6530, 0xE243, 0x6350, 0x6060, 0xE173, 0xEE83, 0x6F90, 0x6CA0, 0xEDB3,
+     0x6AC0, 0xEBD3, 0xE8E3, 0x69F0, 0xF703, 0x7610, 0x7520, 0xF433, 0x7340, 0xF253, 0xF163, 0x7070,
+     0x7F80, 0xFE93, 0xFDA3, 0x7CB0, 0xFBC3, 0x7AD0, 0x79E0, 0xF8F3, 0x0803, 0x8910, 0x8A20, 0x0B33,
+     0x8C40, 0x0D53, 0x0E63, 0x8F70, 0x8080, 0x0193, 0x02A3, 0x83B0, 0x04C3, 0x85D0, 0x86E0, 0x07F3,
+     0x9900, 0x1813, 0x1B23, 0x9A30, 0x1D43, 0x9C50, 0x9F60, 0x1E73, 0x1183, 0x9090, 0x93A0, 0x12B3,
+     0x95C0, 0x14D3, 0x17E3, 0x96F0, 0xAA00, 0x2B13, 0x2823, 0xA930, 0x2E43, 0xAF50, 0xAC60, 0x2D73,
+     0x2283, 0xA390, 0xA0A0, 0x21B3, 0xA6C0, 0x27D3, 0x24E3, 0xA5F0, 0x3B03, 0xBA10, 0xB920, 0x3833,
+     0xBF40, 0x3E53, 0x3D63, 0xBC70, 0xB380, 0x3293, 0x31A3, 0xB0B0, 0x37C3, 0xB6D0, 0xB5E0, 0x34F3,
+     0xCC00, 0x4D13, 0x4E23, 0xCF30, 0x4843, 0xC950, 0xCA60, 0x4B73, 0x4483, 0xC590, 0xC6A0, 0x47B3,
+     0xC0C0, 0x41D3, 0x42E3, 0xC3F0, 0x5D03, 0xDC10, 0xDF20, 0x5E33, 0xD940, 0x5853, 0x5B63, 0xDA70,
+     0xD580, 0x5493, 0x57A3, 0xD6B0, 0x51C3, 0xD0D0, 0xD3E0, 0x52F3, 0x6E03, 0xEF10, 0xEC20, 0x6D33,
+     0xEA40, 0x6B53, 0x6863, 0xE970, 0xE680, 0x6793, 0x64A3, 0xE5B0, 0x62C3, 0xE3D0, 0xE0E0, 0x61F3,
+     0xFF00, 0x7E13, 0x7D23, 0xFC30, 0x7B43, 0xFA50, 0xF960, 0x7873, 0x7783, 0xF690, 0xF5A0, 0x74B3,
+     0xF3C0, 0x72D3, 0x71E3, 0xF0F0},
+    {0x0000, 0x1006, 0x200C, 0x300A, 0x4018, 0x501E, 0x6014, 0x7012, 0x8030, 0x9036, 0xA03C, 0xB03A,
+     0xC028, 0xD02E, 0xE024, 0xF022, 0x8065, 0x9063, 0xA069, 0xB06F, 0xC07D, 0xD07B, 0xE071, 0xF077,
+     0x0055, 0x1053, 0x2059, 0x305F, 0x404D, 0x504B, 0x6041, 0x7047, 0x80CF, 0x90C9, 0xA0C3, 0xB0C5,
+     0xC0D7, 0xD0D1, 0xE0DB, 0xF0DD, 0x00FF, 0x10F9, 0x20F3, 0x30F5, 0x40E7, 0x50E1, 0x60EB, 0x70ED,
+     0x00AA, 0x10AC, 0x20A6, 0x30A0, 0x40B2, 0x50B4, 0x60BE, 0x70B8, 0x809A, 0x909C, 0xA096, 0xB090,
+     0xC082, 0xD084, 0xE08E, 0xF088, 0x819B, 0x919D, 0xA197, 0xB191, 0xC183, 0xD185, 0xE18F, 0xF189,
+     0x01AB, 0x11AD, 0x21A7, 0x31A1, 0x41B3, 0x51B5, 0x61BF, 0x71B9, 0x01FE, 0x11F8, 0x21F2, 0x31F4,
+     0x41E6, 0x51E0, 0x61EA, 0x71EC, 0x81CE, 0x91C8, 0xA1C2, 0xB1C4, 0xC1D6, 0xD1D0, 0xE1DA, 0xF1DC,
+     0x0154, 0x1152, 0x2158, 0x315E, 0x414C, 0x514A, 0x6140, 0x7146, 0x8164, 0x9162, 0xA168, 0xB16E,
+     0xC17C, 0xD17A, 0xE170, 0xF176, 0x8131, 0x9137, 0xA13D, 0xB13B, 0xC129, 0xD12F, 0xE125, 0xF123,
+     0x0101, 0x1107, 0x210D, 0x310B, 0x4119, 0x511F, 0x6115, 0x7113, 0x8333, 0x9335, 0xA33F, 0xB339,
+     0xC32B, 0xD32D, 0xE327, 0xF321, 0x0303, 0x1305, 0x230F, 0x3309, 0x431B, 0x531D, 0x6317, 0x7311,
+     0x0356, 0x1350, 0x235A, 0x335C, 0x434E, 0x5348, 0x6342, 0x7344, 0x8366, 0x9360, 0xA36A, 0xB36C,
+     0xC37E, 0xD378, 0xE372, 0xF374, 0x03FC, 0x13FA, 0x23F0, 0x33F6, 0x43E4, 0x53E2, 0x63E8, 0x73EE,
+     0x83CC, 0x93CA, 0xA3C0, 0xB3C6, 0xC3D4, 0xD3D2, 0xE3D8, 0xF3DE, 0x8399, 0x939F, 0xA395, 0xB393,
+     0xC381, 0xD387, 0xE38D, 0xF38B, 0x03A9, 0x13AF, 0x23A5, 0x33A3, 0x43B1, 0x53B7, 0x63BD, 0x73BB,
+     0x02A8, 0x12AE, 0x22A4, 0x32A2, 0x42B0, 0x52B6, 0x62BC, 0x72BA, 0x8298, 0x929E, 0xA294, 0xB292,
+     0xC280, 0xD286, 0xE28C, 0xF28A, 0x82CD, 0x92CB, 0xA2C1, 0xB2C7, 0xC2D5, 0xD2D3, 0xE2D9, 0xF2DF,
+     0x02FD, 0x12FB, 0x22F1, 0x32F7, 0x42E5, 0x52E3, 0x62E9, 0x72EF, 0x8267, 0x9261, 0xA26B, 0xB26D,
+     0xC27F, 0xD279, 0xE273, 0xF275, 0x0257, 0x1251, 0x225B, 0x325D, 0x424F, 0x5249, 0x6243, 0x7245,
+     0x0202, 0x1204, 0x220E, 0x3208, 0x421A, 0x521C, 0x6216, 0x7210, 0x8232, 0x9234, 0xA23E, 0xB238,
+     0xC22A, 0xD22C, 0xE226, 0xF220}};
+
 static DRFLAC_INLINE uint8_t drflac_crc8_byte(uint8_t crc, uint8_t data) {
   return drflac__crc8_table[crc ^ data];
 }
@@ -681,19 +967,57 @@ static DRFLAC_INLINE uint16_t drflac_crc16_byte(uint16_t crc, uint8_t data) {
   return (crc << 8) ^ drflac__crc16_table[(uint8_t)(crc >> 8) ^ data];
 }
 
-static DRFLAC_INLINE uint16_t drflac_crc16_cache(uint16_t crc, drflac_cache_t data) {
+static DRFLAC_INLINE uint16_t drflac_crc16_cache__scalar(uint16_t crc, drflac_cache_t data) {
+  /*
+  The CRC is linear so folding the current CRC into the first two bytes lets
+  each byte be looked up independently, rather than one after the other.
+  */
 #ifdef DRFLAC_64BIT
-  crc = drflac_crc16_byte(crc, (uint8_t)((data >> 56) & 0xFF));
-  crc = drflac_crc16_byte(crc, (uint8_t)((data >> 48) & 0xFF));
-  crc = drflac_crc16_byte(crc, (uint8_t)((data >> 40) & 0xFF));
-  crc = drflac_crc16_byte(crc, (uint8_t)((data >> 32) & 0xFF));
+  data ^= (drflac_cache_t)crc << 48;
+  return drflac__crc16_slice_tables[6][(data >> 56) & 0xFF] ^
+         drflac__crc16_slice_tables[5][(data >> 48) & 0xFF] ^
+         drflac__crc16_slice_tables[4][(data >> 40) & 0xFF] ^
+         drflac__crc16_slice_tables[3][(data >> 32) & 0xFF] ^
+         drflac__crc16_slice_tables[2][(data >> 24) & 0xFF] ^
+         drflac__crc16_slice_tables[1][(data >> 16) & 0xFF] ^
+         drflac__crc16_slice_tables[0][(data >> 8) & 0xFF] ^ drflac__crc16_table[data & 0xFF];
+#else
+  data ^= (drflac_cache_t)crc << 16;
+  return drflac__crc16_slice_tables[2][(data >> 24) & 0xFF] ^
+         drflac__crc16_slice_tables[1][(data >> 16) & 0xFF] ^
+         drflac__crc16_slice_tables[0][(data >> 8) & 0xFF] ^ drflac__crc16_table[data & 0xFF];
 #endif
-  crc = drflac_crc16_byte(crc, (uint8_t)((data >> 24) & 0xFF));
-  crc = drflac_crc16_byte(crc, (uint8_t)((data >> 16) & 0xFF));
-  crc = drflac_crc16_byte(crc, (uint8_t)((data >> 8) & 0xFF));
-  crc = drflac_crc16_byte(crc, (uint8_t)((data >> 0) & 0xFF));
+}
 
-  return crc;
+#if defined(DRFLAC_SUPPORT_PCLMUL)
+/*
+Barrett reduction of a whole 64-bit cache line with carry-less multiplies. With
+M being the line with the current CRC folded into the top 16 bits, the new CRC
+is (M * x^16) mod P. The quotient is M + hi64(M * mu) where mu is
+floor(x^80 / P) without its top bit, and the remainder is the low 16 bits of
+quotient * P.
+*/
+static DRFLAC_INLINE uint16_t drflac_crc16_cache__pclmul(uint16_t crc, uint64_t data) {
+  const __m128i constants = _mm_set_epi64x((long long)0x8005, (long long)0xFFFBFFE7FFAFFE1FULL);
+  __m128i m;
+  __m128i q;
+  __m128i r;
+
+  m = _mm_cvtsi64_si128((long long)(data ^ ((uint64_t)crc << 48)));
+  q = _mm_clmulepi64_si128(m, constants, 0x00);
+  q = _mm_xor_si128(_mm_srli_si128(q, 8), m);
+  r = _mm_clmulepi64_si128(q, constants, 0x10);
+
+  return (uint16_t)_mm_cvtsi128_si32(r);
+}
+#endif
+
+static DRFLAC_INLINE uint16_t drflac_crc16_cache(uint16_t crc, drflac_cache_t data) {
+#if defined(DRFLAC_SUPPORT_PCLMUL)
+  if (drflac__gIsPCLMULSupported) { return drflac_crc16_cache__pclmul(crc, data); }
+#endif
+
+  return drflac_crc16_cache__scalar(crc, data);
 }
 
 static DRFLAC_INLINE uint16_t drflac_crc16_bytes(uint16_t crc, drflac_cache_t data,
@@ -813,6 +1137,195 @@ static DRFLAC_INLINE uint16_t drflac_crc16(uint16_t crc, drflac_cache_t data, ui
 }
 #endif
 
+/*
+MD5, used for verifying the decoded audio against the MD5 in STREAMINFO. Each
+64-byte block depends on the state left by the previous one so there's nothing
+to gain from SIMD within a single stream. Instead the rounds are fully unrolled
+with constant shifts and whole blocks are hashed straight from the input where
+possible to avoid copying through the context.
+*/
+#define DRFLAC_MD5_F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define DRFLAC_MD5_G(x, y, z) ((y) ^ ((z) & ((x) ^ (y))))
+#define DRFLAC_MD5_H(x, y, z) ((x) ^ (y) ^ (z))
+#define DRFLAC_MD5_I(x, y, z) ((y) ^ ((x) | ~(z)))
+#define DRFLAC_MD5_STEP(f, a, b, c, d, x, t, s)                                                    \
+  (a) += f((b), (c), (d)) + (x) + (uint32_t)(t);                                                   \
+  (a) = (((a) << (s)) | ((a) >> (32 - (s)))) + (b)
+
+static DRFLAC_INLINE uint32_t drflac__md5_load_le32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void drflac__md5_blocks(uint32_t* pState, const uint8_t* pData, size_t blockCount) {
+  uint32_t a = pState[0];
+  uint32_t b = pState[1];
+  uint32_t c = pState[2];
+  uint32_t d = pState[3];
+
+  while (blockCount > 0) {
+    uint32_t x[16];
+    uint32_t aa = a;
+    uint32_t bb = b;
+    uint32_t cc = c;
+    uint32_t dd = d;
+    int i;
+
+    for (i = 0; i < 16; ++i) { x[i] = drflac__md5_load_le32(pData + i * 4); }
+
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, a, b, c, d, x[0], 0xd76aa478, 7);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, d, a, b, c, x[1], 0xe8c7b756, 12);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, c, d, a, b, x[2], 0x242070db, 17);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, b, c, d, a, x[3], 0xc1bdceee, 22);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, a, b, c, d, x[4], 0xf57c0faf, 7);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, d, a, b, c, x[5], 0x4787c62a, 12);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, c, d, a, b, x[6], 0xa8304613, 17);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, b, c, d, a, x[7], 0xfd469501, 22);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, a, b, c, d, x[8], 0x698098d8, 7);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, d, a, b, c, x[9], 0x8b44f7af, 12);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, c, d, a, b, x[10], 0xffff5bb1, 17);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, b, c, d, a, x[11], 0x895cd7be, 22);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, a, b, c, d, x[12], 0x6b901122, 7);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, d, a, b, c, x[13], 0xfd987193, 12);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, c, d, a, b, x[14], 0xa679438e, 17);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_F, b, c, d, a, x[15], 0x49b40821, 22);
+
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, a, b, c, d, x[1], 0xf61e2562, 5);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, d, a, b, c, x[6], 0xc040b340, 9);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, c, d, a, b, x[11], 0x265e5a51, 14);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, b, c, d, a, x[0], 0xe9b6c7aa, 20);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, a, b, c, d, x[5], 0xd62f105d, 5);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, d, a, b, c, x[10], 0x02441453, 9);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, c, d, a, b, x[15], 0xd8a1e681, 14);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, b, c, d, a, x[4], 0xe7d3fbc8, 20);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, a, b, c, d, x[9], 0x21e1cde6, 5);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, d, a, b, c, x[14], 0xc33707d6, 9);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, c, d, a, b, x[3], 0xf4d50d87, 14);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, b, c, d, a, x[8], 0x455a14ed, 20);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, a, b, c, d, x[13], 0xa9e3e905, 5);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, d, a, b, c, x[2], 0xfcefa3f8, 9);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, c, d, a, b, x[7], 0x676f02d9, 14);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_G, b, c, d, a, x[12], 0x8d2a4c8a, 20);
+
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, a, b, c, d, x[5], 0xfffa3942, 4);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, d, a, b, c, x[8], 0x8771f681, 11);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, c, d, a, b, x[11], 0x6d9d6122, 16);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, b, c, d, a, x[14], 0xfde5380c, 23);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, a, b, c, d, x[1], 0xa4beea44, 4);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, d, a, b, c, x[4], 0x4bdecfa9, 11);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, c, d, a, b, x[7], 0xf6bb4b60, 16);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, b, c, d, a, x[10], 0xbebfbc70, 23);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, a, b, c, d, x[13], 0x289b7ec6, 4);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, d, a, b, c, x[0], 0xeaa127fa, 11);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, c, d, a, b, x[3], 0xd4ef3085, 16);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, b, c, d, a, x[6], 0x04881d05, 23);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, a, b, c, d, x[9], 0xd9d4d039, 4);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, d, a, b, c, x[12], 0xe6db99e5, 11);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, c, d, a, b, x[15], 0x1fa27cf8, 16);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_H, b, c, d, a, x[2], 0xc4ac5665, 23);
+
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, a, b, c, d, x[0], 0xf4292244, 6);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, d, a, b, c, x[7], 0x432aff97, 10);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, c, d, a, b, x[14], 0xab9423a7, 15);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, b, c, d, a, x[5], 0xfc93a039, 21);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, a, b, c, d, x[12], 0x655b59c3, 6);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, d, a, b, c, x[3], 0x8f0ccc92, 10);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, c, d, a, b, x[10], 0xffeff47d, 15);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, b, c, d, a, x[1], 0x85845dd1, 21);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, a, b, c, d, x[8], 0x6fa87e4f, 6);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, d, a, b, c, x[15], 0xfe2ce6e0, 10);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, c, d, a, b, x[6], 0xa3014314, 15);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, b, c, d, a, x[13], 0x4e0811a1, 21);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, a, b, c, d, x[4], 0xf7537e82, 6);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, d, a, b, c, x[11], 0xbd3af235, 10);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, c, d, a, b, x[2], 0x2ad7d2bb, 15);
+    DRFLAC_MD5_STEP(DRFLAC_MD5_I, b, c, d, a, x[9], 0xeb86d391, 21);
+
+    a += aa;
+    b += bb;
+    c += cc;
+    d += dd;
+
+    pData += 64;
+    blockCount -= 1;
+  }
+
+  pState[0] = a;
+  pState[1] = b;
+  pState[2] = c;
+  pState[3] = d;
+}
+
+static void drflac__md5_init(drflac__md5_context* pCtx) {
+  pCtx->state[0] = 0x67452301;
+  pCtx->state[1] = 0xefcdab89;
+  pCtx->state[2] = 0x98badcfe;
+  pCtx->state[3] = 0x10325476;
+  pCtx->byteCount = 0;
+}
+
+static void drflac__md5_update(drflac__md5_context* pCtx, const uint8_t* pData, size_t dataSize) {
+  size_t blockOffset = (size_t)(pCtx->byteCount & 63);
+
+  pCtx->byteCount += dataSize;
+
+  /* Top up a partial block left over from last time. */
+  if (blockOffset > 0) {
+    size_t bytesToCopy = 64 - blockOffset;
+    if (bytesToCopy > dataSize) { bytesToCopy = dataSize; }
+
+    DRFLAC_COPY_MEMORY(pCtx->block + blockOffset, pData, bytesToCopy);
+    pData += bytesToCopy;
+    dataSize -= bytesToCopy;
+
+    if (blockOffset + bytesToCopy < 64) { return; }
+
+    drflac__md5_blocks(pCtx->state, pCtx->block, 1);
+  }
+
+  /* Whole blocks are hashed directly from the input. */
+  if (dataSize >= 64) {
+    drflac__md5_blocks(pCtx->state, pData, dataSize / 64);
+    pData += dataSize & ~(size_t)63;
+    dataSize &= 63;
+  }
+
+  if (dataSize > 0) { DRFLAC_COPY_MEMORY(pCtx->block, pData, dataSize); }
+}
+
+static void drflac__md5_final(const drflac__md5_context* pCtx, uint8_t* pDigest) {
+  /* Work on a copy so the running hash can continue to be updated. */
+  drflac__md5_context ctx = *pCtx;
+  uint64_t bitCount = pCtx->byteCount * 8;
+  uint8_t padding[72];
+  size_t paddingSize;
+  int i;
+
+  paddingSize = 64 - (size_t)(pCtx->byteCount & 63);
+  if (paddingSize < 9) { paddingSize += 64; }
+
+  DRFLAC_ZERO_MEMORY(padding, sizeof(padding));
+  padding[0] = 0x80;
+  for (i = 0; i < 8; ++i) {
+    padding[paddingSize - 8 + i] = (uint8_t)(bitCount >> (i * 8));
+  }
+
+  drflac__md5_update(&ctx, padding, paddingSize);
+
+  for (i = 0; i < 16; ++i) { pDigest[i] = (uint8_t)(ctx.state[i / 4] >> ((i % 4) * 8)); }
+}
+
+static bool drflac__md5_matches(const drflac__md5_context* pCtx, const uint8_t* pExpected) {
+  uint8_t digest[16];
+  uint32_t i;
+
+  drflac__md5_final(pCtx, digest);
+  for (i = 0; i < sizeof(digest); ++i) {
+    if (digest[i] != pExpected[i]) { return DRFLAC_FALSE; }
+  }
+
+  return DRFLAC_TRUE;
+}
+
 #ifdef DRFLAC_64BIT
 #define drflac__be2host__cache_line drflac__be2host_64
 #else
@@ -842,8 +1355,20 @@ with each cache line being the same size as the L1. The L2 is a buffer of about
 #define DRFLAC_CACHE_L1_SELECT_AND_SHIFT_SAFE(bs, _bitCount)                                       \
   (DRFLAC_CACHE_L1_SELECT((bs), (_bitCount)) >>                                                    \
    (DRFLAC_CACHE_L1_SELECTION_SHIFT((bs), (_bitCount)) & (DRFLAC_CACHE_L1_SIZE_BITS(bs) - 1)))
-#define DRFLAC_CACHE_L2_SIZE_BYTES(bs) (sizeof((bs)->cacheL2))
-#define DRFLAC_CACHE_L2_LINE_COUNT(bs) (DRFLAC_CACHE_L2_SIZE_BYTES(bs) / sizeof((bs)->cacheL2[0]))
+/* The largest L2 cache that can be requested with drflac_open_with_buffer_size(). */
+#define DRFLAC_MAX_BUFFER_SIZE (1024 * 1024 * 1024)
+
+/* DR_FLAC_LAZY_PICTURE_SIZE as a threshold for drflac__read_and_decode_metadata(). */
+#if DR_FLAC_LAZY_PICTURE_SIZE > 0
+#define DRFLAC_LAZY_PICTURE_SIZE DR_FLAC_LAZY_PICTURE_SIZE
+#else
+#define DRFLAC_LAZY_PICTURE_SIZE 0xFFFFFFFF
+#endif
+
+/* The alignment drflac_open_preallocated() requires of the caller's memory. */
+#define DRFLAC_PREALLOCATED_ALIGNMENT 16
+#define DRFLAC_CACHE_L2_SIZE_BYTES(bs) ((size_t)(bs)->cacheL2LineCount * sizeof(drflac_cache_t))
+#define DRFLAC_CACHE_L2_LINE_COUNT(bs) ((bs)->cacheL2LineCount)
 #define DRFLAC_CACHE_L2_LINES_REMAINING(bs) (DRFLAC_CACHE_L2_LINE_COUNT(bs) - (bs)->nextL2Line)
 
 #ifndef DR_FLAC_NO_CRC
@@ -910,7 +1435,40 @@ static DRFLAC_INLINE bool drflac__reload_l1_cache_from_l2(drflac_bs* bs) {
                             more aligned bytes left in the client. */
   }
 
+  /*
+  Memory backed streams are loaded straight into the L1 cache. The L2 cache is
+  left empty so the inlined fast paths always fall through to here.
+  */
+  if (bs->pDirectStream != NULL) {
+    drflac__memory_stream* pStream = bs->pDirectStream;
+    size_t bytesRemaining;
+
+    DRFLAC_ASSERT(pStream->dataSize >= pStream->currentReadPos);
+    bytesRemaining = pStream->dataSize - pStream->currentReadPos;
+
+    if (bytesRemaining >= DRFLAC_CACHE_L1_SIZE_BYTES(bs)) {
+      DRFLAC_COPY_MEMORY(&bs->cache, pStream->data + pStream->currentReadPos,
+                         DRFLAC_CACHE_L1_SIZE_BYTES(bs));
+      pStream->currentReadPos += DRFLAC_CACHE_L1_SIZE_BYTES(bs);
+      bs->clientBytePos += DRFLAC_CACHE_L1_SIZE_BYTES(bs);
+      return DRFLAC_TRUE;
+    }
+
+    /* End of the stream. Stash the trailing bytes for the slow path. */
+    bs->unalignedByteCount = bytesRemaining;
+    if (bytesRemaining > 0) {
+      bs->unalignedCache = 0;
+      DRFLAC_COPY_MEMORY(&bs->unalignedCache, pStream->data + pStream->currentReadPos,
+                         bytesRemaining);
+      pStream->currentReadPos += bytesRemaining;
+      bs->clientBytePos += bytesRemaining;
+    }
+
+    return DRFLAC_FALSE;
+  }
+
   bytesRead = bs->onRead(bs->pUserData, bs->cacheL2, DRFLAC_CACHE_L2_SIZE_BYTES(bs));
+  bs->clientBytePos += bytesRead;
 
   bs->nextL2Line = 0;
   if (bytesRead == DRFLAC_CACHE_L2_SIZE_BYTES(bs)) {
@@ -1503,10 +2061,8 @@ static DRFLAC_INLINE bool drflac__seek_past_next_set_bit(drflac_bs* bs,
   return DRFLAC_TRUE;
 }
 
-static bool drflac__seek_to_byte(drflac_bs* bs, uint64_t offsetFromStart) {
-  DRFLAC_ASSERT(bs != NULL);
-  DRFLAC_ASSERT(offsetFromStart > 0);
-
+static bool drflac__seek_client_to_byte(drflac_seek_proc onSeek, void* pUserData,
+                                        uint64_t offsetFromStart) {
   /*
   Seeking from the start is not quite as trivial as it sounds because the onSeek
   callback takes a signed 32-bit integer (which is intentional because it
@@ -1517,33 +2073,57 @@ static bool drflac__seek_to_byte(drflac_bs* bs, uint64_t offsetFromStart) {
   */
   if (offsetFromStart > 0x7FFFFFFF) {
     uint64_t bytesRemaining = offsetFromStart;
-    if (!bs->onSeek(bs->pUserData, 0x7FFFFFFF, drflac_seek_origin_start)) { return DRFLAC_FALSE; }
+    if (!onSeek(pUserData, 0x7FFFFFFF, drflac_seek_origin_start)) { return DRFLAC_FALSE; }
     bytesRemaining -= 0x7FFFFFFF;
 
     while (bytesRemaining > 0x7FFFFFFF) {
-      if (!bs->onSeek(bs->pUserData, 0x7FFFFFFF, drflac_seek_origin_current)) {
-        return DRFLAC_FALSE;
-      }
+      if (!onSeek(pUserData, 0x7FFFFFFF, drflac_seek_origin_current)) { return DRFLAC_FALSE; }
       bytesRemaining -= 0x7FFFFFFF;
     }
 
     if (bytesRemaining > 0) {
-      if (!bs->onSeek(bs->pUserData, (int)bytesRemaining, drflac_seek_origin_current)) {
+      if (!onSeek(pUserData, (int)bytesRemaining, drflac_seek_origin_current)) {
         return DRFLAC_FALSE;
       }
     }
   } else {
-    if (!bs->onSeek(bs->pUserData, (int)offsetFromStart, drflac_seek_origin_start)) {
+    if (!onSeek(pUserData, (int)offsetFromStart, drflac_seek_origin_start)) {
       return DRFLAC_FALSE;
     }
   }
 
+  return DRFLAC_TRUE;
+}
+
+static bool drflac__seek_to_byte(drflac_bs* bs, uint64_t offsetFromStart) {
+  DRFLAC_ASSERT(bs != NULL);
+  DRFLAC_ASSERT(offsetFromStart > 0);
+
+  if (!drflac__seek_client_to_byte(bs->onSeek, bs->pUserData, offsetFromStart)) {
+    return DRFLAC_FALSE;
+  }
+
   /* The cache should be reset to force a reload of fresh data from the client.
    */
   drflac__reset_cache(bs);
+  bs->clientBytePos = offsetFromStart;
   return DRFLAC_TRUE;
 }
 
+/*
+Retrieves the byte position of the next unread byte in the stream. This is only
+accurate when the bit streamer is sitting on a byte boundary, such as between
+FLAC frames.
+*/
+static uint64_t drflac__get_byte_pos(drflac_bs* bs) {
+  uint64_t bytesInCache = (uint64_t)DRFLAC_CACHE_L2_LINES_REMAINING(bs) *
+                              DRFLAC_CACHE_L1_SIZE_BYTES(bs) +
+                          (DRFLAC_CACHE_L1_BITS_REMAINING(bs) >> 3) + bs->unalignedByteCount;
+
+  DRFLAC_ASSERT(bs->clientBytePos >= bytesInCache);
+  return bs->clientBytePos - bytesInCache;
+}
+
 static drflac_result drflac__read_utf8_coded_number(drflac_bs* bs, uint64_t* pNumberOut,
                                                     uint8_t* pCRCOut) {
   uint8_t crc;
@@ -2212,10 +2792,14 @@ static DRFLAC_INLINE bool drflac__seek_rice_parts(drflac_bs* bs, uint8_t ricePar
   return DRFLAC_TRUE;
 }
 
-static bool drflac__decode_samples_with_residual__rice__scalar_zeroorder(
-    drflac_bs* bs, uint32_t bitsPerSample, uint32_t count, uint8_t riceParam,
-    uint32_t order, int32_t shift, const int32_t* coefficients,
-    int32_t* pSamplesOut) {
+/*
+Reads and reconstructs <count> rice coded residuals into pResidualsOut. This is
+not marked DRFLAC_INLINE on purpose. The scalar kernels below read their
+residuals through this in small blocks and then predict each block in place, so
+the per-order copies of those kernels all share one copy of the bit reader.
+*/
+static bool drflac__read_rice_residuals(drflac_bs* bs, uint32_t count, uint8_t riceParam,
+                                        int32_t* pResidualsOut) {
   uint32_t t[2] = {0x00000000, 0xFFFFFFFF};
   uint32_t zeroCountPart0;
   uint32_t riceParamPart0;
@@ -2223,12 +2807,7 @@ static bool drflac__decode_samples_with_residual__rice__scalar_zeroorder(
   uint32_t i;
 
   DRFLAC_ASSERT(bs != NULL);
-  DRFLAC_ASSERT(pSamplesOut != NULL);
-
-  (void)bitsPerSample;
-  (void)order;
-  (void)shift;
-  (void)coefficients;
+  DRFLAC_ASSERT(pResidualsOut != NULL);
 
   riceParamMask = (uint32_t) ~((~0UL) << riceParam);
 
@@ -2244,7 +2823,7 @@ static bool drflac__decode_samples_with_residual__rice__scalar_zeroorder(
     riceParamPart0 |= (zeroCountPart0 << riceParam);
     riceParamPart0 = (riceParamPart0 >> 1) ^ t[riceParamPart0 & 0x01];
 
-    pSamplesOut[i] = riceParamPart0;
+    pResidualsOut[i] = riceParamPart0;
 
     i += 1;
   }
@@ -2252,141 +2831,152 @@ static bool drflac__decode_samples_with_residual__rice__scalar_zeroorder(
   return DRFLAC_TRUE;
 }
 
-static bool drflac__decode_samples_with_residual__rice__scalar(
-    drflac_bs* bs, uint32_t bitsPerSample, uint32_t count, uint8_t riceParam,
-    uint32_t order, int32_t shift, const int32_t* coefficients,
-    int32_t* pSamplesOut) {
-  uint32_t t[2] = {0x00000000, 0xFFFFFFFF};
-  uint32_t zeroCountPart0 = 0;
-  uint32_t zeroCountPart1 = 0;
-  uint32_t zeroCountPart2 = 0;
-  uint32_t zeroCountPart3 = 0;
-  uint32_t riceParamPart0 = 0;
-  uint32_t riceParamPart1 = 0;
-  uint32_t riceParamPart2 = 0;
-  uint32_t riceParamPart3 = 0;
-  uint32_t riceParamMask;
-  const int32_t* pSamplesOutEnd;
+/*
+The scalar kernels take the order as a parameter, but they're always inlined
+and DRFLAC_DEFINE_RICE_ORDERS() stamps out a copy of each one per order with
+the order as a compile time constant. That lets the compiler unroll the taps
+and removes the branches on the order from the per-sample loop. Orders 0 to 12
+cover the standard compression levels and 16 and 32 are what the high order
+presets use. Anything else shares a single copy that keeps the order as a
+variable.
+
+The copies are collected in a <kernel>__procs table indexed by the order. The
+kernel is looked up once per subframe with drflac__get_rice_proc() and then
+called for each of its rice partitions.
+*/
+typedef bool (*drflac__decode_rice_proc)(drflac_bs* bs, uint32_t count, uint8_t riceParam,
+                                         uint32_t order, int32_t shift,
+                                         const int32_t* coefficients, int32_t* pSamplesOut);
+
+#define DRFLAC_DEFINE_RICE_ORDER(kernel, n)                                                        \
+  static bool kernel##__order##n(drflac_bs* bs, uint32_t count, uint8_t riceParam,                 \
+                                 uint32_t order, int32_t shift, const int32_t* coefficients,       \
+                                 int32_t* pSamplesOut) {                                           \
+    DRFLAC_ASSERT(order == n);                                                                     \
+    (void)order;                                                                                   \
+    return kernel(bs, count, riceParam, n, shift, coefficients, pSamplesOut);                      \
+  }
+
+#define DRFLAC_DEFINE_RICE_ORDERS(kernel)                                                          \
+  static bool kernel##__any(drflac_bs* bs, uint32_t count, uint8_t riceParam, uint32_t order,      \
+                            int32_t shift, const int32_t* coefficients, int32_t* pSamplesOut) {    \
+    return kernel(bs, count, riceParam, order, shift, coefficients, pSamplesOut);                  \
+  }                                                                                                \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 0)                                                              \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 1)                                                              \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 2)                                                              \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 3)                                                              \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 4)                                                              \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 5)                                                              \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 6)                                                              \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 7)                                                              \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 8)                                                              \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 9)                                                              \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 10)                                                             \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 11)                                                             \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 12)                                                             \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 16)                                                             \
+  DRFLAC_DEFINE_RICE_ORDER(kernel, 32)                                                             \
+  static const drflac__decode_rice_proc kernel##__procs[33] = {                                    \
+      kernel##__order0,  kernel##__order1,  kernel##__order2,  kernel##__order3,                   \
+      kernel##__order4,  kernel##__order5,  kernel##__order6,  kernel##__order7,                   \
+      kernel##__order8,  kernel##__order9,  kernel##__order10, kernel##__order11,                  \
+      kernel##__order12, kernel##__any,     kernel##__any,     kernel##__any,                      \
+      kernel##__order16, kernel##__any,     kernel##__any,     kernel##__any,                      \
+      kernel##__any,     kernel##__any,     kernel##__any,     kernel##__any,                      \
+      kernel##__any,     kernel##__any,     kernel##__any,     kernel##__any,                      \
+      kernel##__any,     kernel##__any,     kernel##__any,     kernel##__any,                      \
+      kernel##__order32};
+
+/*
+Residuals are read in blocks of 4 and predicted straight away so the prediction
+can overlap with the bit reading of the next block.
+*/
+static DRFLAC_INLINE bool drflac__decode_samples_with_residual__rice__scalar_32(
+    drflac_bs* bs, uint32_t count, uint8_t riceParam, uint32_t order, int32_t shift,
+    const int32_t* coefficients, int32_t* pSamplesOut) {
+  const int32_t* pSamplesOutEnd = pSamplesOut + (count & ~3);
   uint32_t i;
 
   DRFLAC_ASSERT(bs != NULL);
   DRFLAC_ASSERT(pSamplesOut != NULL);
 
-  if (order == 0) {
-    return drflac__decode_samples_with_residual__rice__scalar_zeroorder(
-        bs, bitsPerSample, count, riceParam, order, shift, coefficients, pSamplesOut);
-  }
-
-  riceParamMask = (uint32_t) ~((~0UL) << riceParam);
-  pSamplesOutEnd = pSamplesOut + (count & ~3);
-
-  if (bitsPerSample + shift > 32) {
-    while (pSamplesOut < pSamplesOutEnd) {
-      /*
-      Rice extraction. It's faster to do this one at a time against local
-      variables than it is to use the x4 version against an array. Not sure why,
-      but perhaps it's making more efficient use of registers?
-      */
-      if (!drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart0, &riceParamPart0) ||
-          !drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart1, &riceParamPart1) ||
-          !drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart2, &riceParamPart2) ||
-          !drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart3, &riceParamPart3)) {
-        return DRFLAC_FALSE;
-      }
+  while (pSamplesOut < pSamplesOutEnd) {
+    if (!drflac__read_rice_residuals(bs, 4, riceParam, pSamplesOut)) { return DRFLAC_FALSE; }
 
-      riceParamPart0 &= riceParamMask;
-      riceParamPart1 &= riceParamMask;
-      riceParamPart2 &= riceParamMask;
-      riceParamPart3 &= riceParamMask;
+    pSamplesOut[0] = (int32_t)((uint32_t)pSamplesOut[0] +
+                               (uint32_t)drflac__calculate_prediction_32(order, shift, coefficients,
+                                                                         pSamplesOut + 0));
+    pSamplesOut[1] = (int32_t)((uint32_t)pSamplesOut[1] +
+                               (uint32_t)drflac__calculate_prediction_32(order, shift, coefficients,
+                                                                         pSamplesOut + 1));
+    pSamplesOut[2] = (int32_t)((uint32_t)pSamplesOut[2] +
+                               (uint32_t)drflac__calculate_prediction_32(order, shift, coefficients,
+                                                                         pSamplesOut + 2));
+    pSamplesOut[3] = (int32_t)((uint32_t)pSamplesOut[3] +
+                               (uint32_t)drflac__calculate_prediction_32(order, shift, coefficients,
+                                                                         pSamplesOut + 3));
 
-      riceParamPart0 |= (zeroCountPart0 << riceParam);
-      riceParamPart1 |= (zeroCountPart1 << riceParam);
-      riceParamPart2 |= (zeroCountPart2 << riceParam);
-      riceParamPart3 |= (zeroCountPart3 << riceParam);
+    pSamplesOut += 4;
+  }
 
-      riceParamPart0 = (riceParamPart0 >> 1) ^ t[riceParamPart0 & 0x01];
-      riceParamPart1 = (riceParamPart1 >> 1) ^ t[riceParamPart1 & 0x01];
-      riceParamPart2 = (riceParamPart2 >> 1) ^ t[riceParamPart2 & 0x01];
-      riceParamPart3 = (riceParamPart3 >> 1) ^ t[riceParamPart3 & 0x01];
+  if (!drflac__read_rice_residuals(bs, count & 3, riceParam, pSamplesOut)) {
+    return DRFLAC_FALSE;
+  }
 
-      pSamplesOut[0] = riceParamPart0 +
-                       drflac__calculate_prediction_64(order, shift, coefficients, pSamplesOut + 0);
-      pSamplesOut[1] = riceParamPart1 +
-                       drflac__calculate_prediction_64(order, shift, coefficients, pSamplesOut + 1);
-      pSamplesOut[2] = riceParamPart2 +
-                       drflac__calculate_prediction_64(order, shift, coefficients, pSamplesOut + 2);
-      pSamplesOut[3] = riceParamPart3 +
-                       drflac__calculate_prediction_64(order, shift, coefficients, pSamplesOut + 3);
+  for (i = 0; i < (count & 3); i += 1) {
+    pSamplesOut[i] = (int32_t)((uint32_t)pSamplesOut[i] +
+                               (uint32_t)drflac__calculate_prediction_32(order, shift, coefficients,
+                                                                         pSamplesOut + i));
+  }
 
-      pSamplesOut += 4;
-    }
-  } else {
-    while (pSamplesOut < pSamplesOutEnd) {
-      if (!drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart0, &riceParamPart0) ||
-          !drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart1, &riceParamPart1) ||
-          !drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart2, &riceParamPart2) ||
-          !drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart3, &riceParamPart3)) {
-        return DRFLAC_FALSE;
-      }
+  return DRFLAC_TRUE;
+}
 
-      riceParamPart0 &= riceParamMask;
-      riceParamPart1 &= riceParamMask;
-      riceParamPart2 &= riceParamMask;
-      riceParamPart3 &= riceParamMask;
+static DRFLAC_INLINE bool drflac__decode_samples_with_residual__rice__scalar_64(
+    drflac_bs* bs, uint32_t count, uint8_t riceParam, uint32_t order, int32_t shift,
+    const int32_t* coefficients, int32_t* pSamplesOut) {
+  const int32_t* pSamplesOutEnd = pSamplesOut + (count & ~3);
+  uint32_t i;
 
-      riceParamPart0 |= (zeroCountPart0 << riceParam);
-      riceParamPart1 |= (zeroCountPart1 << riceParam);
-      riceParamPart2 |= (zeroCountPart2 << riceParam);
-      riceParamPart3 |= (zeroCountPart3 << riceParam);
+  DRFLAC_ASSERT(bs != NULL);
+  DRFLAC_ASSERT(pSamplesOut != NULL);
 
-      riceParamPart0 = (riceParamPart0 >> 1) ^ t[riceParamPart0 & 0x01];
-      riceParamPart1 = (riceParamPart1 >> 1) ^ t[riceParamPart1 & 0x01];
-      riceParamPart2 = (riceParamPart2 >> 1) ^ t[riceParamPart2 & 0x01];
-      riceParamPart3 = (riceParamPart3 >> 1) ^ t[riceParamPart3 & 0x01];
+  while (pSamplesOut < pSamplesOutEnd) {
+    if (!drflac__read_rice_residuals(bs, 4, riceParam, pSamplesOut)) { return DRFLAC_FALSE; }
 
-      pSamplesOut[0] = riceParamPart0 +
-                       drflac__calculate_prediction_32(order, shift, coefficients, pSamplesOut + 0);
-      pSamplesOut[1] = riceParamPart1 +
-                       drflac__calculate_prediction_32(order, shift, coefficients, pSamplesOut + 1);
-      pSamplesOut[2] = riceParamPart2 +
-                       drflac__calculate_prediction_32(order, shift, coefficients, pSamplesOut + 2);
-      pSamplesOut[3] = riceParamPart3 +
-                       drflac__calculate_prediction_32(order, shift, coefficients, pSamplesOut + 3);
+    pSamplesOut[0] = (int32_t)((uint32_t)pSamplesOut[0] +
+                               (uint32_t)drflac__calculate_prediction_64(order, shift, coefficients,
+                                                                         pSamplesOut + 0));
+    pSamplesOut[1] = (int32_t)((uint32_t)pSamplesOut[1] +
+                               (uint32_t)drflac__calculate_prediction_64(order, shift, coefficients,
+                                                                         pSamplesOut + 1));
+    pSamplesOut[2] = (int32_t)((uint32_t)pSamplesOut[2] +
+                               (uint32_t)drflac__calculate_prediction_64(order, shift, coefficients,
+                                                                         pSamplesOut + 2));
+    pSamplesOut[3] = (int32_t)((uint32_t)pSamplesOut[3] +
+                               (uint32_t)drflac__calculate_prediction_64(order, shift, coefficients,
+                                                                         pSamplesOut + 3));
 
-      pSamplesOut += 4;
-    }
+    pSamplesOut += 4;
   }
 
-  i = (count & ~3);
-  while (i < count) {
-    /* Rice extraction. */
-    if (!drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart0, &riceParamPart0)) {
-      return DRFLAC_FALSE;
-    }
-
-    /* Rice reconstruction. */
-    riceParamPart0 &= riceParamMask;
-    riceParamPart0 |= (zeroCountPart0 << riceParam);
-    riceParamPart0 = (riceParamPart0 >> 1) ^ t[riceParamPart0 & 0x01];
-    /*riceParamPart0  = (riceParamPart0 >> 1) ^ (~(riceParamPart0 & 0x01) +
-     * 1);*/
-
-    /* Sample reconstruction. */
-    if (bitsPerSample + shift > 32) {
-      pSamplesOut[0] = riceParamPart0 +
-                       drflac__calculate_prediction_64(order, shift, coefficients, pSamplesOut + 0);
-    } else {
-      pSamplesOut[0] = riceParamPart0 +
-                       drflac__calculate_prediction_32(order, shift, coefficients, pSamplesOut + 0);
-    }
+  if (!drflac__read_rice_residuals(bs, count & 3, riceParam, pSamplesOut)) {
+    return DRFLAC_FALSE;
+  }
 
-    i += 1;
-    pSamplesOut += 1;
+  for (i = 0; i < (count & 3); i += 1) {
+    pSamplesOut[i] = (int32_t)((uint32_t)pSamplesOut[i] +
+                               (uint32_t)drflac__calculate_prediction_64(order, shift, coefficients,
+                                                                         pSamplesOut + i));
   }
 
   return DRFLAC_TRUE;
 }
 
+DRFLAC_DEFINE_RICE_ORDERS(drflac__decode_samples_with_residual__rice__scalar_32)
+DRFLAC_DEFINE_RICE_ORDERS(drflac__decode_samples_with_residual__rice__scalar_64)
+
 #if defined(DRFLAC_SUPPORT_SSE2)
 static DRFLAC_INLINE __m128i drflac__mm_packs_interleaved_epi32(__m128i a, __m128i b) {
   __m128i r;
@@ -2979,81 +3569,312 @@ static bool drflac__decode_samples_with_residual__rice__sse41_64(
 
   return DRFLAC_TRUE;
 }
+#endif
 
-static bool drflac__decode_samples_with_residual__rice__sse41(
-    drflac_bs* bs, uint32_t bitsPerSample, uint32_t count, uint8_t riceParam,
-    uint32_t order, int32_t shift, const int32_t* coefficients,
-    int32_t* pSamplesOut) {
-  DRFLAC_ASSERT(bs != NULL);
-  DRFLAC_ASSERT(pSamplesOut != NULL);
+#if defined(DRFLAC_SUPPORT_AVX2)
+/*
+Reads 8 rice coded residuals and reconstructs them into pResidualsOut. The bit
+reading is serial, but the reconstruction is done in a single pass.
+*/
+static DRFLAC_INLINE bool drflac__read_rice_residuals_x8__avx2(drflac_bs* bs, uint8_t riceParam,
+                                                               __m256i riceParamMask256,
+                                                               int32_t* pResidualsOut) {
+  uint32_t zeroCountParts[8];
+  uint32_t riceParamParts[8];
+  __m256i zeroCountPart256;
+  __m256i riceParamPart256;
+  int i;
 
-  /* In my testing the order is rarely > 12, so in this case I'm going to
-   * simplify the SSE implementation by only handling order <= 12. */
-  if (order > 0 && order <= 12) {
-    if (bitsPerSample + shift > 32) {
-      return drflac__decode_samples_with_residual__rice__sse41_64(bs, count, riceParam, order,
-                                                                  shift, coefficients, pSamplesOut);
-    } else {
-      return drflac__decode_samples_with_residual__rice__sse41_32(bs, count, riceParam, order,
-                                                                  shift, coefficients, pSamplesOut);
+  for (i = 0; i < 8; i += 1) {
+    if (!drflac__read_rice_parts_x1(bs, riceParam, &zeroCountParts[i], &riceParamParts[i])) {
+      return DRFLAC_FALSE;
     }
-  } else {
-    return drflac__decode_samples_with_residual__rice__scalar(
-        bs, bitsPerSample, count, riceParam, order, shift, coefficients, pSamplesOut);
   }
-}
-#endif
 
-#if defined(DRFLAC_SUPPORT_NEON)
-static DRFLAC_INLINE void drflac__vst2q_s32(int32_t* p, int32x4x2_t x) {
-  vst1q_s32(p + 0, x.val[0]);
-  vst1q_s32(p + 4, x.val[1]);
-}
+  zeroCountPart256 = _mm256_loadu_si256((const __m256i*)zeroCountParts);
+  riceParamPart256 = _mm256_loadu_si256((const __m256i*)riceParamParts);
 
-static DRFLAC_INLINE void drflac__vst2q_u32(uint32_t* p, uint32x4x2_t x) {
-  vst1q_u32(p + 0, x.val[0]);
-  vst1q_u32(p + 4, x.val[1]);
-}
+  riceParamPart256 = _mm256_and_si256(riceParamPart256, riceParamMask256);
+  riceParamPart256 = _mm256_or_si256(
+      riceParamPart256, _mm256_sll_epi32(zeroCountPart256, _mm_cvtsi32_si128(riceParam)));
+  riceParamPart256 = _mm256_xor_si256(
+      _mm256_srli_epi32(riceParamPart256, 1),
+      _mm256_sub_epi32(_mm256_setzero_si256(),
+                       _mm256_and_si256(riceParamPart256, _mm256_set1_epi32(1))));
 
-static DRFLAC_INLINE void drflac__vst2q_f32(float* p, float32x4x2_t x) {
-  vst1q_f32(p + 0, x.val[0]);
-  vst1q_f32(p + 4, x.val[1]);
+  _mm256_storeu_si256((__m256i*)pResidualsOut, riceParamPart256);
+  return DRFLAC_TRUE;
 }
 
-static DRFLAC_INLINE void drflac__vst2q_s16(int16_t* p, int16x4x2_t x) {
-  vst1q_s16(p, vcombine_s16(x.val[0], x.val[1]));
-}
+/*
+The AVX2 path works on blocks of 8 samples. Because of the recursive nature of
+LPC a sample can't be predicted until the one before it has been reconstructed,
+however most of the taps for a block only reach back into samples from before
+the block. Those are done 8 lanes at a time with one broadcast coefficient per
+tap. Only the taps that reach into the block itself are done serially.
+
+pCoefficientsOut[j] holds coefficients[j] in lanes 0..j with the lanes above it
+cleared, since lane i can only use tap j from before the block when j >= i.
+*/
+static void drflac__load_block_coefficients__avx2(uint32_t order, const int32_t* coefficients,
+                                                  __m256i* pCoefficientsOut) {
+  uint32_t j;
 
-static DRFLAC_INLINE void drflac__vst2q_u16(uint16_t* p, uint16x4x2_t x) {
-  vst1q_u16(p, vcombine_u16(x.val[0], x.val[1]));
-}
+  DRFLAC_ASSERT(order <= 32);
 
-static DRFLAC_INLINE int32x4_t drflac__vdupq_n_s32x4(int32_t x3, int32_t x2,
-                                                     int32_t x1, int32_t x0) {
-  int32_t x[4];
-  x[3] = x3;
-  x[2] = x2;
-  x[1] = x1;
-  x[0] = x0;
-  return vld1q_s32(x);
+  for (j = 0; j < order; j += 1) {
+    __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32((int32_t)j + 1),
+                                      _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    pCoefficientsOut[j] = _mm256_and_si256(_mm256_set1_epi32(coefficients[j]), mask);
+  }
 }
 
-static DRFLAC_INLINE int32x4_t drflac__valignrq_s32_1(int32x4_t a, int32x4_t b) {
-  /* Equivalent to SSE's _mm_alignr_epi8(a, b, 4) */
+static bool drflac__decode_samples_with_residual__rice__avx2_32(
+    drflac_bs* bs, uint32_t count, uint8_t riceParam, uint32_t order,
+    int32_t shift, const int32_t* coefficients, int32_t* pSamplesOut) {
+  uint32_t i;
+  uint32_t j;
+  uint32_t riceParamMask;
+  int32_t* pDecodedSamples = pSamplesOut;
+  int32_t* pDecodedSamplesEnd = pSamplesOut + (count & ~7);
+  uint32_t zeroCountPart0 = 0;
+  uint32_t riceParamPart0 = 0;
+  int32_t residuals[8];
+  int32_t predictions[8];
+  int32_t c0, c1, c2, c3, c4, c5, c6;
+  int32_t x0, x1, x2, x3, x4, x5, x6, x7;
+  __m256i blockCoefficients[32];
+  __m256i riceParamMask256;
 
-  /* Reference */
-  /*return drflac__vdupq_n_s32x4(
-      vgetq_lane_s32(a, 0),
-      vgetq_lane_s32(b, 3),
-      vgetq_lane_s32(b, 2),
-      vgetq_lane_s32(b, 1)
-  );*/
+  const uint32_t t[2] = {0x00000000, 0xFFFFFFFF};
 
-  return vextq_s32(b, a, 1);
-}
+  riceParamMask = (uint32_t) ~((~0UL) << riceParam);
+  riceParamMask256 = _mm256_set1_epi32(riceParamMask);
 
-static DRFLAC_INLINE uint32x4_t drflac__valignrq_u32_1(uint32x4_t a, uint32x4_t b) {
-  /* Equivalent to SSE's _mm_alignr_epi8(a, b, 4) */
+  drflac__load_block_coefficients__avx2(order, coefficients, blockCoefficients);
+
+  /* The first 7 taps are the only ones that can reach into the current block. */
+  c0 = (order > 0) ? coefficients[0] : 0;
+  c1 = (order > 1) ? coefficients[1] : 0;
+  c2 = (order > 2) ? coefficients[2] : 0;
+  c3 = (order > 3) ? coefficients[3] : 0;
+  c4 = (order > 4) ? coefficients[4] : 0;
+  c5 = (order > 5) ? coefficients[5] : 0;
+  c6 = (order > 6) ? coefficients[6] : 0;
+
+  while (pDecodedSamples < pDecodedSamplesEnd) {
+    __m256i prediction256 = _mm256_setzero_si256();
+
+    if (!drflac__read_rice_residuals_x8__avx2(bs, riceParam, riceParamMask256, residuals)) {
+      return DRFLAC_FALSE;
+    }
+
+    /* The lanes that reach into the current block have a zero coefficient so
+     * it doesn't matter what's loaded into them. */
+    for (j = 0; j < order; j += 1) {
+      prediction256 = _mm256_add_epi32(
+          prediction256,
+          _mm256_mullo_epi32(blockCoefficients[j],
+                             _mm256_loadu_si256((const __m256i*)(pDecodedSamples - 1 - j))));
+    }
+    _mm256_storeu_si256((__m256i*)predictions, prediction256);
+
+    /* The serial part. Each sample only waits on a single multiply-add from the
+     * one before it. */
+    x0 = residuals[0] + (predictions[0] >> shift);
+    x1 = residuals[1] + ((predictions[1] + c0 * x0) >> shift);
+    x2 = residuals[2] + ((predictions[2] + c0 * x1 + c1 * x0) >> shift);
+    x3 = residuals[3] + ((predictions[3] + c0 * x2 + c1 * x1 + c2 * x0) >> shift);
+    x4 = residuals[4] + ((predictions[4] + c0 * x3 + c1 * x2 + c2 * x1 + c3 * x0) >> shift);
+    x5 = residuals[5] +
+         ((predictions[5] + c0 * x4 + c1 * x3 + c2 * x2 + c3 * x1 + c4 * x0) >> shift);
+    x6 = residuals[6] +
+         ((predictions[6] + c0 * x5 + c1 * x4 + c2 * x3 + c3 * x2 + c4 * x1 + c5 * x0) >> shift);
+    x7 = residuals[7] + ((predictions[7] + c0 * x6 + c1 * x5 + c2 * x4 + c3 * x3 + c4 * x2 +
+                          c5 * x1 + c6 * x0) >>
+                         shift);
+
+    _mm256_storeu_si256((__m256i*)pDecodedSamples,
+                        _mm256_setr_epi32(x0, x1, x2, x3, x4, x5, x6, x7));
+    pDecodedSamples += 8;
+  }
+
+  /* Make sure we process the last few samples. */
+  i = (count & ~7);
+  while (i < count) {
+    /* Rice extraction. */
+    if (!drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart0, &riceParamPart0)) {
+      return DRFLAC_FALSE;
+    }
+
+    /* Rice reconstruction. */
+    riceParamPart0 &= riceParamMask;
+    riceParamPart0 |= (zeroCountPart0 << riceParam);
+    riceParamPart0 = (riceParamPart0 >> 1) ^ t[riceParamPart0 & 0x01];
+
+    /* Sample reconstruction. */
+    pDecodedSamples[0] = riceParamPart0 + drflac__calculate_prediction_32(
+                                              order, shift, coefficients, pDecodedSamples);
+
+    i += 1;
+    pDecodedSamples += 1;
+  }
+
+  return DRFLAC_TRUE;
+}
+
+static bool drflac__decode_samples_with_residual__rice__avx2_64(
+    drflac_bs* bs, uint32_t count, uint8_t riceParam, uint32_t order,
+    int32_t shift, const int32_t* coefficients, int32_t* pSamplesOut) {
+  uint32_t i;
+  uint32_t j;
+  uint32_t riceParamMask;
+  int32_t* pDecodedSamples = pSamplesOut;
+  int32_t* pDecodedSamplesEnd = pSamplesOut + (count & ~7);
+  uint32_t zeroCountPart0 = 0;
+  uint32_t riceParamPart0 = 0;
+  int32_t residuals[8];
+  int64_t predictions[8];
+  int64_t c0, c1, c2, c3, c4, c5, c6;
+  int32_t x0, x1, x2, x3, x4, x5, x6, x7;
+  __m256i blockCoefficients[32];
+  __m256i riceParamMask256;
+
+  const uint32_t t[2] = {0x00000000, 0xFFFFFFFF};
+
+  riceParamMask = (uint32_t) ~((~0UL) << riceParam);
+  riceParamMask256 = _mm256_set1_epi32(riceParamMask);
+
+  drflac__load_block_coefficients__avx2(order, coefficients, blockCoefficients);
+
+  /* The first 7 taps are the only ones that can reach into the current block. */
+  c0 = (order > 0) ? coefficients[0] : 0;
+  c1 = (order > 1) ? coefficients[1] : 0;
+  c2 = (order > 2) ? coefficients[2] : 0;
+  c3 = (order > 3) ? coefficients[3] : 0;
+  c4 = (order > 4) ? coefficients[4] : 0;
+  c5 = (order > 5) ? coefficients[5] : 0;
+  c6 = (order > 6) ? coefficients[6] : 0;
+
+  while (pDecodedSamples < pDecodedSamplesEnd) {
+    __m256i prediction256_0 = _mm256_setzero_si256();
+    __m256i prediction256_4 = _mm256_setzero_si256();
+
+    if (!drflac__read_rice_residuals_x8__avx2(bs, riceParam, riceParamMask256, residuals)) {
+      return DRFLAC_FALSE;
+    }
+
+    /* Same as the 32-bit version, but split into two sets of 4 64-bit lanes. */
+    for (j = 0; j < order; j += 1) {
+      prediction256_0 = _mm256_add_epi64(
+          prediction256_0,
+          _mm256_mul_epi32(
+              _mm256_cvtepi32_epi64(_mm256_castsi256_si128(blockCoefficients[j])),
+              _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(pDecodedSamples - 1 - j)))));
+      prediction256_4 = _mm256_add_epi64(
+          prediction256_4,
+          _mm256_mul_epi32(
+              _mm256_cvtepi32_epi64(_mm256_extracti128_si256(blockCoefficients[j], 1)),
+              _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(pDecodedSamples + 3 - j)))));
+    }
+    _mm256_storeu_si256((__m256i*)(predictions + 0), prediction256_0);
+    _mm256_storeu_si256((__m256i*)(predictions + 4), prediction256_4);
+
+    x0 = residuals[0] + (int32_t)(predictions[0] >> shift);
+    x1 = residuals[1] + (int32_t)((predictions[1] + c0 * x0) >> shift);
+    x2 = residuals[2] + (int32_t)((predictions[2] + c0 * x1 + c1 * x0) >> shift);
+    x3 = residuals[3] + (int32_t)((predictions[3] + c0 * x2 + c1 * x1 + c2 * x0) >> shift);
+    x4 = residuals[4] +
+         (int32_t)((predictions[4] + c0 * x3 + c1 * x2 + c2 * x1 + c3 * x0) >> shift);
+    x5 = residuals[5] +
+         (int32_t)((predictions[5] + c0 * x4 + c1 * x3 + c2 * x2 + c3 * x1 + c4 * x0) >> shift);
+    x6 = residuals[6] + (int32_t)((predictions[6] + c0 * x5 + c1 * x4 + c2 * x3 + c3 * x2 +
+                                   c4 * x1 + c5 * x0) >>
+                                  shift);
+    x7 = residuals[7] + (int32_t)((predictions[7] + c0 * x6 + c1 * x5 + c2 * x4 + c3 * x3 +
+                                   c4 * x2 + c5 * x1 + c6 * x0) >>
+                                  shift);
+
+    _mm256_storeu_si256((__m256i*)pDecodedSamples,
+                        _mm256_setr_epi32(x0, x1, x2, x3, x4, x5, x6, x7));
+    pDecodedSamples += 8;
+  }
+
+  /* Make sure we process the last few samples. */
+  i = (count & ~7);
+  while (i < count) {
+    /* Rice extraction. */
+    if (!drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart0, &riceParamPart0)) {
+      return DRFLAC_FALSE;
+    }
+
+    /* Rice reconstruction. */
+    riceParamPart0 &= riceParamMask;
+    riceParamPart0 |= (zeroCountPart0 << riceParam);
+    riceParamPart0 = (riceParamPart0 >> 1) ^ t[riceParamPart0 & 0x01];
+
+    /* Sample reconstruction. */
+    pDecodedSamples[0] = riceParamPart0 + drflac__calculate_prediction_64(
+                                              order, shift, coefficients, pDecodedSamples);
+
+    i += 1;
+    pDecodedSamples += 1;
+  }
+
+  return DRFLAC_TRUE;
+}
+#endif
+
+#if defined(DRFLAC_SUPPORT_NEON)
+static DRFLAC_INLINE void drflac__vst2q_s32(int32_t* p, int32x4x2_t x) {
+  vst1q_s32(p + 0, x.val[0]);
+  vst1q_s32(p + 4, x.val[1]);
+}
+
+static DRFLAC_INLINE void drflac__vst2q_u32(uint32_t* p, uint32x4x2_t x) {
+  vst1q_u32(p + 0, x.val[0]);
+  vst1q_u32(p + 4, x.val[1]);
+}
+
+static DRFLAC_INLINE void drflac__vst2q_f32(float* p, float32x4x2_t x) {
+  vst1q_f32(p + 0, x.val[0]);
+  vst1q_f32(p + 4, x.val[1]);
+}
+
+static DRFLAC_INLINE void drflac__vst2q_s16(int16_t* p, int16x4x2_t x) {
+  vst1q_s16(p, vcombine_s16(x.val[0], x.val[1]));
+}
+
+static DRFLAC_INLINE void drflac__vst2q_u16(uint16_t* p, uint16x4x2_t x) {
+  vst1q_u16(p, vcombine_u16(x.val[0], x.val[1]));
+}
+
+static DRFLAC_INLINE int32x4_t drflac__vdupq_n_s32x4(int32_t x3, int32_t x2,
+                                                     int32_t x1, int32_t x0) {
+  int32_t x[4];
+  x[3] = x3;
+  x[2] = x2;
+  x[1] = x1;
+  x[0] = x0;
+  return vld1q_s32(x);
+}
+
+static DRFLAC_INLINE int32x4_t drflac__valignrq_s32_1(int32x4_t a, int32x4_t b) {
+  /* Equivalent to SSE's _mm_alignr_epi8(a, b, 4) */
+
+  /* Reference */
+  /*return drflac__vdupq_n_s32x4(
+      vgetq_lane_s32(a, 0),
+      vgetq_lane_s32(b, 3),
+      vgetq_lane_s32(b, 2),
+      vgetq_lane_s32(b, 1)
+  );*/
+
+  return vextq_s32(b, a, 1);
+}
+
+static DRFLAC_INLINE uint32x4_t drflac__valignrq_u32_1(uint32x4_t a, uint32x4_t b) {
+  /* Equivalent to SSE's _mm_alignr_epi8(a, b, 4) */
 
   /* Reference */
   /*return drflac__vdupq_n_s32x4(
@@ -3509,55 +4330,45 @@ static bool drflac__decode_samples_with_residual__rice__neon_64(
 
   return DRFLAC_TRUE;
 }
+#endif
 
-static bool drflac__decode_samples_with_residual__rice__neon(
-    drflac_bs* bs, uint32_t bitsPerSample, uint32_t count, uint8_t riceParam,
-    uint32_t order, int32_t shift, const int32_t* coefficients,
-    int32_t* pSamplesOut) {
-  DRFLAC_ASSERT(bs != NULL);
-  DRFLAC_ASSERT(pSamplesOut != NULL);
+/*
+Picks the kernel for the rice partitions of a subframe. This only depends on
+the subframe, so it's done once up front rather than for every partition.
+*/
+static drflac__decode_rice_proc drflac__get_rice_proc(uint32_t bitsPerSample, uint32_t order,
+                                                      int32_t shift) {
+  bool is64 = bitsPerSample + shift > 32;
 
-  /* In my testing the order is rarely > 12, so in this case I'm going to
-   * simplify the NEON implementation by only handling order <= 12. */
-  if (order > 0 && order <= 12) {
-    if (bitsPerSample + shift > 32) {
-      return drflac__decode_samples_with_residual__rice__neon_64(bs, count, riceParam, order, shift,
-                                                                 coefficients, pSamplesOut);
-    } else {
-      return drflac__decode_samples_with_residual__rice__neon_32(bs, count, riceParam, order, shift,
-                                                                 coefficients, pSamplesOut);
-    }
-  } else {
-    return drflac__decode_samples_with_residual__rice__scalar(
-        bs, bitsPerSample, count, riceParam, order, shift, coefficients, pSamplesOut);
-  }
-}
-#endif
+  DRFLAC_ASSERT(order <= 32);
 
-static bool drflac__decode_samples_with_residual__rice(
-    drflac_bs* bs, uint32_t bitsPerSample, uint32_t count, uint8_t riceParam,
-    uint32_t order, int32_t shift, const int32_t* coefficients,
-    int32_t* pSamplesOut) {
+  if (order > 0) {
 #if defined(DRFLAC_SUPPORT_SSE41)
-  if (drflac__gIsSSE41Supported) {
-    return drflac__decode_samples_with_residual__rice__sse41(
-        bs, bitsPerSample, count, riceParam, order, shift, coefficients, pSamplesOut);
-  } else
-#elif defined(DRFLAC_SUPPORT_NEON)
-  if (drflac__gIsNEONSupported) {
-    return drflac__decode_samples_with_residual__rice__neon(
-        bs, bitsPerSample, count, riceParam, order, shift, coefficients, pSamplesOut);
-  } else
+#if defined(DRFLAC_SUPPORT_AVX2)
+    /* Unlike the SSE and NEON paths this handles every order the format allows. */
+    if (drflac__gIsAVX2Supported) {
+      return is64 ? drflac__decode_samples_with_residual__rice__avx2_64
+                  : drflac__decode_samples_with_residual__rice__avx2_32;
+    }
 #endif
-  {
-    /* Scalar fallback. */
-#if 0
-        return drflac__decode_samples_with_residual__rice__reference(bs, bitsPerSample, count, riceParam, order, shift, coefficients, pSamplesOut);
-#else
-    return drflac__decode_samples_with_residual__rice__scalar(
-        bs, bitsPerSample, count, riceParam, order, shift, coefficients, pSamplesOut);
+    /* In my testing the order is rarely > 12, so in this case I'm going to
+     * simplify the SSE implementation by only handling order <= 12. */
+    if (drflac__gIsSSE41Supported && order <= 12) {
+      return is64 ? drflac__decode_samples_with_residual__rice__sse41_64
+                  : drflac__decode_samples_with_residual__rice__sse41_32;
+    }
+#elif defined(DRFLAC_SUPPORT_NEON)
+    /* Same as SSE, the NEON implementation only handles order <= 12. */
+    if (drflac__gIsNEONSupported && order <= 12) {
+      return is64 ? drflac__decode_samples_with_residual__rice__neon_64
+                  : drflac__decode_samples_with_residual__rice__neon_32;
+    }
 #endif
   }
+
+  /* Scalar fallback. */
+  return is64 ? drflac__decode_samples_with_residual__rice__scalar_64__procs[order]
+              : drflac__decode_samples_with_residual__rice__scalar_32__procs[order];
 }
 
 /* Reads and seeks past a string of residual values as Rice codes. The decoder
@@ -3619,6 +4430,7 @@ static bool drflac__decode_samples_with_residual(
   uint8_t partitionOrder;
   uint32_t samplesInPartition;
   uint32_t partitionsRemaining;
+  drflac__decode_rice_proc onDecodeRice;
 
   DRFLAC_ASSERT(bs != NULL);
   DRFLAC_ASSERT(blockSize != 0);
@@ -3647,6 +4459,8 @@ static bool drflac__decode_samples_with_residual(
   /* Validation check. */
   if ((blockSize / (1 << partitionOrder)) < order) { return DRFLAC_FALSE; }
 
+  onDecodeRice = drflac__get_rice_proc(bitsPerSample, order, shift);
+
   samplesInPartition = (blockSize / (1 << partitionOrder)) - order;
   partitionsRemaining = (1 << partitionOrder);
   for (;;) {
@@ -3660,9 +4474,8 @@ static bool drflac__decode_samples_with_residual(
     }
 
     if (riceParam != 0xFF) {
-      if (!drflac__decode_samples_with_residual__rice(bs, bitsPerSample, samplesInPartition,
-                                                      riceParam, order, shift, coefficients,
-                                                      pDecodedSamples)) {
+      if (!onDecodeRice(bs, samplesInPartition, riceParam, order, shift, coefficients,
+                        pDecodedSamples)) {
         return DRFLAC_FALSE;
       }
     } else {
@@ -4175,9 +4988,162 @@ drflac__get_channel_count_from_channel_assignment(int8_t channelAssignment) {
   return lookup[channelAssignment];
 }
 
+static void drflac__get_pcm_frame_range_of_current_flac_frame(drflac* pFlac,
+                                                              uint64_t* pFirstPCMFrame,
+                                                              uint64_t* pLastPCMFrame);
+
+#define DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES 128
+
+static void drflac__md5_get_samples(const drflac_frame* pFrame, uint32_t channels,
+                                    uint32_t offset, uint32_t count,
+                                    int32_t samples[8][DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES]) {
+  const int32_t* pIn0 = pFrame->subframes[0].pSamplesS32 + offset;
+  const int32_t* pIn1 = pFrame->subframes[1].pSamplesS32 + offset;
+  uint32_t shift0 = pFrame->subframes[0].wastedBitsPerSample;
+  uint32_t shift1 = pFrame->subframes[1].wastedBitsPerSample;
+  uint32_t iChannel;
+  uint32_t i;
+
+  /* Shifts are done unsigned to keep them well defined for negative samples. */
+  switch (pFrame->header.channelAssignment) {
+  case DRFLAC_CHANNEL_ASSIGNMENT_LEFT_SIDE: {
+    for (i = 0; i < count; ++i) {
+      uint32_t left = (uint32_t)pIn0[i] << shift0;
+      uint32_t side = (uint32_t)pIn1[i] << shift1;
+      samples[0][i] = (int32_t)left;
+      samples[1][i] = (int32_t)(left - side);
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_RIGHT_SIDE: {
+    for (i = 0; i < count; ++i) {
+      uint32_t side = (uint32_t)pIn0[i] << shift0;
+      uint32_t right = (uint32_t)pIn1[i] << shift1;
+      samples[0][i] = (int32_t)(side + right);
+      samples[1][i] = (int32_t)right;
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_MID_SIDE: {
+    /* 64-bit so that 32-bit streams don't overflow. */
+    for (i = 0; i < count; ++i) {
+      int64_t side = (int32_t)((uint32_t)pIn1[i] << shift1);
+      int64_t mid = ((int64_t)(int32_t)((uint32_t)pIn0[i] << shift0) * 2) | (side & 1);
+      samples[0][i] = (int32_t)((mid + side) >> 1);
+      samples[1][i] = (int32_t)((mid - side) >> 1);
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_INDEPENDENT:
+  default: {
+    for (iChannel = 0; iChannel < channels; ++iChannel) {
+      const int32_t* pIn = pFrame->subframes[iChannel].pSamplesS32 + offset;
+      uint32_t shift = pFrame->subframes[iChannel].wastedBitsPerSample;
+      for (i = 0; i < count; ++i) { samples[iChannel][i] = (int32_t)((uint32_t)pIn[i] << shift); }
+    }
+  } break;
+  }
+}
+
+/*
+Feeds the current FLAC frame into the MD5. The reference encoder hashes the
+interleaved samples as little-endian signed integers using the minimum number of
+whole bytes needed for the bit depth, so that's what we do here.
+*/
+static void drflac__md5_update_from_current_flac_frame(drflac* pFlac) {
+  const drflac_frame* pFrame = &pFlac->currentFLACFrame;
+  uint32_t channels = pFlac->channels;
+  uint32_t bytesPerSample = ((uint32_t)pFlac->bitsPerSample + 7) / 8;
+  uint32_t frameCount = pFrame->header.blockSizeInPCMFrames;
+  uint64_t firstPCMFrame;
+  uint32_t offset;
+
+  /* Earlier frames have already been hashed and later ones would leave a gap. */
+  drflac__get_pcm_frame_range_of_current_flac_frame(pFlac, &firstPCMFrame, NULL);
+  if (firstPCMFrame != pFlac->md5NextPCMFrame) { return; }
+
+  for (offset = 0; offset < frameCount; offset += DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES) {
+    int32_t samples[8][DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES];
+    uint8_t bytes[DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES * 8 * 4];
+    uint8_t* pOut = bytes;
+    uint32_t count = frameCount - offset;
+    uint32_t iChannel;
+    uint32_t i;
+
+    if (count > DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES) { count = DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES; }
+
+    drflac__md5_get_samples(pFrame, channels, offset, count, samples);
+
+    switch (bytesPerSample) {
+    case 1: {
+      for (i = 0; i < count; ++i) {
+        for (iChannel = 0; iChannel < channels; ++iChannel) {
+          *pOut++ = (uint8_t)samples[iChannel][i];
+        }
+      }
+    } break;
+
+    case 2: {
+      for (i = 0; i < count; ++i) {
+        for (iChannel = 0; iChannel < channels; ++iChannel) {
+          uint32_t s = (uint32_t)samples[iChannel][i];
+          pOut[0] = (uint8_t)s;
+          pOut[1] = (uint8_t)(s >> 8);
+          pOut += 2;
+        }
+      }
+    } break;
+
+    case 3: {
+      for (i = 0; i < count; ++i) {
+        for (iChannel = 0; iChannel < channels; ++iChannel) {
+          uint32_t s = (uint32_t)samples[iChannel][i];
+          pOut[0] = (uint8_t)s;
+          pOut[1] = (uint8_t)(s >> 8);
+          pOut[2] = (uint8_t)(s >> 16);
+          pOut += 3;
+        }
+      }
+    } break;
+
+    default: {
+      for (i = 0; i < count; ++i) {
+        for (iChannel = 0; iChannel < channels; ++iChannel) {
+          uint32_t s = (uint32_t)samples[iChannel][i];
+          pOut[0] = (uint8_t)s;
+          pOut[1] = (uint8_t)(s >> 8);
+          pOut[2] = (uint8_t)(s >> 16);
+          pOut[3] = (uint8_t)(s >> 24);
+          pOut += 4;
+        }
+      }
+    } break;
+    }
+
+    drflac__md5_update(&pFlac->md5Context, bytes, (size_t)(pOut - bytes));
+  }
+
+  pFlac->md5NextPCMFrame = firstPCMFrame + frameCount;
+}
+
+/* Maps the channels the caller wants to the subframes that have to be decoded
+ * to produce them. In the stereo decorrelation modes a channel can depend on
+ * both subframes. */
+static uint32_t drflac__get_decoded_subframe_mask(int8_t channelAssignment,
+                                                  uint32_t channelMask) {
+  switch (channelAssignment) {
+  case DRFLAC_CHANNEL_ASSIGNMENT_LEFT_SIDE: return (channelMask & 0x02) ? 0x03 : channelMask;
+  case DRFLAC_CHANNEL_ASSIGNMENT_RIGHT_SIDE: return (channelMask & 0x01) ? 0x03 : channelMask;
+  case DRFLAC_CHANNEL_ASSIGNMENT_MID_SIDE: return (channelMask & 0x03) ? 0x03 : 0;
+  default: return channelMask;
+  }
+}
+
 static drflac_result drflac__decode_flac_frame(drflac* pFlac) {
   int channelCount;
   int i;
+  uint32_t allSubframesMask;
+  uint32_t subframeMask;
   uint8_t paddingSizeInBits;
   uint16_t desiredCRC16;
 #ifndef DR_FLAC_NO_CRC
@@ -4200,11 +5166,30 @@ static drflac_result drflac__decode_flac_frame(drflac* pFlac) {
       pFlac->currentFLACFrame.header.channelAssignment);
   if (channelCount != (int)pFlac->channels) { return DRFLAC_ERROR; }
 
+  /* Only the bits for channels this frame actually has count. */
+  allSubframesMask = (1U << channelCount) - 1;
+  subframeMask = drflac__get_decoded_subframe_mask(pFlac->currentFLACFrame.header.channelAssignment,
+                                                   (uint8_t)~pFlac->_skippedChannelMask) &
+                 allSubframesMask;
+
   for (i = 0; i < channelCount; ++i) {
-    if (!drflac__decode_subframe(&pFlac->bs, &pFlac->currentFLACFrame, i,
-                                 pFlac->pDecodedSamples +
-                                     (pFlac->currentFLACFrame.header.blockSizeInPCMFrames * i))) {
-      return DRFLAC_ERROR;
+    int32_t* pDecodedSamples =
+        pFlac->pDecodedSamples + (pFlac->currentFLACFrame.header.blockSizeInPCMFrames * i);
+
+    if ((subframeMask & (1U << i)) != 0) {
+      if (!drflac__decode_subframe(&pFlac->bs, &pFlac->currentFLACFrame, i, pDecodedSamples)) {
+        return DRFLAC_ERROR;
+      }
+    } else {
+      /* Skipped subframes still go through the bit stream so the CRC stays
+       * valid. The read APIs expect samples, so give them silence. */
+      if (!drflac__seek_subframe(&pFlac->bs, &pFlac->currentFLACFrame, i)) {
+        return DRFLAC_ERROR;
+      }
+
+      DRFLAC_ZERO_MEMORY(pDecodedSamples, pFlac->currentFLACFrame.header.blockSizeInPCMFrames *
+                                              sizeof(*pDecodedSamples));
+      pFlac->currentFLACFrame.subframes[i].pSamplesS32 = pDecodedSamples;
     }
   }
 
@@ -4224,6 +5209,13 @@ static drflac_result drflac__decode_flac_frame(drflac* pFlac) {
 #endif
 
   pFlac->currentFLACFrame.pcmFramesRemaining = pFlac->currentFLACFrame.header.blockSizeInPCMFrames;
+  pFlac->currentFLACFrame.isConvertedInPlace = DRFLAC_FALSE;
+
+  /* Skipping a channel leaves a gap in the hash which drflac_get_md5_result()
+   * reports as incomplete. */
+  if (pFlac->_isMD5Enabled && subframeMask == allSubframesMask) {
+    drflac__md5_update_from_current_flac_frame(pFlac);
+  }
 
   return DRFLAC_SUCCESS;
 }
@@ -4260,14 +5252,71 @@ static drflac_result drflac__seek_flac_frame(drflac* pFlac) {
   return DRFLAC_SUCCESS;
 }
 
-static bool drflac__read_and_decode_next_flac_frame(drflac* pFlac) {
+#if DR_FLAC_SEEK_INDEX_MAX_ENTRIES > 0
+static void drflac__record_seek_index_entry(drflac* pFlac, uint64_t frameBytePos);
+#endif
+
+#ifndef DR_FLAC_NO_OGG
+static uint64_t drflac_ogg__get_link_first_pcm_frame(drflac* pFlac);
+static bool drflac_ogg__is_link_ended(drflac* pFlac);
+static bool drflac_ogg__begin_next_link(drflac* pFlac, drflac_meta_proc onMeta);
+static void drflac_ogg__enter_link(drflac* pFlac, uint32_t iLink);
+#endif
+
+/*
+At the end of a link in a chained Ogg stream this carries on with the first
+frame of the next link. When stopAtFormatChange is set and the next link has a
+different format this returns false instead, having already moved on to the
+link, which is how the read functions avoid returning two formats in one call.
+*/
+static bool drflac__read_and_decode_next_flac_frame_private(drflac* pFlac,
+                                                            bool stopAtFormatChange) {
   DRFLAC_ASSERT(pFlac != NULL);
 
   for (;;) {
     drflac_result result;
+    uint64_t frameBytePos = drflac__get_byte_pos(&pFlac->bs);
 
     if (!drflac__read_next_flac_frame_header(&pFlac->bs, pFlac->bitsPerSample,
                                              &pFlac->currentFLACFrame.header)) {
+#ifndef DR_FLAC_NO_OGG
+      if (pFlac->container == drflac_container_ogg) {
+        uint32_t sampleRate = pFlac->sampleRate;
+        uint8_t channels = pFlac->channels;
+        uint8_t bitsPerSample = pFlac->bitsPerSample;
+        bool isLinkHashed = pFlac->currentPCMFrame == pFlac->md5NextPCMFrame;
+        uint8_t md5[16];
+
+        DRFLAC_COPY_MEMORY(md5, pFlac->md5, sizeof(md5));
+        if (drflac_ogg__begin_next_link(pFlac, pFlac->onMeta)) {
+          /*
+          Each link has its own MD5, so the link that's just ended is checked
+          now. A mismatch is remembered for the rest of the stream.
+          */
+          if (pFlac->_isMD5Enabled) {
+            if (isLinkHashed && !drflac__md5_matches(&pFlac->md5Context, md5)) {
+              pFlac->_isMD5Mismatched = DRFLAC_TRUE;
+            }
+            drflac__md5_init(&pFlac->md5Context);
+            pFlac->md5NextPCMFrame = drflac_ogg__get_link_first_pcm_frame(pFlac);
+          }
+
+          if (stopAtFormatChange &&
+              (pFlac->sampleRate != sampleRate || pFlac->channels != channels ||
+               pFlac->bitsPerSample != bitsPerSample)) {
+            return DRFLAC_FALSE;
+          }
+          continue;
+        }
+      }
+#else
+      (void)stopAtFormatChange;
+#endif
+
+      /* Needed for MD5 verification of streams with an unknown length. */
+      if (pFlac->_isMD5Enabled && pFlac->currentPCMFrame == pFlac->md5NextPCMFrame) {
+        pFlac->_isMD5AtEnd = DRFLAC_TRUE;
+      }
       return DRFLAC_FALSE;
     }
 
@@ -4280,10 +5329,41 @@ static bool drflac__read_and_decode_next_flac_frame(drflac* pFlac) {
       }
     }
 
+#if DR_FLAC_SEEK_INDEX_MAX_ENTRIES > 0
+    /* Remember where this frame is so we can jump straight back to it later. */
+    drflac__record_seek_index_entry(pFlac, frameBytePos);
+#else
+    (void)frameBytePos;
+#endif
+
     return DRFLAC_TRUE;
   }
 }
 
+static bool drflac__read_and_decode_next_flac_frame(drflac* pFlac) {
+  return drflac__read_and_decode_next_flac_frame_private(pFlac, DRFLAC_FALSE);
+}
+
+static bool drflac__read_and_decode_next_flac_frame_for_read(drflac* pFlac) {
+  return drflac__read_and_decode_next_flac_frame_private(pFlac, DRFLAC_TRUE);
+}
+
+/*
+Called by the read functions before returning. When the last frame of a link
+has been read the next frame is decoded straight away so the decoder moves on to
+the next link now. Any change of format then shows before the next read.
+*/
+static void drflac__read_ahead_at_end_of_link(drflac* pFlac) {
+#ifndef DR_FLAC_NO_OGG
+  if (pFlac->container == drflac_container_ogg &&
+      pFlac->currentFLACFrame.pcmFramesRemaining == 0 && drflac_ogg__is_link_ended(pFlac)) {
+    drflac__read_and_decode_next_flac_frame_for_read(pFlac);
+  }
+#else
+  (void)pFlac;
+#endif
+}
+
 static void drflac__get_pcm_frame_range_of_current_flac_frame(drflac* pFlac,
                                                               uint64_t* pFirstPCMFrame,
                                                               uint64_t* pLastPCMFrame) {
@@ -4298,6 +5378,11 @@ static void drflac__get_pcm_frame_range_of_current_flac_frame(drflac* pFlac,
                     pFlac->maxBlockSizeInPCMFrames;
   }
 
+#ifndef DR_FLAC_NO_OGG
+  /* Frame numbers start from 0 again in each link of a chained Ogg stream. */
+  firstPCMFrame += drflac_ogg__get_link_first_pcm_frame(pFlac);
+#endif
+
   lastPCMFrame = firstPCMFrame + pFlac->currentFLACFrame.header.blockSizeInPCMFrames;
   if (lastPCMFrame > 0) { lastPCMFrame -= 1; /* Needs to be zero based. */ }
 
@@ -4310,6 +5395,10 @@ static bool drflac__seek_to_first_frame(drflac* pFlac) {
 
   DRFLAC_ASSERT(pFlac != NULL);
 
+#ifndef DR_FLAC_NO_OGG
+  if (pFlac->container == drflac_container_ogg) { drflac_ogg__enter_link(pFlac, 0); }
+#endif
+
   result = drflac__seek_to_byte(&pFlac->bs, pFlac->firstFLACFramePosInBytes);
 
   DRFLAC_ZERO_MEMORY(&pFlac->currentFLACFrame, sizeof(pFlac->currentFLACFrame));
@@ -4729,6 +5818,68 @@ static bool drflac__seek_to_pcm_frame__binary_search(drflac* pFlac,
 }
 #endif /* !DR_FLAC_NO_CRC */
 
+/* Finds the last seek index entry starting at or before the target, or NULL if there is none. */
+static const drflac_seekpoint* drflac__find_seek_index_entry(drflac* pFlac,
+                                                             uint64_t pcmFrameIndex) {
+  uint32_t lo;
+  uint32_t hi;
+
+  if (pFlac->pSeekIndex == NULL || pFlac->seekIndexCount == 0) { return NULL; }
+
+  lo = 0;
+  hi = pFlac->seekIndexCount;
+  while (hi - lo > 1) {
+    uint32_t mid = lo + ((hi - lo) / 2);
+    if (pFlac->pSeekIndex[mid].firstPCMFrame <= pcmFrameIndex) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+
+  if (pFlac->pSeekIndex[lo].firstPCMFrame > pcmFrameIndex) { return NULL; }
+
+  return &pFlac->pSeekIndex[lo];
+}
+
+static bool drflac__seek_to_pcm_frame__seek_index(drflac* pFlac,
+                                                  uint64_t pcmFrameIndex) {
+  const drflac_seekpoint* pEntry;
+  uint64_t firstPCMFrame;
+
+  DRFLAC_ASSERT(pFlac != NULL);
+
+  pEntry = drflac__find_seek_index_entry(pFlac, pcmFrameIndex);
+  if (pEntry == NULL || pcmFrameIndex - pEntry->firstPCMFrame > pEntry->pcmFrameCount) {
+    return DRFLAC_FALSE; /* Not covered by the index. */
+  }
+
+  if (drflac__seek_to_byte(&pFlac->bs,
+                           pFlac->firstFLACFramePosInBytes + pEntry->flacFrameOffset)) {
+    DRFLAC_ZERO_MEMORY(&pFlac->currentFLACFrame, sizeof(pFlac->currentFLACFrame));
+    if (drflac__read_and_decode_next_flac_frame(pFlac)) {
+      /* Make sure the index actually points to the frame we expect. If it
+       * doesn't the index is stale and we'll need to fall back to the slower
+       * methods. */
+      drflac__get_pcm_frame_range_of_current_flac_frame(pFlac, &firstPCMFrame, NULL);
+      if (firstPCMFrame == pEntry->firstPCMFrame &&
+          pcmFrameIndex - firstPCMFrame <= pFlac->currentFLACFrame.pcmFramesRemaining) {
+        pFlac->currentFLACFrame.pcmFramesRemaining -= (uint32_t)(pcmFrameIndex - firstPCMFrame);
+        pFlac->currentPCMFrame = pcmFrameIndex;
+        return DRFLAC_TRUE;
+      }
+    }
+  }
+
+  /*
+  The stream has been moved so currentPCMFrame no longer describes where the
+  decoder is. The brute force seek carries on from the current position, so put
+  the decoder back at the start to give it a consistent one.
+  */
+  drflac__seek_to_first_frame(pFlac);
+  return DRFLAC_FALSE;
+}
+
 static bool drflac__seek_to_pcm_frame__seek_table(drflac* pFlac,
                                                            uint64_t pcmFrameIndex) {
   uint32_t iClosestSeekpoint = 0;
@@ -4971,11 +6122,13 @@ typedef struct {
   uint8_t bitsPerSample;
   uint64_t totalPCMFrameCount;
   uint16_t maxBlockSizeInPCMFrames;
+  uint8_t md5[16];
   uint64_t runningFilePos;
   bool hasStreamInfoBlock;
   bool hasMetadataBlocks;
   drflac_bs bs;                         /* <-- A bit streamer is required for loading data during
                                            initialization. */
+  drflac_cache_t cacheL2[DR_FLAC_BUFFER_SIZE / sizeof(drflac_cache_t)]; /* <-- bs.cacheL2 */
   drflac_frame_header firstFrameHeader; /* <-- The header of the first frame that was read
                                            during relaxed initalization. Only set if there is no
                                            STREAMINFO block. */
@@ -5084,6 +6237,22 @@ drflac__malloc_from_callbacks(size_t sz, const drlibs_allocation_callbacks* pAll
   return NULL;
 }
 
+static bool
+drflac__copy_allocation_callbacks_or_defaults(const drlibs_allocation_callbacks* pAllocationCallbacks,
+                                              drlibs_allocation_callbacks* pAllocationCallbacksOut) {
+  if (pAllocationCallbacks != NULL) {
+    *pAllocationCallbacksOut = *pAllocationCallbacks;
+    return pAllocationCallbacks->onFree != NULL &&
+           (pAllocationCallbacks->onMalloc != NULL || pAllocationCallbacks->onRealloc != NULL);
+  } else {
+    pAllocationCallbacksOut->pUserData = NULL;
+    pAllocationCallbacksOut->onMalloc = drflac__malloc_default;
+    pAllocationCallbacksOut->onRealloc = drflac__realloc_default;
+    pAllocationCallbacksOut->onFree = drflac__free_default;
+    return DRFLAC_TRUE;
+  }
+}
+
 static void*
 drflac__realloc_from_callbacks(void* p, size_t szNew, size_t szOld,
                                const drlibs_allocation_callbacks* pAllocationCallbacks) {
@@ -5120,10 +6289,156 @@ static void drflac__free_from_callbacks(void* p,
   }
 }
 
+static bool drflac__reserve_seek_index(drflac* pFlac, uint32_t capacity) {
+  drflac_seekpoint* pNewSeekIndex;
+
+  if (capacity <= pFlac->seekIndexCapacity) { return DRFLAC_TRUE; }
+
+  pNewSeekIndex = (drflac_seekpoint*)drflac__realloc_from_callbacks(
+      pFlac->pSeekIndex, capacity * sizeof(*pFlac->pSeekIndex),
+      pFlac->seekIndexCapacity * sizeof(*pFlac->pSeekIndex), &pFlac->allocationCallbacks);
+  if (pNewSeekIndex == NULL) { return DRFLAC_FALSE; }
+
+  pFlac->pSeekIndex = pNewSeekIndex;
+  pFlac->seekIndexCapacity = capacity;
+  return DRFLAC_TRUE;
+}
+
+static void drflac__free_seek_index(drflac* pFlac) {
+  drflac__free_from_callbacks(pFlac->pSeekIndex, &pFlac->allocationCallbacks);
+  pFlac->pSeekIndex = NULL;
+  pFlac->seekIndexCount = 0;
+  pFlac->seekIndexCapacity = 0;
+}
+
+#ifndef DR_FLAC_NO_OGG
+static void drflac_ogg__free_links(drflac* pFlac);
+#endif
+
+/* Frees a decoder along with everything it allocated. Does not touch the underlying stream. */
+static void drflac__free_decoder(drflac* pFlac) {
+  if (pFlac == NULL) { return; }
+
+  drflac__free_seek_index(pFlac);
+#ifndef DR_FLAC_NO_OGG
+  drflac_ogg__free_links(pFlac);
+#endif
+  drflac__free_from_callbacks(pFlac, &pFlac->allocationCallbacks);
+}
+
+/* The size of the memory holding the decoded samples of the largest frame in a stream. */
+static uint32_t drflac__get_decoded_samples_allocation_size(uint32_t maxBlockSizeInPCMFrames,
+                                                            uint32_t channels) {
+  uint32_t wholeSIMDVectorCountPerChannel;
+
+  /*
+  The allocation size for decoded frames depends on the number of 32-bit
+  integers that fit inside the largest SIMD vector we are supporting.
+  */
+  if ((maxBlockSizeInPCMFrames % (DRFLAC_MAX_SIMD_VECTOR_SIZE / sizeof(int32_t))) == 0) {
+    wholeSIMDVectorCountPerChannel =
+        (maxBlockSizeInPCMFrames / (DRFLAC_MAX_SIMD_VECTOR_SIZE / sizeof(int32_t)));
+  } else {
+    wholeSIMDVectorCountPerChannel =
+        (maxBlockSizeInPCMFrames / (DRFLAC_MAX_SIMD_VECTOR_SIZE / sizeof(int32_t))) + 1;
+  }
+
+  return wholeSIMDVectorCountPerChannel * DRFLAC_MAX_SIMD_VECTOR_SIZE * channels;
+}
+
+/*
+For Ogg streams the index maps pages rather than frames. See
+drflac_ogg__seek_to_pcm_frame().
+*/
+static bool drflac__can_use_seek_index(drflac* pFlac) {
+  return pFlac->firstFLACFramePosInBytes != 0;
+}
+
+#if DR_FLAC_SEEK_INDEX_MAX_ENTRIES > 0
+static void drflac__insert_seek_index_entry(drflac* pFlac, uint64_t firstPCMFrame,
+                                            uint64_t flacFrameOffset, uint16_t pcmFrameCount) {
+  drflac_seekpoint* pEntry;
+  uint32_t iEntry;
+
+  /*
+  Frames are normally decoded in order so the new entry will usually go on the
+  end. Otherwise we've seeked backwards and need to find where it slots in,
+  which may well be a frame we already know about.
+  */
+  iEntry = pFlac->seekIndexCount;
+  if (iEntry > 0 && pFlac->pSeekIndex[iEntry - 1].firstPCMFrame >= firstPCMFrame) {
+    uint32_t lo = 0;
+    uint32_t hi = pFlac->seekIndexCount;
+    while (lo < hi) {
+      uint32_t mid = lo + ((hi - lo) / 2);
+      if (pFlac->pSeekIndex[mid].firstPCMFrame < firstPCMFrame) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+
+    if (pFlac->pSeekIndex[lo].firstPCMFrame == firstPCMFrame) { return; }
+    iEntry = lo;
+  }
+
+  if (pFlac->seekIndexCount >= DR_FLAC_SEEK_INDEX_MAX_ENTRIES) { return; }
+
+  if (pFlac->seekIndexCount == pFlac->seekIndexCapacity) {
+    uint32_t newCapacity = (pFlac->seekIndexCapacity > 0) ? pFlac->seekIndexCapacity * 2 : 256;
+    if (newCapacity > DR_FLAC_SEEK_INDEX_MAX_ENTRIES) {
+      newCapacity = DR_FLAC_SEEK_INDEX_MAX_ENTRIES;
+    }
+
+    if (!drflac__reserve_seek_index(pFlac, newCapacity)) { return; }
+  }
+
+  pEntry = &pFlac->pSeekIndex[iEntry];
+  DRFLAC_MOVE_MEMORY(pEntry + 1, pEntry,
+                     (pFlac->seekIndexCount - iEntry) * sizeof(*pFlac->pSeekIndex));
+  pEntry->firstPCMFrame = firstPCMFrame;
+  pEntry->flacFrameOffset = flacFrameOffset;
+  pEntry->pcmFrameCount = pcmFrameCount;
+  pFlac->seekIndexCount += 1;
+}
+
+static void drflac__record_seek_index_entry(drflac* pFlac, uint64_t frameBytePos) {
+  uint64_t firstPCMFrame;
+
+  if (!drflac__can_use_seek_index(pFlac) || frameBytePos < pFlac->firstFLACFramePosInBytes) {
+    return;
+  }
+
+#ifndef DR_FLAC_NO_OGG
+  /* Ogg pages are recorded while seeking instead. Frame positions are meaningless there. */
+  if (pFlac->container == drflac_container_ogg) { return; }
+#endif
+
+  drflac__get_pcm_frame_range_of_current_flac_frame(pFlac, &firstPCMFrame, NULL);
+  drflac__insert_seek_index_entry(pFlac, firstPCMFrame,
+                                  frameBytePos - pFlac->firstFLACFramePosInBytes,
+                                  pFlac->currentFLACFrame.header.blockSizeInPCMFrames);
+}
+#endif
+
+#ifndef DR_FLAC_NO_OGG
+static size_t drflac__on_read_ogg(void* pUserData, void* bufferOut, size_t bytesToRead);
+static size_t drflac__on_read_memory(void* pUserData, void* bufferOut, size_t bytesToRead);
+#endif
+
+/*
+Picture data of at least lazyPictureDataSize bytes is seeked over rather than
+loaded and is reported to onMeta with a NULL pointer. Pass 0xFFFFFFFF to load
+all picture data.
+
+pLargestBlockSize, when not NULL, receives the size of the largest block that's
+loaded into memory when there's a metadata callback, whether or not there is one.
+*/
 static bool drflac__read_and_decode_metadata(
     drflac_read_proc onRead, drflac_seek_proc onSeek, drflac_meta_proc onMeta, void* pUserData,
     void* pUserDataMD, uint64_t* pFirstFramePos, uint64_t* pSeektablePos,
-    uint32_t* pSeektableSize, drlibs_allocation_callbacks* pAllocationCallbacks) {
+    uint32_t* pSeektableSize, uint32_t lazyPictureDataSize, uint32_t* pLargestBlockSize,
+    drlibs_allocation_callbacks* pAllocationCallbacks) {
   /*
   We want to keep track of the byte position in the stream of the seektable. At
   the time of calling this function we know that we'll be sitting on byte 42.
@@ -5132,6 +6447,12 @@ static bool drflac__read_and_decode_metadata(
   uint64_t seektablePos = 0;
   uint32_t seektableSize = 0;
 
+  /* Positions inside an Ogg stream don't correspond to positions in the file. */
+  bool isOffsetInStream = DRFLAC_TRUE;
+#ifndef DR_FLAC_NO_OGG
+  if (onRead == drflac__on_read_ogg) { isOffsetInStream = DRFLAC_FALSE; }
+#endif
+
   for (;;) {
     drflac_metadata metadata;
     uint8_t isLastBlock = 0;
@@ -5143,6 +6464,11 @@ static bool drflac__read_and_decode_metadata(
     }
     runningFilePos += 4;
 
+    if (pLargestBlockSize != NULL && blockType != DRFLAC_METADATA_BLOCK_TYPE_PADDING &&
+        blockType != DRFLAC_METADATA_BLOCK_TYPE_INVALID && blockSize > *pLargestBlockSize) {
+      *pLargestBlockSize = blockSize;
+    }
+
     metadata.type = blockType;
     metadata.pRawData = NULL;
     metadata.rawDataSize = 0;
@@ -5359,51 +6685,97 @@ static bool drflac__read_and_decode_metadata(
       if (blockSize < 32) { return DRFLAC_FALSE; }
 
       if (onMeta) {
-        void* pRawData;
-        const char* pRunningData;
-        const char* pRunningDataEnd;
+        /*
+        Everything is loaded with a single allocation so that this works with
+        drflac_open_preallocated(). When the picture data might be seeked over
+        the allocation only needs to cover the fields in front of it, but that
+        depends on the length of the description which comes after the MIME
+        type. The MIME type is therefore read onto the stack first. Unusually
+        long ones just load the whole block.
+        */
+        uint32_t header[2];
+        uint8_t fields[8 + 128 + 4];
+        uint32_t fieldsSize;
+        uint32_t allocationSize;
+        uint32_t descriptionLengthBE;
+        uint8_t* pRawData;
+        uint32_t rawDataSize;
+        const uint8_t* pRunningData;
+        bool isPictureDataLazy;
+
+        if (onRead(pUserData, header, 8) != 8) { return DRFLAC_FALSE; }
+        metadata.data.picture.type = drflac__be2host_32(header[0]);
+        metadata.data.picture.mimeLength = drflac__be2host_32(header[1]);
+        if (blockSize - 32 < metadata.data.picture.mimeLength) { return DRFLAC_FALSE; }
+
+        DRFLAC_COPY_MEMORY(fields, header, 8);
+        fieldsSize = 8;
+        allocationSize = blockSize;
+        if (blockSize - 32 - metadata.data.picture.mimeLength >= lazyPictureDataSize &&
+            metadata.data.picture.mimeLength <= sizeof(fields) - 12) {
+          uint32_t fixedSize;
+
+          if (onRead(pUserData, fields + 8, metadata.data.picture.mimeLength + 4) !=
+              metadata.data.picture.mimeLength + 4) {
+            return DRFLAC_FALSE;
+          }
+          fieldsSize += metadata.data.picture.mimeLength + 4;
 
-        pRawData = drflac__malloc_from_callbacks(blockSize, pAllocationCallbacks);
+          DRFLAC_COPY_MEMORY(&descriptionLengthBE, fields + fieldsSize - 4, 4);
+          metadata.data.picture.descriptionLength = drflac__be2host_32(descriptionLengthBE);
+          if (blockSize - fieldsSize - 20 < metadata.data.picture.descriptionLength) {
+            return DRFLAC_FALSE;
+          }
+
+          fixedSize = fieldsSize + metadata.data.picture.descriptionLength + 20;
+          if (blockSize - fixedSize >= lazyPictureDataSize) { allocationSize = fixedSize; }
+        }
+
+        pRawData = (uint8_t*)drflac__malloc_from_callbacks(allocationSize, pAllocationCallbacks);
         if (pRawData == NULL) { return DRFLAC_FALSE; }
 
-        if (onRead(pUserData, pRawData, blockSize) != blockSize) {
+        DRFLAC_COPY_MEMORY(pRawData, fields, fieldsSize);
+        if (onRead(pUserData, pRawData + fieldsSize, allocationSize - fieldsSize) !=
+            allocationSize - fieldsSize) {
           drflac__free_from_callbacks(pRawData, pAllocationCallbacks);
           return DRFLAC_FALSE;
         }
 
-        metadata.pRawData = pRawData;
-        metadata.rawDataSize = blockSize;
-
-        pRunningData = (const char*)pRawData;
-        pRunningDataEnd = (const char*)pRawData + blockSize;
-
-        metadata.data.picture.type = drflac__be2host_32(*(const uint32_t*)pRunningData);
-        pRunningData += 4;
-        metadata.data.picture.mimeLength = drflac__be2host_32(*(const uint32_t*)pRunningData);
-        pRunningData += 4;
-
-        /* Need space for the rest of the block */
-        if ((pRunningDataEnd - pRunningData) - 24 <
-            (int64_t)metadata.data.picture.mimeLength) { /* <-- Note the order of operations to
-                                                                 avoid overflow to a valid value */
+        rawDataSize = 8 + metadata.data.picture.mimeLength + 4;
+        metadata.data.picture.descriptionLength =
+            drflac__be2host_32(*(const uint32_t*)(pRawData + rawDataSize - 4));
+        if (blockSize - rawDataSize - 20 < metadata.data.picture.descriptionLength) {
           drflac__free_from_callbacks(pRawData, pAllocationCallbacks);
           return DRFLAC_FALSE;
         }
-        metadata.data.picture.mime = pRunningData;
-        pRunningData += metadata.data.picture.mimeLength;
-        metadata.data.picture.descriptionLength =
-            drflac__be2host_32(*(const uint32_t*)pRunningData);
-        pRunningData += 4;
+        rawDataSize += metadata.data.picture.descriptionLength + 20;
 
-        /* Need space for the rest of the block */
-        if ((pRunningDataEnd - pRunningData) - 20 <
-            (int64_t)
-                metadata.data.picture.descriptionLength) { /* <-- Note the order of operations to
-                                                              avoid overflow to a valid value */
+        metadata.data.picture.pictureDataSize =
+            drflac__be2host_32(*(const uint32_t*)(pRawData + rawDataSize - 4));
+        metadata.data.picture.pictureDataOffset =
+            isOffsetInStream ? runningFilePos + rawDataSize : 0;
+
+        /* Need space for the picture after the fields. */
+        if (blockSize - rawDataSize < metadata.data.picture.pictureDataSize) {
           drflac__free_from_callbacks(pRawData, pAllocationCallbacks);
           return DRFLAC_FALSE;
         }
-        metadata.data.picture.description = pRunningData;
+
+        /* A whole block that was loaded because of a long MIME type is still
+         * reported the same way. */
+        isPictureDataLazy = allocationSize < blockSize ||
+                            metadata.data.picture.pictureDataSize >= lazyPictureDataSize;
+        if (allocationSize < blockSize) {
+          if (!onSeek(pUserData, (int)(blockSize - allocationSize), drflac_seek_origin_current)) {
+            drflac__free_from_callbacks(pRawData, pAllocationCallbacks);
+            return DRFLAC_FALSE;
+          }
+        }
+
+        pRunningData = pRawData + 8;
+        metadata.data.picture.mime = (const char*)pRunningData;
+        pRunningData += metadata.data.picture.mimeLength + 4;
+        metadata.data.picture.description = (const char*)pRunningData;
         pRunningData += metadata.data.picture.descriptionLength;
         metadata.data.picture.width = drflac__be2host_32(*(const uint32_t*)pRunningData);
         pRunningData += 4;
@@ -5413,21 +6785,11 @@ static bool drflac__read_and_decode_metadata(
         pRunningData += 4;
         metadata.data.picture.indexColorCount =
             drflac__be2host_32(*(const uint32_t*)pRunningData);
-        pRunningData += 4;
-        metadata.data.picture.pictureDataSize =
-            drflac__be2host_32(*(const uint32_t*)pRunningData);
-        pRunningData += 4;
-        metadata.data.picture.pPictureData = (const uint8_t*)pRunningData;
-
-        /* Need space for the picture after the block */
-        if (pRunningDataEnd - pRunningData <
-            (int64_t)
-                metadata.data.picture.pictureDataSize) { /* <-- Note the order of operations to
-                                                            avoid overflow to a valid value */
-          drflac__free_from_callbacks(pRawData, pAllocationCallbacks);
-          return DRFLAC_FALSE;
-        }
+        pRunningData += 8;
+        metadata.data.picture.pPictureData = isPictureDataLazy ? NULL : pRunningData;
 
+        metadata.pRawData = pRawData;
+        metadata.rawDataSize = isPictureDataLazy ? rawDataSize : blockSize;
         onMeta(pUserDataMD, &metadata);
 
         drflac__free_from_callbacks(pRawData, pAllocationCallbacks);
@@ -5565,6 +6927,7 @@ static bool drflac__init_private__native(drflac_init_info* pInit, drflac_read_pr
     pInit->channels = streaminfo.channels;
     pInit->bitsPerSample = streaminfo.bitsPerSample;
     pInit->totalPCMFrameCount = streaminfo.totalPCMFrameCount;
+    DRFLAC_COPY_MEMORY(pInit->md5, streaminfo.md5, sizeof(pInit->md5));
     pInit->maxBlockSizeInPCMFrames =
         streaminfo.maxBlockSizeInPCMFrames; /* Don't care about the min block size -
                                                only the max (used for determining the
@@ -5587,6 +6950,8 @@ static bool drflac__init_private__native(drflac_init_info* pInit, drflac_read_pr
 #ifndef DR_FLAC_NO_OGG
 #define DRFLAC_OGG_MAX_PAGE_SIZE 65307
 #define DRFLAC_OGG_CAPTURE_PATTERN_CRC32 1605413199 /* CRC-32 of "OggS". */
+#define DRFLAC_OGG_NO_GRANULE_POSITION                                                             \
+  ((uint64_t)0xFFFFFFFFFFFFFFFF) /* For pages that don't complete a packet. */
 
 typedef enum {
   drflac_ogg_recover_on_crc_mismatch,
@@ -5632,6 +6997,268 @@ static uint32_t drflac__crc32_table[] = {
     0xF9278673L, 0xFDE69BC4L, 0x89B8FD09L, 0x8D79E0BEL, 0x803AC667L, 0x84FBDBD0L, 0x9ABC8BD5L,
     0x9E7D9662L, 0x933EB0BBL, 0x97FFAD0CL, 0xAFB010B1L, 0xAB710D06L, 0xA6322BDFL, 0xA2F33668L,
     0xBCB4666DL, 0xB8757BDAL, 0xB5365D03L, 0xB1F740B4L};
+
+/* drflac__crc32_slice_tables[n][b] is the CRC of the byte b followed by n+1 zero bytes. */
+static uint32_t drflac__crc32_slice_tables[7][256] = {
+    {0x00000000L, 0xD219C1DCL, 0xA0F29E0FL, 0x72EB5FD3L, 0x452421A9L, 0x973DE075L, 0xE5D6BFA6L,
+     0x37CF7E7AL, 0x8A484352L, 0x5851828EL, 0x2ABADD5DL, 0xF8A31C81L, 0xCF6C62FBL, 0x1D75A327L,
+     0x6F9EFCF4L, 0xBD873D28L, 0x10519B13L, 0xC2485ACFL, 0xB0A3051CL, 0x62BAC4C0L, 0x5575BABAL,
+     0x876C7B66L, 0xF58724B5L, 0x279EE569L, 0x9A19D841L, 0x4800199DL, 0x3AEB464EL, 0xE8F28792L,
+     0xDF3DF9E8L, 0x0D243834L, 0x7FCF67E7L, 0xADD6A63BL, 0x20A33626L, 0xF2BAF7FAL, 0x8051A829L,
+     0x524869F5L, 0x6587178FL, 0xB79ED653L, 0xC5758980L, 0x176C485CL, 0xAAEB7574L, 0x78F2B4A8L,
+     0x0A19EB7BL, 0xD8002AA7L, 0xEFCF54DDL, 0x3DD69501L, 0x4F3DCAD2L, 0x9D240B0EL, 0x30F2AD35L,
+     0xE2EB6CE9L, 0x9000333AL, 0x4219F2E6L, 0x75D68C9CL, 0xA7CF4D40L, 0xD5241293L, 0x073DD34FL,
+     0xBABAEE67L, 0x68A32FBBL, 0x1A487068L, 0xC851B1B4L, 0xFF9ECFCEL, 0x2D870E12L, 0x5F6C51C1L,
+     0x8D75901DL, 0x41466C4CL, 0x935FAD90L, 0xE1B4F243L, 0x33AD339FL, 0x04624DE5L, 0xD67B8C39L,
+     0xA490D3EAL, 0x76891236L, 0xCB0E2F1EL, 0x1917EEC2L, 0x6BFCB111L, 0xB9E570CDL, 0x8E2A0EB7L,
+     0x5C33CF6BL, 0x2ED890B8L, 0xFCC15164L, 0x5117F75FL, 0x830E3683L, 0xF1E56950L, 0x23FCA88CL,
+     0x1433D6F6L, 0xC62A172AL, 0xB4C148F9L, 0x66D88925L, 0xDB5FB40DL, 0x094675D1L, 0x7BAD2A02L,
+     0xA9B4EBDEL, 0x9E7B95A4L, 0x4C625478L, 0x3E890BABL, 0xEC90CA77L, 0x61E55A6AL, 0xB3FC9BB6L,
+     0xC117C465L, 0x130E05B9L, 0x24C17BC3L, 0xF6D8BA1FL, 0x8433E5CCL, 0x562A2410L, 0xEBAD1938L,
+     0x39B4D8E4L, 0x4B5F8737L, 0x994646EBL, 0xAE893891L, 0x7C90F94DL, 0x0E7BA69EL, 0xDC626742L,
+     0x71B4C179L, 0xA3AD00A5L, 0xD1465F76L, 0x035F9EAAL, 0x3490E0D0L, 0xE689210CL, 0x94627EDFL,
+     0x467BBF03L, 0xFBFC822BL, 0x29E543F7L, 0x5B0E1C24L, 0x8917DDF8L, 0xBED8A382L, 0x6CC1625EL,
+     0x1E2A3D8DL, 0xCC33FC51L, 0x828CD898L, 0x50951944L, 0x227E4697L, 0xF067874BL, 0xC7A8F931L,
+     0x15B138EDL, 0x675A673EL, 0xB543A6E2L, 0x08C49BCAL, 0xDADD5A16L, 0xA83605C5L, 0x7A2FC419L,
+     0x4DE0BA63L, 0x9FF97BBFL, 0xED12246CL, 0x3F0BE5B0L, 0x92DD438BL, 0x40C48257L, 0x322FDD84L,
+     0xE0361C58L, 0xD7F96222L, 0x05E0A3FEL, 0x770BFC2DL, 0xA5123DF1L, 0x189500D9L, 0xCA8CC105L,
+     0xB8679ED6L, 0x6A7E5F0AL, 0x5DB12170L, 0x8FA8E0ACL, 0xFD43BF7FL, 0x2F5A7EA3L, 0xA22FEEBEL,
+     0x70362F62L, 0x02DD70B1L, 0xD0C4B16DL, 0xE70BCF17L, 0x35120ECBL, 0x47F95118L, 0x95E090C4L,
+     0x2867ADECL, 0xFA7E6C30L, 0x889533E3L, 0x5A8CF23FL, 0x6D438C45L, 0xBF5A4D99L, 0xCDB1124AL,
+     0x1FA8D396L, 0xB27E75ADL, 0x6067B471L, 0x128CEBA2L, 0xC0952A7EL, 0xF75A5404L, 0x254395D8L,
+     0x57A8CA0BL, 0x85B10BD7L, 0x383636FFL, 0xEA2FF723L, 0x98C4A8F0L, 0x4ADD692CL, 0x7D121756L,
+     0xAF0BD68AL, 0xDDE08959L, 0x0FF94885L, 0xC3CAB4D4L, 0x11D37508L, 0x63382ADBL, 0xB121EB07L,
+     0x86EE957DL, 0x54F754A1L, 0x261C0B72L, 0xF405CAAEL, 0x4982F786L, 0x9B9B365AL, 0xE9706989L,
+     0x3B69A855L, 0x0CA6D62FL, 0xDEBF17F3L, 0xAC544820L, 0x7E4D89FCL, 0xD39B2FC7L, 0x0182EE1BL,
+     0x7369B1C8L, 0xA1707014L, 0x96BF0E6EL, 0x44A6CFB2L, 0x364D9061L, 0xE45451BDL, 0x59D36C95L,
+     0x8BCAAD49L, 0xF921F29AL, 0x2B383346L, 0x1CF74D3CL, 0xCEEE8CE0L, 0xBC05D333L, 0x6E1C12EFL,
+     0xE36982F2L, 0x3170432EL, 0x439B1CFDL, 0x9182DD21L, 0xA64DA35BL, 0x74546287L, 0x06BF3D54L,
+     0xD4A6FC88L, 0x6921C1A0L, 0xBB38007CL, 0xC9D35FAFL, 0x1BCA9E73L, 0x2C05E009L, 0xFE1C21D5L,
+     0x8CF77E06L, 0x5EEEBFDAL, 0xF33819E1L, 0x2121D83DL, 0x53CA87EEL, 0x81D34632L, 0xB61C3848L,
+     0x6405F994L, 0x16EEA647L, 0xC4F7679BL, 0x79705AB3L, 0xAB699B6FL, 0xD982C4BCL, 0x0B9B0560L,
+     0x3C547B1AL, 0xEE4DBAC6L, 0x9CA6E515L, 0x4EBF24C9L},
+    {0x00000000L, 0x01D8AC87L, 0x03B1590EL, 0x0269F589L, 0x0762B21CL, 0x06BA1E9BL, 0x04D3EB12L,
+     0x050B4795L, 0x0EC56438L, 0x0F1DC8BFL, 0x0D743D36L, 0x0CAC91B1L, 0x09A7D624L, 0x087F7AA3L,
+     0x0A168F2AL, 0x0BCE23ADL, 0x1D8AC870L, 0x1C5264F7L, 0x1E3B917EL, 0x1FE33DF9L, 0x1AE87A6CL,
+     0x1B30D6EBL, 0x19592362L, 0x18818FE5L, 0x134FAC48L, 0x129700CFL, 0x10FEF546L, 0x112659C1L,
+     0x142D1E54L, 0x15F5B2D3L, 0x179C475AL, 0x1644EBDDL, 0x3B1590E0L, 0x3ACD3C67L, 0x38A4C9EEL,
+     0x397C6569L, 0x3C7722FCL, 0x3DAF8E7BL, 0x3FC67BF2L, 0x3E1ED775L, 0x35D0F4D8L, 0x3408585FL,
+     0x3661ADD6L, 0x37B90151L, 0x32B246C4L, 0x336AEA43L, 0x31031FCAL, 0x30DBB34DL, 0x269F5890L,
+     0x2747F417L, 0x252E019EL, 0x24F6AD19L, 0x21FDEA8CL, 0x2025460BL, 0x224CB382L, 0x23941F05L,
+     0x285A3CA8L, 0x2982902FL, 0x2BEB65A6L, 0x2A33C921L, 0x2F388EB4L, 0x2EE02233L, 0x2C89D7BAL,
+     0x2D517B3DL, 0x762B21C0L, 0x77F38D47L, 0x759A78CEL, 0x7442D449L, 0x714993DCL, 0x70913F5BL,
+     0x72F8CAD2L, 0x73206655L, 0x78EE45F8L, 0x7936E97FL, 0x7B5F1CF6L, 0x7A87B071L, 0x7F8CF7E4L,
+     0x7E545B63L, 0x7C3DAEEAL, 0x7DE5026DL, 0x6BA1E9B0L, 0x6A794537L, 0x6810B0BEL, 0x69C81C39L,
+     0x6CC35BACL, 0x6D1BF72BL, 0x6F7202A2L, 0x6EAAAE25L, 0x65648D88L, 0x64BC210FL, 0x66D5D486L,
+     0x670D7801L, 0x62063F94L, 0x63DE9313L, 0x61B7669AL, 0x606FCA1DL, 0x4D3EB120L, 0x4CE61DA7L,
+     0x4E8FE82EL, 0x4F5744A9L, 0x4A5C033CL, 0x4B84AFBBL, 0x49ED5A32L, 0x4835F6B5L, 0x43FBD518L,
+     0x4223799FL, 0x404A8C16L, 0x41922091L, 0x44996704L, 0x4541CB83L, 0x47283E0AL, 0x46F0928DL,
+     0x50B47950L, 0x516CD5D7L, 0x5305205EL, 0x52DD8CD9L, 0x57D6CB4CL, 0x560E67CBL, 0x54679242L,
+     0x55BF3EC5L, 0x5E711D68L, 0x5FA9B1EFL, 0x5DC04466L, 0x5C18E8E1L, 0x5913AF74L, 0x58CB03F3L,
+     0x5AA2F67AL, 0x5B7A5AFDL, 0xEC564380L, 0xED8EEF07L, 0xEFE71A8EL, 0xEE3FB609L, 0xEB34F19CL,
+     0xEAEC5D1BL, 0xE885A892L, 0xE95D0415L, 0xE29327B8L, 0xE34B8B3FL, 0xE1227EB6L, 0xE0FAD231L,
+     0xE5F195A4L, 0xE4293923L, 0xE640CCAAL, 0xE798602DL, 0xF1DC8BF0L, 0xF0042777L, 0xF26DD2FEL,
+     0xF3B57E79L, 0xF6BE39ECL, 0xF766956BL, 0xF50F60E2L, 0xF4D7CC65L, 0xFF19EFC8L, 0xFEC1434FL,
+     0xFCA8B6C6L, 0xFD701A41L, 0xF87B5DD4L, 0xF9A3F153L, 0xFBCA04DAL, 0xFA12A85DL, 0xD743D360L,
+     0xD69B7FE7L, 0xD4F28A6EL, 0xD52A26E9L, 0xD021617CL, 0xD1F9CDFBL, 0xD3903872L, 0xD24894F5L,
+     0xD986B758L, 0xD85E1BDFL, 0xDA37EE56L, 0xDBEF42D1L, 0xDEE40544L, 0xDF3CA9C3L, 0xDD555C4AL,
+     0xDC8DF0CDL, 0xCAC91B10L, 0xCB11B797L, 0xC978421EL, 0xC8A0EE99L, 0xCDABA90CL, 0xCC73058BL,
+     0xCE1AF002L, 0xCFC25C85L, 0xC40C7F28L, 0xC5D4D3AFL, 0xC7BD2626L, 0xC6658AA1L, 0xC36ECD34L,
+     0xC2B661B3L, 0xC0DF943AL, 0xC10738BDL, 0x9A7D6240L, 0x9BA5CEC7L, 0x99CC3B4EL, 0x981497C9L,
+     0x9D1FD05CL, 0x9CC77CDBL, 0x9EAE8952L, 0x9F7625D5L, 0x94B80678L, 0x9560AAFFL, 0x97095F76L,
+     0x96D1F3F1L, 0x93DAB464L, 0x920218E3L, 0x906BED6AL, 0x91B341EDL, 0x87F7AA30L, 0x862F06B7L,
+     0x8446F33EL, 0x859E5FB9L, 0x8095182CL, 0x814DB4ABL, 0x83244122L, 0x82FCEDA5L, 0x8932CE08L,
+     0x88EA628FL, 0x8A839706L, 0x8B5B3B81L, 0x8E507C14L, 0x8F88D093L, 0x8DE1251AL, 0x8C39899DL,
+     0xA168F2A0L, 0xA0B05E27L, 0xA2D9ABAEL, 0xA3010729L, 0xA60A40BCL, 0xA7D2EC3BL, 0xA5BB19B2L,
+     0xA463B535L, 0xAFAD9698L, 0xAE753A1FL, 0xAC1CCF96L, 0xADC46311L, 0xA8CF2484L, 0xA9178803L,
+     0xAB7E7D8AL, 0xAAA6D10DL, 0xBCE23AD0L, 0xBD3A9657L, 0xBF5363DEL, 0xBE8BCF59L, 0xBB8088CCL,
+     0xBA58244BL, 0xB831D1C2L, 0xB9E97D45L, 0xB2275EE8L, 0xB3FFF26FL, 0xB19607E6L, 0xB04EAB61L,
+     0xB545ECF4L, 0xB49D4073L, 0xB6F4B5FAL, 0xB72C197DL},
+    {0x00000000L, 0xDC6D9AB7L, 0xBC1A28D9L, 0x6077B26EL, 0x7CF54C05L, 0xA098D6B2L, 0xC0EF64DCL,
+     0x1C82FE6BL, 0xF9EA980AL, 0x258702BDL, 0x45F0B0D3L, 0x999D2A64L, 0x851FD40FL, 0x59724EB8L,
+     0x3905FCD6L, 0xE5686661L, 0xF7142DA3L, 0x2B79B714L, 0x4B0E057AL, 0x97639FCDL, 0x8BE161A6L,
+     0x578CFB11L, 0x37FB497FL, 0xEB96D3C8L, 0x0EFEB5A9L, 0xD2932F1EL, 0xB2E49D70L, 0x6E8907C7L,
+     0x720BF9ACL, 0xAE66631BL, 0xCE11D175L, 0x127C4BC2L, 0xEAE946F1L, 0x3684DC46L, 0x56F36E28L,
+     0x8A9EF49FL, 0x961C0AF4L, 0x4A719043L, 0x2A06222DL, 0xF66BB89AL, 0x1303DEFBL, 0xCF6E444CL,
+     0xAF19F622L, 0x73746C95L, 0x6FF692FEL, 0xB39B0849L, 0xD3ECBA27L, 0x0F812090L, 0x1DFD6B52L,
+     0xC190F1E5L, 0xA1E7438BL, 0x7D8AD93CL, 0x61082757L, 0xBD65BDE0L, 0xDD120F8EL, 0x017F9539L,
+     0xE417F358L, 0x387A69EFL, 0x580DDB81L, 0x84604136L, 0x98E2BF5DL, 0x448F25EAL, 0x24F89784L,
+     0xF8950D33L, 0xD1139055L, 0x0D7E0AE2L, 0x6D09B88CL, 0xB164223BL, 0xADE6DC50L, 0x718B46E7L,
+     0x11FCF489L, 0xCD916E3EL, 0x28F9085FL, 0xF49492E8L, 0x94E32086L, 0x488EBA31L, 0x540C445AL,
+     0x8861DEEDL, 0xE8166C83L, 0x347BF634L, 0x2607BDF6L, 0xFA6A2741L, 0x9A1D952FL, 0x46700F98L,
+     0x5AF2F1F3L, 0x869F6B44L, 0xE6E8D92AL, 0x3A85439DL, 0xDFED25FCL, 0x0380BF4BL, 0x63F70D25L,
+     0xBF9A9792L, 0xA31869F9L, 0x7F75F34EL, 0x1F024120L, 0xC36FDB97L, 0x3BFAD6A4L, 0xE7974C13L,
+     0x87E0FE7DL, 0x5B8D64CAL, 0x470F9AA1L, 0x9B620016L, 0xFB15B278L, 0x277828CFL, 0xC2104EAEL,
+     0x1E7DD419L, 0x7E0A6677L, 0xA267FCC0L, 0xBEE502ABL, 0x6288981CL, 0x02FF2A72L, 0xDE92B0C5L,
+     0xCCEEFB07L, 0x108361B0L, 0x70F4D3DEL, 0xAC994969L, 0xB01BB702L, 0x6C762DB5L, 0x0C019FDBL,
+     0xD06C056CL, 0x3504630DL, 0xE969F9BAL, 0x891E4BD4L, 0x5573D163L, 0x49F12F08L, 0x959CB5BFL,
+     0xF5EB07D1L, 0x29869D66L, 0xA6E63D1DL, 0x7A8BA7AAL, 0x1AFC15C4L, 0xC6918F73L, 0xDA137118L,
+     0x067EEBAFL, 0x660959C1L, 0xBA64C376L, 0x5F0CA517L, 0x83613FA0L, 0xE3168DCEL, 0x3F7B1779L,
+     0x23F9E912L, 0xFF9473A5L, 0x9FE3C1CBL, 0x438E5B7CL, 0x51F210BEL, 0x8D9F8A09L, 0xEDE83867L,
+     0x3185A2D0L, 0x2D075CBBL, 0xF16AC60CL, 0x911D7462L, 0x4D70EED5L, 0xA81888B4L, 0x74751203L,
+     0x1402A06DL, 0xC86F3ADAL, 0xD4EDC4B1L, 0x08805E06L, 0x68F7EC68L, 0xB49A76DFL, 0x4C0F7BECL,
+     0x9062E15BL, 0xF0155335L, 0x2C78C982L, 0x30FA37E9L, 0xEC97AD5EL, 0x8CE01F30L, 0x508D8587L,
+     0xB5E5E3E6L, 0x69887951L, 0x09FFCB3FL, 0xD5925188L, 0xC910AFE3L, 0x157D3554L, 0x750A873AL,
+     0xA9671D8DL, 0xBB1B564FL, 0x6776CCF8L, 0x07017E96L, 0xDB6CE421L, 0xC7EE1A4AL, 0x1B8380FDL,
+     0x7BF43293L, 0xA799A824L, 0x42F1CE45L, 0x9E9C54F2L, 0xFEEBE69CL, 0x22867C2BL, 0x3E048240L,
+     0xE26918F7L, 0x821EAA99L, 0x5E73302EL, 0x77F5AD48L, 0xAB9837FFL, 0xCBEF8591L, 0x17821F26L,
+     0x0B00E14DL, 0xD76D7BFAL, 0xB71AC994L, 0x6B775323L, 0x8E1F3542L, 0x5272AFF5L, 0x32051D9BL,
+     0xEE68872CL, 0xF2EA7947L, 0x2E87E3F0L, 0x4EF0519EL, 0x929DCB29L, 0x80E180EBL, 0x5C8C1A5CL,
+     0x3CFBA832L, 0xE0963285L, 0xFC14CCEEL, 0x20795659L, 0x400EE437L, 0x9C637E80L, 0x790B18E1L,
+     0xA5668256L, 0xC5113038L, 0x197CAA8FL, 0x05FE54E4L, 0xD993CE53L, 0xB9E47C3DL, 0x6589E68AL,
+     0x9D1CEBB9L, 0x4171710EL, 0x2106C360L, 0xFD6B59D7L, 0xE1E9A7BCL, 0x3D843D0BL, 0x5DF38F65L,
+     0x819E15D2L, 0x64F673B3L, 0xB89BE904L, 0xD8EC5B6AL, 0x0481C1DDL, 0x18033FB6L, 0xC46EA501L,
+     0xA419176FL, 0x78748DD8L, 0x6A08C61AL, 0xB6655CADL, 0xD612EEC3L, 0x0A7F7474L, 0x16FD8A1FL,
+     0xCA9010A8L, 0xAAE7A2C6L, 0x768A3871L, 0x93E25E10L, 0x4F8FC4A7L, 0x2FF876C9L, 0xF395EC7EL,
+     0xEF171215L, 0x337A88A2L, 0x530D3ACCL, 0x8F60A07BL},
+    {0x00000000L, 0x490D678DL, 0x921ACF1AL, 0xDB17A897L, 0x20F48383L, 0x69F9E40EL, 0xB2EE4C99L,
+     0xFBE32B14L, 0x41E90706L, 0x08E4608BL, 0xD3F3C81CL, 0x9AFEAF91L, 0x611D8485L, 0x2810E308L,
+     0xF3074B9FL, 0xBA0A2C12L, 0x83D20E0CL, 0xCADF6981L, 0x11C8C116L, 0x58C5A69BL, 0xA3268D8FL,
+     0xEA2BEA02L, 0x313C4295L, 0x78312518L, 0xC23B090AL, 0x8B366E87L, 0x5021C610L, 0x192CA19DL,
+     0xE2CF8A89L, 0xABC2ED04L, 0x70D54593L, 0x39D8221EL, 0x036501AFL, 0x4A686622L, 0x917FCEB5L,
+     0xD872A938L, 0x2391822CL, 0x6A9CE5A1L, 0xB18B4D36L, 0xF8862ABBL, 0x428C06A9L, 0x0B816124L,
+     0xD096C9B3L, 0x999BAE3EL, 0x6278852AL, 0x2B75E2A7L, 0xF0624A30L, 0xB96F2DBDL, 0x80B70FA3L,
+     0xC9BA682EL, 0x12ADC0B9L, 0x5BA0A734L, 0xA0438C20L, 0xE94EEBADL, 0x3259433AL, 0x7B5424B7L,
+     0xC15E08A5L, 0x88536F28L, 0x5344C7BFL, 0x1A49A032L, 0xE1AA8B26L, 0xA8A7ECABL, 0x73B0443CL,
+     0x3ABD23B1L, 0x06CA035EL, 0x4FC764D3L, 0x94D0CC44L, 0xDDDDABC9L, 0x263E80DDL, 0x6F33E750L,
+     0xB4244FC7L, 0xFD29284AL, 0x47230458L, 0x0E2E63D5L, 0xD539CB42L, 0x9C34ACCFL, 0x67D787DBL,
+     0x2EDAE056L, 0xF5CD48C1L, 0xBCC02F4CL, 0x85180D52L, 0xCC156ADFL, 0x1702C248L, 0x5E0FA5C5L,
+     0xA5EC8ED1L, 0xECE1E95CL, 0x37F641CBL, 0x7EFB2646L, 0xC4F10A54L, 0x8DFC6DD9L, 0x56EBC54EL,
+     0x1FE6A2C3L, 0xE40589D7L, 0xAD08EE5AL, 0x761F46CDL, 0x3F122140L, 0x05AF02F1L, 0x4CA2657CL,
+     0x97B5CDEBL, 0xDEB8AA66L, 0x255B8172L, 0x6C56E6FFL, 0xB7414E68L, 0xFE4C29E5L, 0x444605F7L,
+     0x0D4B627AL, 0xD65CCAEDL, 0x9F51AD60L, 0x64B28674L, 0x2DBFE1F9L, 0xF6A8496EL, 0xBFA52EE3L,
+     0x867D0CFDL, 0xCF706B70L, 0x1467C3E7L, 0x5D6AA46AL, 0xA6898F7EL, 0xEF84E8F3L, 0x34934064L,
+     0x7D9E27E9L, 0xC7940BFBL, 0x8E996C76L, 0x558EC4E1L, 0x1C83A36CL, 0xE7608878L, 0xAE6DEFF5L,
+     0x757A4762L, 0x3C7720EFL, 0x0D9406BCL, 0x44996131L, 0x9F8EC9A6L, 0xD683AE2BL, 0x2D60853FL,
+     0x646DE2B2L, 0xBF7A4A25L, 0xF6772DA8L, 0x4C7D01BAL, 0x05706637L, 0xDE67CEA0L, 0x976AA92DL,
+     0x6C898239L, 0x2584E5B4L, 0xFE934D23L, 0xB79E2AAEL, 0x8E4608B0L, 0xC74B6F3DL, 0x1C5CC7AAL,
+     0x5551A027L, 0xAEB28B33L, 0xE7BFECBEL, 0x3CA84429L, 0x75A523A4L, 0xCFAF0FB6L, 0x86A2683BL,
+     0x5DB5C0ACL, 0x14B8A721L, 0xEF5B8C35L, 0xA656EBB8L, 0x7D41432FL, 0x344C24A2L, 0x0EF10713L,
+     0x47FC609EL, 0x9CEBC809L, 0xD5E6AF84L, 0x2E058490L, 0x6708E31DL, 0xBC1F4B8AL, 0xF5122C07L,
+     0x4F180015L, 0x06156798L, 0xDD02CF0FL, 0x940FA882L, 0x6FEC8396L, 0x26E1E41BL, 0xFDF64C8CL,
+     0xB4FB2B01L, 0x8D23091FL, 0xC42E6E92L, 0x1F39C605L, 0x5634A188L, 0xADD78A9CL, 0xE4DAED11L,
+     0x3FCD4586L, 0x76C0220BL, 0xCCCA0E19L, 0x85C76994L, 0x5ED0C103L, 0x17DDA68EL, 0xEC3E8D9AL,
+     0xA533EA17L, 0x7E244280L, 0x3729250DL, 0x0B5E05E2L, 0x4253626FL, 0x9944CAF8L, 0xD049AD75L,
+     0x2BAA8661L, 0x62A7E1ECL, 0xB9B0497BL, 0xF0BD2EF6L, 0x4AB702E4L, 0x03BA6569L, 0xD8ADCDFEL,
+     0x91A0AA73L, 0x6A438167L, 0x234EE6EAL, 0xF8594E7DL, 0xB15429F0L, 0x888C0BEEL, 0xC1816C63L,
+     0x1A96C4F4L, 0x539BA379L, 0xA878886DL, 0xE175EFE0L, 0x3A624777L, 0x736F20FAL, 0xC9650CE8L,
+     0x80686B65L, 0x5B7FC3F2L, 0x1272A47FL, 0xE9918F6BL, 0xA09CE8E6L, 0x7B8B4071L, 0x328627FCL,
+     0x083B044DL, 0x413663C0L, 0x9A21CB57L, 0xD32CACDAL, 0x28CF87CEL, 0x61C2E043L, 0xBAD548D4L,
+     0xF3D82F59L, 0x49D2034BL, 0x00DF64C6L, 0xDBC8CC51L, 0x92C5ABDCL, 0x692680C8L, 0x202BE745L,
+     0xFB3C4FD2L, 0xB231285FL, 0x8BE90A41L, 0xC2E46DCCL, 0x19F3C55BL, 0x50FEA2D6L, 0xAB1D89C2L,
+     0xE210EE4FL, 0x390746D8L, 0x700A2155L, 0xCA000D47L, 0x830D6ACAL, 0x581AC25DL, 0x1117A5D0L,
+     0xEAF48EC4L, 0xA3F9E949L, 0x78EE41DEL, 0x31E32653L},
+    {0x00000000L, 0x1B280D78L, 0x36501AF0L, 0x2D781788L, 0x6CA035E0L, 0x77883898L, 0x5AF02F10L,
+     0x41D82268L, 0xD9406BC0L, 0xC26866B8L, 0xEF107130L, 0xF4387C48L, 0xB5E05E20L, 0xAEC85358L,
+     0x83B044D0L, 0x989849A8L, 0xB641CA37L, 0xAD69C74FL, 0x8011D0C7L, 0x9B39DDBFL, 0xDAE1FFD7L,
+     0xC1C9F2AFL, 0xECB1E527L, 0xF799E85FL, 0x6F01A1F7L, 0x7429AC8FL, 0x5951BB07L, 0x4279B67FL,
+     0x03A19417L, 0x1889996FL, 0x35F18EE7L, 0x2ED9839FL, 0x684289D9L, 0x736A84A1L, 0x5E129329L,
+     0x453A9E51L, 0x04E2BC39L, 0x1FCAB141L, 0x32B2A6C9L, 0x299AABB1L, 0xB102E219L, 0xAA2AEF61L,
+     0x8752F8E9L, 0x9C7AF591L, 0xDDA2D7F9L, 0xC68ADA81L, 0xEBF2CD09L, 0xF0DAC071L, 0xDE0343EEL,
+     0xC52B4E96L, 0xE853591EL, 0xF37B5466L, 0xB2A3760EL, 0xA98B7B76L, 0x84F36CFEL, 0x9FDB6186L,
+     0x0743282EL, 0x1C6B2556L, 0x311332DEL, 0x2A3B3FA6L, 0x6BE31DCEL, 0x70CB10B6L, 0x5DB3073EL,
+     0x469B0A46L, 0xD08513B2L, 0xCBAD1ECAL, 0xE6D50942L, 0xFDFD043AL, 0xBC252652L, 0xA70D2B2AL,
+     0x8A753CA2L, 0x915D31DAL, 0x09C57872L, 0x12ED750AL, 0x3F956282L, 0x24BD6FFAL, 0x65654D92L,
+     0x7E4D40EAL, 0x53355762L, 0x481D5A1AL, 0x66C4D985L, 0x7DECD4FDL, 0x5094C375L, 0x4BBCCE0DL,
+     0x0A64EC65L, 0x114CE11DL, 0x3C34F695L, 0x271CFBEDL, 0xBF84B245L, 0xA4ACBF3DL, 0x89D4A8B5L,
+     0x92FCA5CDL, 0xD32487A5L, 0xC80C8ADDL, 0xE5749D55L, 0xFE5C902DL, 0xB8C79A6BL, 0xA3EF9713L,
+     0x8E97809BL, 0x95BF8DE3L, 0xD467AF8BL, 0xCF4FA2F3L, 0xE237B57BL, 0xF91FB803L, 0x6187F1ABL,
+     0x7AAFFCD3L, 0x57D7EB5BL, 0x4CFFE623L, 0x0D27C44BL, 0x160FC933L, 0x3B77DEBBL, 0x205FD3C3L,
+     0x0E86505CL, 0x15AE5D24L, 0x38D64AACL, 0x23FE47D4L, 0x622665BCL, 0x790E68C4L, 0x54767F4CL,
+     0x4F5E7234L, 0xD7C63B9CL, 0xCCEE36E4L, 0xE196216CL, 0xFABE2C14L, 0xBB660E7CL, 0xA04E0304L,
+     0x8D36148CL, 0x961E19F4L, 0xA5CB3AD3L, 0xBEE337ABL, 0x939B2023L, 0x88B32D5BL, 0xC96B0F33L,
+     0xD243024BL, 0xFF3B15C3L, 0xE41318BBL, 0x7C8B5113L, 0x67A35C6BL, 0x4ADB4BE3L, 0x51F3469BL,
+     0x102B64F3L, 0x0B03698BL, 0x267B7E03L, 0x3D53737BL, 0x138AF0E4L, 0x08A2FD9CL, 0x25DAEA14L,
+     0x3EF2E76CL, 0x7F2AC504L, 0x6402C87CL, 0x497ADFF4L, 0x5252D28CL, 0xCACA9B24L, 0xD1E2965CL,
+     0xFC9A81D4L, 0xE7B28CACL, 0xA66AAEC4L, 0xBD42A3BCL, 0x903AB434L, 0x8B12B94CL, 0xCD89B30AL,
+     0xD6A1BE72L, 0xFBD9A9FAL, 0xE0F1A482L, 0xA12986EAL, 0xBA018B92L, 0x97799C1AL, 0x8C519162L,
+     0x14C9D8CAL, 0x0FE1D5B2L, 0x2299C23AL, 0x39B1CF42L, 0x7869ED2AL, 0x6341E052L, 0x4E39F7DAL,
+     0x5511FAA2L, 0x7BC8793DL, 0x60E07445L, 0x4D9863CDL, 0x56B06EB5L, 0x17684CDDL, 0x0C4041A5L,
+     0x2138562DL, 0x3A105B55L, 0xA28812FDL, 0xB9A01F85L, 0x94D8080DL, 0x8FF00575L, 0xCE28271DL,
+     0xD5002A65L, 0xF8783DEDL, 0xE3503095L, 0x754E2961L, 0x6E662419L, 0x431E3391L, 0x58363EE9L,
+     0x19EE1C81L, 0x02C611F9L, 0x2FBE0671L, 0x34960B09L, 0xAC0E42A1L, 0xB7264FD9L, 0x9A5E5851L,
+     0x81765529L, 0xC0AE7741L, 0xDB867A39L, 0xF6FE6DB1L, 0xEDD660C9L, 0xC30FE356L, 0xD827EE2EL,
+     0xF55FF9A6L, 0xEE77F4DEL, 0xAFAFD6B6L, 0xB487DBCEL, 0x99FFCC46L, 0x82D7C13EL, 0x1A4F8896L,
+     0x016785EEL, 0x2C1F9266L, 0x37379F1EL, 0x76EFBD76L, 0x6DC7B00EL, 0x40BFA786L, 0x5B97AAFEL,
+     0x1D0CA0B8L, 0x0624ADC0L, 0x2B5CBA48L, 0x3074B730L, 0x71AC9558L, 0x6A849820L, 0x47FC8FA8L,
+     0x5CD482D0L, 0xC44CCB78L, 0xDF64C600L, 0xF21CD188L, 0xE934DCF0L, 0xA8ECFE98L, 0xB3C4F3E0L,
+     0x9EBCE468L, 0x8594E910L, 0xAB4D6A8FL, 0xB06567F7L, 0x9D1D707FL, 0x86357D07L, 0xC7ED5F6FL,
+     0xDCC55217L, 0xF1BD459FL, 0xEA9548E7L, 0x720D014FL, 0x69250C37L, 0x445D1BBFL, 0x5F7516C7L,
+     0x1EAD34AFL, 0x058539D7L, 0x28FD2E5FL, 0x33D52327L},
+    {0x00000000L, 0x4F576811L, 0x9EAED022L, 0xD1F9B833L, 0x399CBDF3L, 0x76CBD5E2L, 0xA7326DD1L,
+     0xE86505C0L, 0x73397BE6L, 0x3C6E13F7L, 0xED97ABC4L, 0xA2C0C3D5L, 0x4AA5C615L, 0x05F2AE04L,
+     0xD40B1637L, 0x9B5C7E26L, 0xE672F7CCL, 0xA9259FDDL, 0x78DC27EEL, 0x378B4FFFL, 0xDFEE4A3FL,
+     0x90B9222EL, 0x41409A1DL, 0x0E17F20CL, 0x954B8C2AL, 0xDA1CE43BL, 0x0BE55C08L, 0x44B23419L,
+     0xACD731D9L, 0xE38059C8L, 0x3279E1FBL, 0x7D2E89EAL, 0xC824F22FL, 0x87739A3EL, 0x568A220DL,
+     0x19DD4A1CL, 0xF1B84FDCL, 0xBEEF27CDL, 0x6F169FFEL, 0x2041F7EFL, 0xBB1D89C9L, 0xF44AE1D8L,
+     0x25B359EBL, 0x6AE431FAL, 0x8281343AL, 0xCDD65C2BL, 0x1C2FE418L, 0x53788C09L, 0x2E5605E3L,
+     0x61016DF2L, 0xB0F8D5C1L, 0xFFAFBDD0L, 0x17CAB810L, 0x589DD001L, 0x89646832L, 0xC6330023L,
+     0x5D6F7E05L, 0x12381614L, 0xC3C1AE27L, 0x8C96C636L, 0x64F3C3F6L, 0x2BA4ABE7L, 0xFA5D13D4L,
+     0xB50A7BC5L, 0x9488F9E9L, 0xDBDF91F8L, 0x0A2629CBL, 0x457141DAL, 0xAD14441AL, 0xE2432C0BL,
+     0x33BA9438L, 0x7CEDFC29L, 0xE7B1820FL, 0xA8E6EA1EL, 0x791F522DL, 0x36483A3CL, 0xDE2D3FFCL,
+     0x917A57EDL, 0x4083EFDEL, 0x0FD487CFL, 0x72FA0E25L, 0x3DAD6634L, 0xEC54DE07L, 0xA303B616L,
+     0x4B66B3D6L, 0x0431DBC7L, 0xD5C863F4L, 0x9A9F0BE5L, 0x01C375C3L, 0x4E941DD2L, 0x9F6DA5E1L,
+     0xD03ACDF0L, 0x385FC830L, 0x7708A021L, 0xA6F11812L, 0xE9A67003L, 0x5CAC0BC6L, 0x13FB63D7L,
+     0xC202DBE4L, 0x8D55B3F5L, 0x6530B635L, 0x2A67DE24L, 0xFB9E6617L, 0xB4C90E06L, 0x2F957020L,
+     0x60C21831L, 0xB13BA002L, 0xFE6CC813L, 0x1609CDD3L, 0x595EA5C2L, 0x88A71DF1L, 0xC7F075E0L,
+     0xBADEFC0AL, 0xF589941BL, 0x24702C28L, 0x6B274439L, 0x834241F9L, 0xCC1529E8L, 0x1DEC91DBL,
+     0x52BBF9CAL, 0xC9E787ECL, 0x86B0EFFDL, 0x574957CEL, 0x181E3FDFL, 0xF07B3A1FL, 0xBF2C520EL,
+     0x6ED5EA3DL, 0x2182822CL, 0x2DD0EE65L, 0x62878674L, 0xB37E3E47L, 0xFC295656L, 0x144C5396L,
+     0x5B1B3B87L, 0x8AE283B4L, 0xC5B5EBA5L, 0x5EE99583L, 0x11BEFD92L, 0xC04745A1L, 0x8F102DB0L,
+     0x67752870L, 0x28224061L, 0xF9DBF852L, 0xB68C9043L, 0xCBA219A9L, 0x84F571B8L, 0x550CC98BL,
+     0x1A5BA19AL, 0xF23EA45AL, 0xBD69CC4BL, 0x6C907478L, 0x23C71C69L, 0xB89B624FL, 0xF7CC0A5EL,
+     0x2635B26DL, 0x6962DA7CL, 0x8107DFBCL, 0xCE50B7ADL, 0x1FA90F9EL, 0x50FE678FL, 0xE5F41C4AL,
+     0xAAA3745BL, 0x7B5ACC68L, 0x340DA479L, 0xDC68A1B9L, 0x933FC9A8L, 0x42C6719BL, 0x0D91198AL,
+     0x96CD67ACL, 0xD99A0FBDL, 0x0863B78EL, 0x4734DF9FL, 0xAF51DA5FL, 0xE006B24EL, 0x31FF0A7DL,
+     0x7EA8626CL, 0x0386EB86L, 0x4CD18397L, 0x9D283BA4L, 0xD27F53B5L, 0x3A1A5675L, 0x754D3E64L,
+     0xA4B48657L, 0xEBE3EE46L, 0x70BF9060L, 0x3FE8F871L, 0xEE114042L, 0xA1462853L, 0x49232D93L,
+     0x06744582L, 0xD78DFDB1L, 0x98DA95A0L, 0xB958178CL, 0xF60F7F9DL, 0x27F6C7AEL, 0x68A1AFBFL,
+     0x80C4AA7FL, 0xCF93C26EL, 0x1E6A7A5DL, 0x513D124CL, 0xCA616C6AL, 0x8536047BL, 0x54CFBC48L,
+     0x1B98D459L, 0xF3FDD199L, 0xBCAAB988L, 0x6D5301BBL, 0x220469AAL, 0x5F2AE040L, 0x107D8851L,
+     0xC1843062L, 0x8ED35873L, 0x66B65DB3L, 0x29E135A2L, 0xF8188D91L, 0xB74FE580L, 0x2C139BA6L,
+     0x6344F3B7L, 0xB2BD4B84L, 0xFDEA2395L, 0x158F2655L, 0x5AD84E44L, 0x8B21F677L, 0xC4769E66L,
+     0x717CE5A3L, 0x3E2B8DB2L, 0xEFD23581L, 0xA0855D90L, 0x48E05850L, 0x07B73041L, 0xD64E8872L,
+     0x9919E063L, 0x02459E45L, 0x4D12F654L, 0x9CEB4E67L, 0xD3BC2676L, 0x3BD923B6L, 0x748E4BA7L,
+     0xA577F394L, 0xEA209B85L, 0x970E126FL, 0xD8597A7EL, 0x09A0C24DL, 0x46F7AA5CL, 0xAE92AF9CL,
+     0xE1C5C78DL, 0x303C7FBEL, 0x7F6B17AFL, 0xE4376989L, 0xAB600198L, 0x7A99B9ABL, 0x35CED1BAL,
+     0xDDABD47AL, 0x92FCBC6BL, 0x43050458L, 0x0C526C49L},
+    {0x00000000L, 0x5BA1DCCAL, 0xB743B994L, 0xECE2655EL, 0x6A466E9FL, 0x31E7B255L, 0xDD05D70BL,
+     0x86A40BC1L, 0xD48CDD3EL, 0x8F2D01F4L, 0x63CF64AAL, 0x386EB860L, 0xBECAB3A1L, 0xE56B6F6BL,
+     0x09890A35L, 0x5228D6FFL, 0xADD8A7CBL, 0xF6797B01L, 0x1A9B1E5FL, 0x413AC295L, 0xC79EC954L,
+     0x9C3F159EL, 0x70DD70C0L, 0x2B7CAC0AL, 0x79547AF5L, 0x22F5A63FL, 0xCE17C361L, 0x95B61FABL,
+     0x1312146AL, 0x48B3C8A0L, 0xA451ADFEL, 0xFFF07134L, 0x5F705221L, 0x04D18EEBL, 0xE833EBB5L,
+     0xB392377FL, 0x35363CBEL, 0x6E97E074L, 0x8275852AL, 0xD9D459E0L, 0x8BFC8F1FL, 0xD05D53D5L,
+     0x3CBF368BL, 0x671EEA41L, 0xE1BAE180L, 0xBA1B3D4AL, 0x56F95814L, 0x0D5884DEL, 0xF2A8F5EAL,
+     0xA9092920L, 0x45EB4C7EL, 0x1E4A90B4L, 0x98EE9B75L, 0xC34F47BFL, 0x2FAD22E1L, 0x740CFE2BL,
+     0x262428D4L, 0x7D85F41EL, 0x91679140L, 0xCAC64D8AL, 0x4C62464BL, 0x17C39A81L, 0xFB21FFDFL,
+     0xA0802315L, 0xBEE0A442L, 0xE5417888L, 0x09A31DD6L, 0x5202C11CL, 0xD4A6CADDL, 0x8F071617L,
+     0x63E57349L, 0x3844AF83L, 0x6A6C797CL, 0x31CDA5B6L, 0xDD2FC0E8L, 0x868E1C22L, 0x002A17E3L,
+     0x5B8BCB29L, 0xB769AE77L, 0xECC872BDL, 0x13380389L, 0x4899DF43L, 0xA47BBA1DL, 0xFFDA66D7L,
+     0x797E6D16L, 0x22DFB1DCL, 0xCE3DD482L, 0x959C0848L, 0xC7B4DEB7L, 0x9C15027DL, 0x70F76723L,
+     0x2B56BBE9L, 0xADF2B028L, 0xF6536CE2L, 0x1AB109BCL, 0x4110D576L, 0xE190F663L, 0xBA312AA9L,
+     0x56D34FF7L, 0x0D72933DL, 0x8BD698FCL, 0xD0774436L, 0x3C952168L, 0x6734FDA2L, 0x351C2B5DL,
+     0x6EBDF797L, 0x825F92C9L, 0xD9FE4E03L, 0x5F5A45C2L, 0x04FB9908L, 0xE819FC56L, 0xB3B8209CL,
+     0x4C4851A8L, 0x17E98D62L, 0xFB0BE83CL, 0xA0AA34F6L, 0x260E3F37L, 0x7DAFE3FDL, 0x914D86A3L,
+     0xCAEC5A69L, 0x98C48C96L, 0xC365505CL, 0x2F873502L, 0x7426E9C8L, 0xF282E209L, 0xA9233EC3L,
+     0x45C15B9DL, 0x1E608757L, 0x79005533L, 0x22A189F9L, 0xCE43ECA7L, 0x95E2306DL, 0x13463BACL,
+     0x48E7E766L, 0xA4058238L, 0xFFA45EF2L, 0xAD8C880DL, 0xF62D54C7L, 0x1ACF3199L, 0x416EED53L,
+     0xC7CAE692L, 0x9C6B3A58L, 0x70895F06L, 0x2B2883CCL, 0xD4D8F2F8L, 0x8F792E32L, 0x639B4B6CL,
+     0x383A97A6L, 0xBE9E9C67L, 0xE53F40ADL, 0x09DD25F3L, 0x527CF939L, 0x00542FC6L, 0x5BF5F30CL,
+     0xB7179652L, 0xECB64A98L, 0x6A124159L, 0x31B39D93L, 0xDD51F8CDL, 0x86F02407L, 0x26700712L,
+     0x7DD1DBD8L, 0x9133BE86L, 0xCA92624CL, 0x4C36698DL, 0x1797B547L, 0xFB75D019L, 0xA0D40CD3L,
+     0xF2FCDA2CL, 0xA95D06E6L, 0x45BF63B8L, 0x1E1EBF72L, 0x98BAB4B3L, 0xC31B6879L, 0x2FF90D27L,
+     0x7458D1EDL, 0x8BA8A0D9L, 0xD0097C13L, 0x3CEB194DL, 0x674AC587L, 0xE1EECE46L, 0xBA4F128CL,
+     0x56AD77D2L, 0x0D0CAB18L, 0x5F247DE7L, 0x0485A12DL, 0xE867C473L, 0xB3C618B9L, 0x35621378L,
+     0x6EC3CFB2L, 0x8221AAECL, 0xD9807626L, 0xC7E0F171L, 0x9C412DBBL, 0x70A348E5L, 0x2B02942FL,
+     0xADA69FEEL, 0xF6074324L, 0x1AE5267AL, 0x4144FAB0L, 0x136C2C4FL, 0x48CDF085L, 0xA42F95DBL,
+     0xFF8E4911L, 0x792A42D0L, 0x228B9E1AL, 0xCE69FB44L, 0x95C8278EL, 0x6A3856BAL, 0x31998A70L,
+     0xDD7BEF2EL, 0x86DA33E4L, 0x007E3825L, 0x5BDFE4EFL, 0xB73D81B1L, 0xEC9C5D7BL, 0xBEB48B84L,
+     0xE515574EL, 0x09F73210L, 0x5256EEDAL, 0xD4F2E51BL, 0x8F5339D1L, 0x63B15C8FL, 0x38108045L,
+     0x9890A350L, 0xC3317F9AL, 0x2FD31AC4L, 0x7472C60EL, 0xF2D6CDCFL, 0xA9771105L, 0x4595745BL,
+     0x1E34A891L, 0x4C1C7E6EL, 0x17BDA2A4L, 0xFB5FC7FAL, 0xA0FE1B30L, 0x265A10F1L, 0x7DFBCC3BL,
+     0x9119A965L, 0xCAB875AFL, 0x3548049BL, 0x6EE9D851L, 0x820BBD0FL, 0xD9AA61C5L, 0x5F0E6A04L,
+     0x04AFB6CEL, 0xE84DD390L, 0xB3EC0F5AL, 0xE1C4D9A5L, 0xBA65056FL, 0x56876031L, 0x0D26BCFBL,
+     0x8B82B73AL, 0xD0236BF0L, 0x3CC10EAEL, 0x6760D264L}};
 #endif
 
 static DRFLAC_INLINE uint32_t drflac_crc32_byte(uint32_t crc32, uint8_t data) {
@@ -5661,14 +7288,118 @@ static DRFLAC_INLINE uint32_t drflac_crc32_uint64(uint32_t crc32, uint64_t data)
 }
 #endif
 
-static DRFLAC_INLINE uint32_t drflac_crc32_buffer(uint32_t crc32, uint8_t* pData,
-                                                       uint32_t dataSize) {
-  /* This can be optimized. */
-  uint32_t i;
-  for (i = 0; i < dataSize; ++i) { crc32 = drflac_crc32_byte(crc32, pData[i]); }
+static DRFLAC_INLINE uint32_t drflac_crc32_buffer__scalar(uint32_t crc32, const uint8_t* pData,
+                                                          uint32_t dataSize) {
+#ifndef DR_FLAC_NO_CRC
+  /*
+  Slicing-by-8. The CRC is linear so folding the current CRC into the first four
+  bytes lets each of the eight bytes be looked up independently, rather than one
+  after the other.
+  */
+  while (dataSize >= 8) {
+    uint32_t hi = crc32 ^ (((uint32_t)pData[0] << 24) | ((uint32_t)pData[1] << 16) |
+                           ((uint32_t)pData[2] << 8) | ((uint32_t)pData[3] << 0));
+    uint32_t lo = ((uint32_t)pData[4] << 24) | ((uint32_t)pData[5] << 16) |
+                  ((uint32_t)pData[6] << 8) | ((uint32_t)pData[7] << 0);
+
+    crc32 = drflac__crc32_slice_tables[6][(hi >> 24) & 0xFF] ^
+            drflac__crc32_slice_tables[5][(hi >> 16) & 0xFF] ^
+            drflac__crc32_slice_tables[4][(hi >> 8) & 0xFF] ^
+            drflac__crc32_slice_tables[3][(hi >> 0) & 0xFF] ^
+            drflac__crc32_slice_tables[2][(lo >> 24) & 0xFF] ^
+            drflac__crc32_slice_tables[1][(lo >> 16) & 0xFF] ^
+            drflac__crc32_slice_tables[0][(lo >> 8) & 0xFF] ^ drflac__crc32_table[lo & 0xFF];
+
+    pData += 8;
+    dataSize -= 8;
+  }
+
+  while (dataSize > 0) {
+    crc32 = drflac_crc32_byte(crc32, *pData);
+    pData += 1;
+    dataSize -= 1;
+  }
+#else
+  (void)pData;
+  (void)dataSize;
+#endif
+
   return crc32;
 }
 
+#if defined(DRFLAC_SUPPORT_PCLMUL) && !defined(DR_FLAC_NO_CRC)
+/* Loads 16 bytes so that the first byte is the most significant. */
+static DRFLAC_INLINE __m128i drflac__load_be_128(const uint8_t* pData) {
+  __m128i v = _mm_loadu_si128((const __m128i*)pData);
+  v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+  v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+  return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+/* Multiplies a 128-bit block by x^n. The constants are x^(n+64) mod P and x^n mod P. */
+static DRFLAC_INLINE __m128i drflac__crc32_fold_128(__m128i block, __m128i constants) {
+  return _mm_xor_si128(_mm_clmulepi64_si128(block, constants, 0x11),
+                       _mm_clmulepi64_si128(block, constants, 0x00));
+}
+
+/*
+Folds the data into four independent 128-bit accumulators with carry-less
+multiplies, so it runs at close to memory speed rather than being bound by the
+latency of one table lookup after another. The accumulators are then folded into
+one, which has the same remainder as the whole buffer and can be finished off
+with the tables. dataSize must be a non-zero multiple of 64.
+*/
+static uint32_t drflac_crc32_buffer__pclmul(uint32_t crc32, const uint8_t* pData,
+                                            uint32_t dataSize) {
+  const __m128i foldBy4 = _mm_set_epi64x(0x8833794C, 0xE6228B11); /* x^576, x^512 */
+  const __m128i foldBy1 = _mm_set_epi64x(0xC5B9CD4C, 0xE8A45605); /* x^192, x^128 */
+  __m128i x0;
+  __m128i x1;
+  __m128i x2;
+  __m128i x3;
+  uint8_t remainder[16];
+  uint32_t i;
+
+  DRFLAC_ASSERT(dataSize >= 64 && (dataSize & 63) == 0);
+
+  x0 = _mm_xor_si128(drflac__load_be_128(pData + 0), _mm_set_epi32((int)crc32, 0, 0, 0));
+  x1 = drflac__load_be_128(pData + 16);
+  x2 = drflac__load_be_128(pData + 32);
+  x3 = drflac__load_be_128(pData + 48);
+
+  for (i = 64; i < dataSize; i += 64) {
+    x0 = _mm_xor_si128(drflac__crc32_fold_128(x0, foldBy4), drflac__load_be_128(pData + i + 0));
+    x1 = _mm_xor_si128(drflac__crc32_fold_128(x1, foldBy4), drflac__load_be_128(pData + i + 16));
+    x2 = _mm_xor_si128(drflac__crc32_fold_128(x2, foldBy4), drflac__load_be_128(pData + i + 32));
+    x3 = _mm_xor_si128(drflac__crc32_fold_128(x3, foldBy4), drflac__load_be_128(pData + i + 48));
+  }
+
+  x0 = _mm_xor_si128(drflac__crc32_fold_128(x0, foldBy1), x1);
+  x0 = _mm_xor_si128(drflac__crc32_fold_128(x0, foldBy1), x2);
+  x0 = _mm_xor_si128(drflac__crc32_fold_128(x0, foldBy1), x3);
+
+  /* Reversing the bytes again puts the accumulator back into stream order. */
+  _mm_storeu_si128((__m128i*)remainder, drflac__load_be_128((const uint8_t*)&x0));
+
+  return drflac_crc32_buffer__scalar(0, remainder, sizeof(remainder));
+}
+#endif
+
+static DRFLAC_INLINE uint32_t drflac_crc32_buffer(uint32_t crc32, const uint8_t* pData,
+                                                  uint32_t dataSize) {
+#if defined(DRFLAC_SUPPORT_PCLMUL) && !defined(DR_FLAC_NO_CRC)
+  /* Short buffers aren't worth the setup. Ogg page headers are the common case. */
+  if (drflac__gIsPCLMULSupported && dataSize >= 256) {
+    uint32_t foldedSize = dataSize & ~(uint32_t)63;
+    crc32 = drflac_crc32_buffer__pclmul(crc32, pData, foldedSize);
+    pData += foldedSize;
+    dataSize -= foldedSize;
+  }
+#endif
+
+  return drflac_crc32_buffer__scalar(crc32, pData, dataSize);
+}
+
 static DRFLAC_INLINE bool drflac_ogg__is_capture_pattern(uint8_t pattern[4]) {
   return pattern[0] == 'O' && pattern[1] == 'g' && pattern[2] == 'g' && pattern[3] == 'S';
 }
@@ -5691,7 +7422,6 @@ static drflac_result drflac_ogg__read_page_header_after_capture_pattern(
     drflac_read_proc onRead, void* pUserData, drflac_ogg_page_header* pHeader,
     uint32_t* pBytesRead, uint32_t* pCRC32) {
   uint8_t data[23];
-  uint32_t i;
 
   DRFLAC_ASSERT(*pCRC32 == DRFLAC_OGG_CAPTURE_PATTERN_CRC32);
 
@@ -5725,16 +7455,14 @@ static drflac_result drflac_ogg__read_page_header_after_capture_pattern(
   data[20] = 0;
   data[21] = 0;
 
-  for (i = 0; i < 23; ++i) { *pCRC32 = drflac_crc32_byte(*pCRC32, data[i]); }
+  *pCRC32 = drflac_crc32_buffer(*pCRC32, data, 23);
 
   if (onRead(pUserData, pHeader->segmentTable, pHeader->segmentCount) != pHeader->segmentCount) {
     return DRFLAC_AT_END;
   }
   *pBytesRead += pHeader->segmentCount;
 
-  for (i = 0; i < pHeader->segmentCount; ++i) {
-    *pCRC32 = drflac_crc32_byte(*pCRC32, pHeader->segmentTable[i]);
-  }
+  *pCRC32 = drflac_crc32_buffer(*pCRC32, pHeader->segmentTable, pHeader->segmentCount);
 
   return DRFLAC_SUCCESS;
 }
@@ -5790,6 +7518,24 @@ supporting there needs to be a layer sitting on top of the onRead and onSeek
 callbacks that ensures the bits read from the physical Ogg bitstream are
 converted and delivered in native FLAC format.
 */
+
+/*
+A chained Ogg stream is a series of logical streams, one after the other, each
+of which is called a link. Positions are relative to the start of the whole
+stream so that PCM frames carry on counting from one link to the next.
+*/
+typedef struct {
+  uint64_t firstPCMFrame;    /* The index of the first PCM frame in the link. */
+  uint64_t bosPagePos;       /* The position of the link's bos page in the physical bitstream. */
+  uint64_t firstFramePos;    /* Like drflac::firstFLACFramePosInBytes, but for the link. */
+  uint32_t serialNumber;     /* The serial number of the link's FLAC pages. */
+  bool hasMetadataBlocks;    /* Whether STREAMINFO is followed by other metadata blocks. */
+  drflac_streaminfo streaminfo;
+} drflac_ogg_link;
+
+/* The size of the packet on a FLAC bos page, which holds the STREAMINFO block. */
+#define DRFLAC_OGG_FLAC_BOS_PACKET_SIZE 51
+
 typedef struct {
   drflac_read_proc onRead;      /* The original onRead callback from drflac_open() and family. */
   drflac_seek_proc onSeek;      /* The original onSeek callback from drflac_open() and family. */
@@ -5808,8 +7554,41 @@ typedef struct {
   uint32_t bytesRemainingInPage;
   uint32_t pageDataSize;
   uint8_t pageData[DRFLAC_OGG_MAX_PAGE_SIZE];
+
+  /*
+  When set, onRead() and onSeek() operate on this memory stream and page bodies
+  are used in place rather than copied into pageData. pPageDataInMemory points
+  to the current page body in that case, and is NULL when it's in pageData.
+  */
+  drflac__memory_stream* pMemoryStream;
+  const uint8_t* pPageDataInMemory;
+
+  /*
+  The link being decoded. isLinkEnded is set once its eos page has been read,
+  after which the bos page of the next link stops the reader with hasNextLink
+  set until drflac_ogg__begin_next_link() moves on to it.
+  */
+  uint32_t iCurrentLink;
+  uint64_t linkBytePos;        /* The position of the link's bos page. */
+  uint64_t linkFirstPCMFrame;
+  uint64_t linkPCMFrameCount;  /* From the link's STREAMINFO block. Can be 0. */
+  bool isLinkEnded;
+  bool hasNextLink;
+  drflac_ogg_link nextLink;    /* Everything but firstPCMFrame and firstFramePos. */
+
+  /*
+  The links found so far. This is only allocated, with the decoder's allocation
+  callbacks, once a second link is found.
+  */
+  drflac_ogg_link* pLinks;
+  uint32_t linkCount;
+  uint32_t linkCapacity;
 } drflac_oggbs; /* oggbs = Ogg Bitstream */
 
+static DRFLAC_INLINE const uint8_t* drflac_oggbs__get_page_data(const drflac_oggbs* oggbs) {
+  return (oggbs->pPageDataInMemory != NULL) ? oggbs->pPageDataInMemory : oggbs->pageData;
+}
+
 static size_t drflac_oggbs__read_physical(drflac_oggbs* oggbs, void* bufferOut,
                                           size_t bytesToRead) {
   size_t bytesActuallyRead = oggbs->onRead(oggbs->pUserData, bufferOut, bytesToRead);
@@ -5821,6 +7600,10 @@ static size_t drflac_oggbs__read_physical(drflac_oggbs* oggbs, void* bufferOut,
 static bool drflac_oggbs__seek_physical(drflac_oggbs* oggbs, uint64_t offset,
                                                  drflac_seek_origin origin) {
   if (origin == drflac_seek_origin_start) {
+    /* Seeks from the start always land on a page of the current link. */
+    oggbs->isLinkEnded = DRFLAC_FALSE;
+    oggbs->hasNextLink = DRFLAC_FALSE;
+
     if (offset <= 0x7FFFFFFF) {
       if (!oggbs->onSeek(oggbs->pUserData, (int)offset, drflac_seek_origin_start)) {
         return DRFLAC_FALSE;
@@ -5856,9 +7639,47 @@ static bool drflac_oggbs__seek_physical(drflac_oggbs* oggbs, uint64_t offset,
   }
 }
 
+/*
+Parses the packet on a FLAC bos page, which is the Ogg mapping header followed
+by the STREAMINFO block.
+*/
+static bool drflac_ogg__parse_flac_bos_packet(const uint8_t* pPacket,
+                                              drflac_streaminfo* pStreamInfo,
+                                              bool* pHasMetadataBlocks) {
+  drflac__memory_stream streaminfoStream;
+
+  if (pPacket[0] != 0x7F || pPacket[1] != 'F' || pPacket[2] != 'L' || pPacket[3] != 'A' ||
+      pPacket[4] != 'C') {
+    return DRFLAC_FALSE;
+  }
+
+  /* Only supporting version 1.x of the Ogg mapping. */
+  if (pPacket[5] != 1) { return DRFLAC_FALSE; }
+
+  if (pPacket[9] != 'f' || pPacket[10] != 'L' || pPacket[11] != 'a' || pPacket[12] != 'C') {
+    return DRFLAC_FALSE;
+  }
+
+  if ((pPacket[13] & 0x7F) != DRFLAC_METADATA_BLOCK_TYPE_STREAMINFO || pPacket[14] != 0 ||
+      pPacket[15] != 0 || pPacket[16] != 34) {
+    return DRFLAC_FALSE;
+  }
+
+  *pHasMetadataBlocks = (pPacket[13] & 0x80) == 0;
+
+  streaminfoStream.data = pPacket + 17;
+  streaminfoStream.dataSize = 34;
+  streaminfoStream.currentReadPos = 0;
+  return drflac__read_streaminfo(drflac__on_read_memory, &streaminfoStream, pStreamInfo);
+}
+
 static bool drflac_oggbs__goto_next_page(drflac_oggbs* oggbs,
                                                   drflac_ogg_crc_mismatch_recovery recoveryMethod) {
   drflac_ogg_page_header header;
+
+  /* The reader stays on the bos page of the next link until it's moved on to. */
+  if (oggbs->hasNextLink) { return DRFLAC_FALSE; }
+
   for (;;) {
     uint32_t crc32 = 0;
     uint32_t bytesRead;
@@ -5879,6 +7700,32 @@ static bool drflac_oggbs__goto_next_page(drflac_oggbs* oggbs,
                    next page. */
     }
 
+    /*
+    Once the link has ended a FLAC bos page is the start of the next link. Its
+    serial number can be the same as the last link's.
+    */
+    if (oggbs->isLinkEnded && (header.headerType & 0x02) != 0 &&
+        pageBodySize == DRFLAC_OGG_FLAC_BOS_PACKET_SIZE) {
+      uint8_t bosPacket[DRFLAC_OGG_FLAC_BOS_PACKET_SIZE];
+      if (drflac_oggbs__read_physical(oggbs, bosPacket, pageBodySize) != pageBodySize) {
+        return DRFLAC_FALSE;
+      }
+
+#ifndef DR_FLAC_NO_CRC
+      if (drflac_crc32_buffer(crc32, bosPacket, pageBodySize) != header.checksum) { continue; }
+#endif
+
+      if (drflac_ogg__parse_flac_bos_packet(bosPacket, &oggbs->nextLink.streaminfo,
+                                            &oggbs->nextLink.hasMetadataBlocks)) {
+        oggbs->nextLink.bosPagePos =
+            oggbs->currentBytePos - drflac_ogg__get_page_header_size(&header) - pageBodySize;
+        oggbs->nextLink.serialNumber = header.serialNumber;
+        oggbs->hasNextLink = DRFLAC_TRUE;
+        return DRFLAC_FALSE;
+      }
+      continue; /* Some other codec. */
+    }
+
     if (header.serialNumber != oggbs->serialNumber) {
       /* It's not a FLAC page. Skip it. */
       if (pageBodySize > 0 &&
@@ -5890,13 +7737,26 @@ static bool drflac_oggbs__goto_next_page(drflac_oggbs* oggbs,
 
     /* We need to read the entire page and then do a CRC check on it. If there's
      * a CRC mismatch we need to skip this page. */
-    if (drflac_oggbs__read_physical(oggbs, oggbs->pageData, pageBodySize) != pageBodySize) {
-      return DRFLAC_FALSE;
+    if (oggbs->pMemoryStream != NULL) {
+      drflac__memory_stream* pStream = oggbs->pMemoryStream;
+
+      DRFLAC_ASSERT(pStream->dataSize >= pStream->currentReadPos);
+      if (pStream->dataSize - pStream->currentReadPos < pageBodySize) { return DRFLAC_FALSE; }
+
+      oggbs->pPageDataInMemory = pStream->data + pStream->currentReadPos;
+      pStream->currentReadPos += pageBodySize;
+      oggbs->currentBytePos += pageBodySize;
+    } else {
+      if (drflac_oggbs__read_physical(oggbs, oggbs->pageData, pageBodySize) != pageBodySize) {
+        return DRFLAC_FALSE;
+      }
+      oggbs->pPageDataInMemory = NULL;
     }
     oggbs->pageDataSize = pageBodySize;
 
 #ifndef DR_FLAC_NO_CRC
-    actualCRC32 = drflac_crc32_buffer(crc32, oggbs->pageData, oggbs->pageDataSize);
+    actualCRC32 =
+        drflac_crc32_buffer(crc32, drflac_oggbs__get_page_data(oggbs), oggbs->pageDataSize);
     if (actualCRC32 != header.checksum) {
       if (recoveryMethod == drflac_ogg_recover_on_crc_mismatch) {
         continue; /* CRC mismatch. Skip this page. */
@@ -5917,6 +7777,7 @@ static bool drflac_oggbs__goto_next_page(drflac_oggbs* oggbs,
 
     oggbs->currentPageHeader = header;
     oggbs->bytesRemainingInPage = pageBodySize;
+    oggbs->isLinkEnded = (header.headerType & 0x04) != 0;
     return DRFLAC_TRUE;
   }
 }
@@ -6016,7 +7877,8 @@ static size_t drflac__on_read_ogg(void* pUserData, void* bufferOut, size_t bytes
 
     if (oggbs->bytesRemainingInPage >= bytesRemainingToRead) {
       DRFLAC_COPY_MEMORY(pRunningBufferOut,
-                         oggbs->pageData + (oggbs->pageDataSize - oggbs->bytesRemainingInPage),
+                         drflac_oggbs__get_page_data(oggbs) +
+                             (oggbs->pageDataSize - oggbs->bytesRemainingInPage),
                          bytesRemainingToRead);
       bytesRead += bytesRemainingToRead;
       oggbs->bytesRemainingInPage -= (uint32_t)bytesRemainingToRead;
@@ -6027,7 +7889,8 @@ static size_t drflac__on_read_ogg(void* pUserData, void* bufferOut, size_t bytes
      * next pages. */
     if (oggbs->bytesRemainingInPage > 0) {
       DRFLAC_COPY_MEMORY(pRunningBufferOut,
-                         oggbs->pageData + (oggbs->pageDataSize - oggbs->bytesRemainingInPage),
+                         drflac_oggbs__get_page_data(oggbs) +
+                             (oggbs->pageDataSize - oggbs->bytesRemainingInPage),
                          oggbs->bytesRemainingInPage);
       bytesRead += oggbs->bytesRemainingInPage;
       pRunningBufferOut += oggbs->bytesRemainingInPage;
@@ -6053,7 +7916,7 @@ static bool drflac__on_seek_ogg(void* pUserData, int offset, drflac_seek_origin
 
   /* Seeking is always forward which makes things a lot simpler. */
   if (origin == drflac_seek_origin_start) {
-    if (!drflac_oggbs__seek_physical(oggbs, (int)oggbs->firstBytePos, drflac_seek_origin_start)) {
+    if (!drflac_oggbs__seek_physical(oggbs, oggbs->linkBytePos, drflac_seek_origin_start)) {
       return DRFLAC_FALSE;
     }
 
@@ -6096,78 +7959,630 @@ static bool drflac__on_seek_ogg(void* pUserData, int offset, drflac_seek_origin
   return DRFLAC_TRUE;
 }
 
-static bool drflac_ogg__seek_to_pcm_frame(drflac* pFlac, uint64_t pcmFrameIndex) {
-  drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
-  uint64_t originalBytePos;
-  uint64_t runningGranulePosition;
-  uint64_t runningFrameBytePos;
-  uint64_t runningPCMFrameCount;
+static uint64_t drflac_ogg__get_link_first_pcm_frame(drflac* pFlac) {
+  if (pFlac->container != drflac_container_ogg) { return 0; }
+  return ((drflac_oggbs*)pFlac->_oggbs)->linkFirstPCMFrame;
+}
 
-  DRFLAC_ASSERT(oggbs != NULL);
+static bool drflac_ogg__is_link_ended(drflac* pFlac) {
+  return ((drflac_oggbs*)pFlac->_oggbs)->isLinkEnded;
+}
 
-  originalBytePos = oggbs->currentBytePos; /* For recovery. Points to the OggS identifier. */
+static void drflac_ogg__free_links(drflac* pFlac) {
+  drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
 
-  /* First seek to the first frame. */
-  if (!drflac__seek_to_byte(&pFlac->bs, pFlac->firstFLACFramePosInBytes)) { return DRFLAC_FALSE; }
-  oggbs->bytesRemainingInPage = 0;
+  if (pFlac->container != drflac_container_ogg || oggbs == NULL) { return; }
+
+  drflac__free_from_callbacks(oggbs->pLinks, &pFlac->allocationCallbacks);
+  oggbs->pLinks = NULL;
+  oggbs->linkCount = 0;
+  oggbs->linkCapacity = 0;
+}
+
+static bool drflac_ogg__reserve_links(drflac* pFlac, uint32_t capacity) {
+  drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
+  drflac_ogg_link* pNewLinks;
+
+  if (capacity <= oggbs->linkCapacity) { return DRFLAC_TRUE; }
+  if (capacity < oggbs->linkCapacity * 2) { capacity = oggbs->linkCapacity * 2; }
+
+  pNewLinks = (drflac_ogg_link*)drflac__realloc_from_callbacks(
+      oggbs->pLinks, capacity * sizeof(*oggbs->pLinks), oggbs->linkCapacity * sizeof(*oggbs->pLinks),
+      &pFlac->allocationCallbacks);
+  if (pNewLinks == NULL) { return DRFLAC_FALSE; }
+
+  oggbs->pLinks = pNewLinks;
+  oggbs->linkCapacity = capacity;
+  return DRFLAC_TRUE;
+}
+
+/* Finds the last link starting at or before the PCM frame. */
+static uint32_t drflac_ogg__find_link(drflac_oggbs* oggbs, uint64_t pcmFrameIndex) {
+  uint32_t lo = 0;
+  uint32_t hi = oggbs->linkCount;
+
+  while (lo < hi) {
+    uint32_t mid = lo + ((hi - lo) / 2);
+    if (oggbs->pLinks[mid].firstPCMFrame <= pcmFrameIndex) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return (lo > 0) ? lo - 1 : 0;
+}
+
+/*
+Switches the decoder over to a link that's already been found. This doesn't
+move the read position, which is up to the caller.
+*/
+static void drflac_ogg__enter_link(drflac* pFlac, uint32_t iLink) {
+  drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
+  const drflac_ogg_link* pLink;
+
+  /* Without a list of links the only one is the first, which is where we already are. */
+  if (iLink >= oggbs->linkCount) { return; }
+
+  pLink = &oggbs->pLinks[iLink];
+  oggbs->iCurrentLink = iLink;
+  oggbs->serialNumber = pLink->serialNumber;
+  oggbs->linkBytePos = pLink->bosPagePos;
+  oggbs->linkFirstPCMFrame = pLink->firstPCMFrame;
+  oggbs->linkPCMFrameCount = pLink->streaminfo.totalPCMFrameCount;
+
+  pFlac->sampleRate = pLink->streaminfo.sampleRate;
+  pFlac->channels = pLink->streaminfo.channels;
+  pFlac->bitsPerSample = pLink->streaminfo.bitsPerSample;
+  pFlac->maxBlockSizeInPCMFrames = pLink->streaminfo.maxBlockSizeInPCMFrames;
+  DRFLAC_COPY_MEMORY(pFlac->md5, pLink->streaminfo.md5, sizeof(pFlac->md5));
+  pFlac->firstFLACFramePosInBytes = pLink->firstFramePos;
+}
+
+/*
+Moves on to the next link once the reader has stopped on its bos page. The rest
+of its header packets are read, with its metadata going to onMeta when that's
+set, which leaves the reader on the link's first frame.
+
+This fails if the link's frames won't fit in the memory that was allocated for
+the first link's decoded samples, or if there's no memory for the list of
+links. The stream then ends with the current link.
+*/
+static bool drflac_ogg__begin_next_link(drflac* pFlac, drflac_meta_proc onMeta) {
+  drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
+  drflac_ogg_link link = oggbs->nextLink;
+  uint32_t iLink = oggbs->iCurrentLink + 1;
+  uint32_t decodedSamplesAllocationSize;
+  uint64_t firstFramePos;
+  uint64_t seektablePos;
+  uint32_t seektableSize;
+
+  if (!oggbs->hasNextLink) { return DRFLAC_FALSE; }
+
+  /* The first link goes in the list when the second is found. */
+  if (oggbs->linkCount == 0) {
+    drflac_ogg_link* pFirstLink;
+
+    if (!drflac_ogg__reserve_links(pFlac, 2)) { return DRFLAC_FALSE; }
+
+    pFirstLink = &oggbs->pLinks[0];
+    DRFLAC_ZERO_MEMORY(pFirstLink, sizeof(*pFirstLink));
+    pFirstLink->firstPCMFrame = 0;
+    pFirstLink->bosPagePos = oggbs->firstBytePos;
+    pFirstLink->firstFramePos = pFlac->firstFLACFramePosInBytes;
+    pFirstLink->serialNumber = oggbs->serialNumber;
+    pFirstLink->streaminfo.maxBlockSizeInPCMFrames = pFlac->maxBlockSizeInPCMFrames;
+    pFirstLink->streaminfo.sampleRate = pFlac->sampleRate;
+    pFirstLink->streaminfo.channels = pFlac->channels;
+    pFirstLink->streaminfo.bitsPerSample = pFlac->bitsPerSample;
+    pFirstLink->streaminfo.totalPCMFrameCount = oggbs->linkPCMFrameCount;
+    DRFLAC_COPY_MEMORY(pFirstLink->streaminfo.md5, pFlac->md5, sizeof(pFlac->md5));
+    oggbs->linkCount = 1;
+  }
+
+  decodedSamplesAllocationSize = drflac__get_decoded_samples_allocation_size(
+      oggbs->pLinks[0].streaminfo.maxBlockSizeInPCMFrames, oggbs->pLinks[0].streaminfo.channels);
+  if (drflac__get_decoded_samples_allocation_size(link.streaminfo.maxBlockSizeInPCMFrames,
+                                                  link.streaminfo.channels) >
+      decodedSamplesAllocationSize) {
+    return DRFLAC_FALSE;
+  }
+
+  if (iLink < oggbs->linkCount) {
+    if (oggbs->pLinks[iLink].bosPagePos != link.bosPagePos) { return DRFLAC_FALSE; }
+  } else {
+    /* The link starts where the last one ended, which is the granule position of its eos page. */
+    if (oggbs->currentPageHeader.granulePosition == DRFLAC_OGG_NO_GRANULE_POSITION) {
+      return DRFLAC_FALSE;
+    }
+    if (!drflac_ogg__reserve_links(pFlac, iLink + 1)) { return DRFLAC_FALSE; }
+
+    link.firstPCMFrame = oggbs->linkFirstPCMFrame + oggbs->currentPageHeader.granulePosition;
+  }
+
+  oggbs->serialNumber = link.serialNumber;
+  oggbs->hasNextLink = DRFLAC_FALSE;
+  oggbs->isLinkEnded = DRFLAC_FALSE;
+  oggbs->bytesRemainingInPage = 0;
+
+  if (onMeta) {
+    drflac_metadata metadata;
+    metadata.type = DRFLAC_METADATA_BLOCK_TYPE_STREAMINFO;
+    metadata.pRawData = NULL;
+    metadata.rawDataSize = 0;
+    metadata.data.streaminfo = link.streaminfo;
+    onMeta(pFlac->pUserDataMD, &metadata);
+  }
+
+  firstFramePos = 42; /* Counted the same way as the first link's. */
+  if (link.hasMetadataBlocks &&
+      !drflac__read_and_decode_metadata(drflac__on_read_ogg, drflac__on_seek_ogg, onMeta,
+                                        (void*)oggbs, pFlac->pUserDataMD, &firstFramePos,
+                                        &seektablePos, &seektableSize, 0xFFFFFFFF, NULL,
+                                        &pFlac->allocationCallbacks)) {
+    oggbs->serialNumber = oggbs->pLinks[oggbs->iCurrentLink].serialNumber;
+    return DRFLAC_FALSE;
+  }
+
+  if (iLink == oggbs->linkCount) {
+    link.firstFramePos = firstFramePos;
+    oggbs->pLinks[iLink] = link;
+    oggbs->linkCount += 1;
+
+    /* The length is only known up to the end of the last link that's been found. */
+    pFlac->totalPCMFrameCount = link.firstPCMFrame + link.streaminfo.totalPCMFrameCount;
+  }
+
+  drflac_ogg__enter_link(pFlac, iLink);
+
+  drflac__reset_cache(&pFlac->bs);
+  pFlac->bs.clientBytePos = firstFramePos;
+  DRFLAC_ZERO_MEMORY(&pFlac->currentFLACFrame, sizeof(pFlac->currentFLACFrame));
+
+  return DRFLAC_TRUE;
+}
+
+static DRFLAC_INLINE uint64_t drflac_oggbs__get_current_page_pos(drflac_oggbs* oggbs) {
+  return oggbs->currentBytePos - drflac_ogg__get_page_header_size(&oggbs->currentPageHeader) -
+         oggbs->pageDataSize;
+}
+
+static DRFLAC_INLINE bool drflac_oggbs__is_frame_sync_at(drflac_oggbs* oggbs, uint32_t offset) {
+  const uint8_t* pPageData = drflac_oggbs__get_page_data(oggbs);
+
+  return offset + 1 < oggbs->pageDataSize && pPageData[offset] == 0xFF &&
+         (pPageData[offset + 1] & 0xFC) == 0xF8;
+}
+
+/*
+Finds the places in the current page where decoding can start, of which there
+are at most two, and returns how many there are. They are returned as page index
+entries where flacFrameOffset is the position of the page relative to the start
+of the Ogg stream and pcmFrameCount is the position of the frame in the page.
+Granule positions start from 0 again in each link so they're offset by the first
+PCM frame of the link.
+
+The first is the start of the page, but only if it begins a new packet and
+directly follows a page that ended on a packet boundary. The granule position of
+that previous page is the number of PCM frames before it. Pages skipped because
+of a CRC mismatch are caught by the sequence number.
+
+The second is the start of a packet that doesn't finish in this page. All
+packets before it are finished, so this page's granule position is the number of
+PCM frames before it. With pages that don't line up with packets, which is how
+most muxers write them, this is the one that'll usually be found.
+*/
+static uint32_t drflac_ogg__find_start_points_in_current_page(drflac_oggbs* oggbs,
+                                                              uint64_t previousGranulePosition,
+                                                              uint32_t expectedSequenceNumber,
+                                                              drflac_seekpoint* pStartPoints) {
+  const drflac_ogg_page_header* pHeader = &oggbs->currentPageHeader;
+  uint64_t pageOffset = drflac_oggbs__get_current_page_pos(oggbs) - oggbs->firstBytePos;
+  uint32_t lastPacketOffset = 0;
+  uint32_t runningOffset = 0;
+  uint32_t count = 0;
+  uint32_t iSegment;
+
+  if (pHeader->segmentCount == 0) { return 0; }
+
+  if ((pHeader->headerType & 0x01) == 0 &&
+      previousGranulePosition != DRFLAC_OGG_NO_GRANULE_POSITION &&
+      pHeader->sequenceNumber == expectedSequenceNumber && drflac_oggbs__is_frame_sync_at(oggbs, 0)) {
+    pStartPoints[count].firstPCMFrame = oggbs->linkFirstPCMFrame + previousGranulePosition;
+    pStartPoints[count].flacFrameOffset = pageOffset;
+    pStartPoints[count].pcmFrameCount = 0;
+    count += 1;
+  }
+
+  for (iSegment = 0; iSegment < pHeader->segmentCount; iSegment += 1) {
+    runningOffset += pHeader->segmentTable[iSegment];
+    if (pHeader->segmentTable[iSegment] < 255) {
+      lastPacketOffset = runningOffset; /* A packet finished, so the next one starts here. */
+    }
+  }
+
+  if (pHeader->segmentTable[pHeader->segmentCount - 1] == 255 && lastPacketOffset > 0 &&
+      pHeader->granulePosition != DRFLAC_OGG_NO_GRANULE_POSITION &&
+      drflac_oggbs__is_frame_sync_at(oggbs, lastPacketOffset)) {
+    pStartPoints[count].firstPCMFrame = oggbs->linkFirstPCMFrame + pHeader->granulePosition;
+    pStartPoints[count].flacFrameOffset = pageOffset;
+    pStartPoints[count].pcmFrameCount = (uint16_t)lastPacketOffset;
+    count += 1;
+  }
+
+  return count;
+}
+
+/*
+Fills the page index with every place that decoding can start from. Only page
+headers are looked at so this is much faster than decoding. Pages with a CRC
+mismatch are left out.
+*/
+static bool drflac_ogg__build_page_index(drflac* pFlac) {
+  drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
+  uint64_t previousGranulePosition;
+  uint32_t nextSequenceNumber;
+  uint32_t count = 0;
+
+  drflac_ogg__enter_link(pFlac, 0);
+  if (!drflac__seek_to_byte(&pFlac->bs, pFlac->firstFLACFramePosInBytes)) { return DRFLAC_FALSE; }
+  oggbs->bytesRemainingInPage = 0;
+
+  previousGranulePosition = oggbs->currentPageHeader.granulePosition;
+  nextSequenceNumber = oggbs->currentPageHeader.sequenceNumber + 1;
 
-  runningGranulePosition = 0;
   for (;;) {
+    drflac_seekpoint startPoints[2];
+    uint32_t startPointCount;
+    uint32_t iStartPoint;
+
     if (!drflac_oggbs__goto_next_page(oggbs, drflac_ogg_recover_on_crc_mismatch)) {
-      drflac_oggbs__seek_physical(oggbs, originalBytePos, drflac_seek_origin_start);
-      return DRFLAC_FALSE; /* Never did find that sample... */
+      /* Carry on through the rest of a chained stream, which finds any links not yet known. */
+      if (oggbs->hasNextLink && drflac_ogg__begin_next_link(pFlac, NULL)) {
+        previousGranulePosition = oggbs->currentPageHeader.granulePosition;
+        nextSequenceNumber = oggbs->currentPageHeader.sequenceNumber + 1;
+        continue;
+      }
+      break;
+    }
+
+    startPointCount = drflac_ogg__find_start_points_in_current_page(
+        oggbs, previousGranulePosition, nextSequenceNumber, startPoints);
+    for (iStartPoint = 0; iStartPoint < startPointCount; iStartPoint += 1) {
+      if (count == pFlac->seekIndexCapacity) {
+        uint32_t newCapacity = (pFlac->seekIndexCapacity > 0) ? pFlac->seekIndexCapacity * 2 : 256;
+        if (!drflac__reserve_seek_index(pFlac, newCapacity)) {
+          drflac__free_seek_index(pFlac);
+          return DRFLAC_FALSE;
+        }
+      }
+
+      pFlac->pSeekIndex[count] = startPoints[iStartPoint];
+      count += 1;
     }
 
-    runningFrameBytePos = oggbs->currentBytePos -
-                          drflac_ogg__get_page_header_size(&oggbs->currentPageHeader) -
-                          oggbs->pageDataSize;
-    if (oggbs->currentPageHeader.granulePosition >= pcmFrameIndex) {
-      break; /* The sample is somewhere in the previous page. */
+    previousGranulePosition = oggbs->currentPageHeader.granulePosition;
+    nextSequenceNumber = oggbs->currentPageHeader.sequenceNumber + 1;
+  }
+
+  pFlac->seekIndexCount = count;
+  return count > 0;
+}
+
+/*
+Loads the page of the last index entry starting at or before the target. This
+fails if there's no such entry or it doesn't match the stream, in which case the
+read position is undefined.
+*/
+static bool drflac_ogg__goto_indexed_page(drflac* pFlac, uint64_t pcmFrameIndex,
+                                          drflac_seekpoint* pStartPoint) {
+  drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
+  const drflac_seekpoint* pEntry;
+  drflac_seekpoint startPoints[2];
+  uint32_t startPointCount;
+  uint32_t iStartPoint;
+  uint64_t pageBytePos;
+
+  pEntry = drflac__find_seek_index_entry(pFlac, pcmFrameIndex);
+  if (pEntry == NULL || pEntry->firstPCMFrame < oggbs->linkFirstPCMFrame) {
+    return DRFLAC_FALSE; /* Not in the current link. */
+  }
+  if (oggbs->linkPCMFrameCount > 0 &&
+      pEntry->firstPCMFrame >= oggbs->linkFirstPCMFrame + oggbs->linkPCMFrameCount) {
+    return DRFLAC_FALSE; /* In a link that hasn't been found yet. A loaded index can have these. */
+  }
+
+  *pStartPoint = *pEntry;
+  pageBytePos = oggbs->firstBytePos + pStartPoint->flacFrameOffset;
+
+  if (!drflac_oggbs__seek_physical(oggbs, pageBytePos, drflac_seek_origin_start)) {
+    return DRFLAC_FALSE;
+  }
+  if (!drflac_oggbs__goto_next_page(oggbs, drflac_ogg_fail_on_crc_mismatch) ||
+      drflac_oggbs__get_current_page_pos(oggbs) != pageBytePos) {
+    return DRFLAC_FALSE;
+  }
+
+  /* We can't check the previous page, so a start point at the beginning of the page is trusted. */
+  startPointCount = drflac_ogg__find_start_points_in_current_page(
+      oggbs, pStartPoint->firstPCMFrame - oggbs->linkFirstPCMFrame,
+      oggbs->currentPageHeader.sequenceNumber, startPoints);
+  for (iStartPoint = 0; iStartPoint < startPointCount; iStartPoint += 1) {
+    if (startPoints[iStartPoint].firstPCMFrame == pStartPoint->firstPCMFrame &&
+        startPoints[iStartPoint].pcmFrameCount == pStartPoint->pcmFrameCount) {
+      return DRFLAC_TRUE;
     }
+  }
 
-    /*
-    At this point we know the sample is not in the previous page. It could
-    possibly be in this page. For simplicity we disregard any pages that do not
-    begin a fresh packet.
-    */
-    if ((oggbs->currentPageHeader.headerType & 0x01) == 0) { /* <-- Is it a fresh page? */
-      if (oggbs->currentPageHeader.segmentTable[0] >= 2) {
-        uint8_t firstBytesInPage[2];
-        firstBytesInPage[0] = oggbs->pageData[0];
-        firstBytesInPage[1] = oggbs->pageData[1];
-
-        if ((firstBytesInPage[0] == 0xFF) &&
-            (firstBytesInPage[1] & 0xFC) ==
-                0xF8) { /* <-- Does the page begin with a frame's sync code? */
-          runningGranulePosition = oggbs->currentPageHeader.granulePosition;
-        }
+  return DRFLAC_FALSE;
+}
 
-        continue;
+/*
+Finds the first page of the current link that starts in the given byte range
+and has a granule position. The search starts at an arbitrary byte, so this
+resyncs on the capture pattern and relies on the CRC to weed out false matches.
+The current page is left untouched, but the read position is not.
+*/
+static bool drflac_ogg__probe_page(drflac_oggbs* oggbs, uint64_t rangeLo, uint64_t rangeHi,
+                                   drflac_ogg_page_header* pHeader, uint64_t* pPagePos) {
+  if (!drflac_oggbs__seek_physical(oggbs, rangeLo, drflac_seek_origin_start)) {
+    return DRFLAC_FALSE;
+  }
+
+  for (;;) {
+    uint32_t crc32 = 0;
+    uint32_t bytesRead;
+    uint32_t pageBodySize;
+    uint64_t pagePos;
+
+    if (drflac_ogg__read_page_header(oggbs->onRead, oggbs->pUserData, pHeader, &bytesRead,
+                                     &crc32) != DRFLAC_SUCCESS) {
+      return DRFLAC_FALSE;
+    }
+    oggbs->currentBytePos += bytesRead;
+
+    pagePos = oggbs->currentBytePos - drflac_ogg__get_page_header_size(pHeader);
+    if (pagePos >= rangeHi) { return DRFLAC_FALSE; }
+
+    pageBodySize = drflac_ogg__get_page_body_size(pHeader);
+    if (pageBodySize > DRFLAC_OGG_MAX_PAGE_SIZE) { continue; }
+
+    /* Header pages have a granule position of 0, and they're no use as a starting point. */
+    if (pHeader->serialNumber != oggbs->serialNumber || pHeader->granulePosition == 0 ||
+        pHeader->granulePosition == DRFLAC_OGG_NO_GRANULE_POSITION) {
+      if (pageBodySize > 0 &&
+          !drflac_oggbs__seek_physical(oggbs, pageBodySize, drflac_seek_origin_current)) {
+        return DRFLAC_FALSE;
       }
+      continue;
+    }
+
+#ifndef DR_FLAC_NO_CRC
+    {
+      uint8_t chunk[4096];
+      uint32_t bytesRemaining = pageBodySize;
+
+      while (bytesRemaining > 0) {
+        uint32_t chunkSize = (bytesRemaining < sizeof(chunk)) ? bytesRemaining : sizeof(chunk);
+        if (drflac_oggbs__read_physical(oggbs, chunk, chunkSize) != chunkSize) {
+          return DRFLAC_FALSE;
+        }
+        crc32 = drflac_crc32_buffer(crc32, chunk, chunkSize);
+        bytesRemaining -= chunkSize;
+      }
+
+      if (crc32 != pHeader->checksum) { continue; }
+    }
+#else
+    if (pageBodySize > 0 &&
+        !drflac_oggbs__seek_physical(oggbs, pageBodySize, drflac_seek_origin_current)) {
+      return DRFLAC_FALSE;
+    }
+#endif
+
+    *pPagePos = pagePos;
+    return DRFLAC_TRUE;
+  }
+}
+
+/*
+Bisects the current link for the last page that ends before the PCM frame,
+comparing granule positions, and returns its position. The frame that continues
+over the end of that page may be the one to start decoding from, so it's where
+the page scan picks up. This fails when there's no such page or the length of
+the link isn't known, in which case the read position is undefined.
+*/
+static bool drflac_ogg__bisect(drflac* pFlac, uint64_t pcmFrameIndex, uint64_t* pPagePos) {
+  drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
+  uint64_t rangeLo = oggbs->linkBytePos;
+  uint64_t rangeHi;
+  bool hasPage = DRFLAC_FALSE;
+
+  if (oggbs->linkPCMFrameCount == 0) { return DRFLAC_FALSE; }
+
+  /*
+  Like the native binary search, the end of the range is where the link would
+  end if it were uncompressed, plus a little for page headers and frames that
+  didn't compress. It doesn't need to be exact. The end of the link is known if
+  the next link has been found.
+  */
+  rangeHi = (oggbs->linkPCMFrameCount * pFlac->channels * pFlac->bitsPerSample) / 8;
+  rangeHi = oggbs->linkBytePos + rangeHi + (rangeHi / 16);
+  if (oggbs->iCurrentLink + 1 < oggbs->linkCount &&
+      oggbs->pLinks[oggbs->iCurrentLink + 1].bosPagePos < rangeHi) {
+    rangeHi = oggbs->pLinks[oggbs->iCurrentLink + 1].bosPagePos;
+  }
+
+  /* Once the range is down to about a page the caller scans the rest. */
+  while (rangeLo < rangeHi && rangeHi - rangeLo > DRFLAC_OGG_MAX_PAGE_SIZE) {
+    uint64_t rangeMid = rangeLo + ((rangeHi - rangeLo) / 2);
+    drflac_ogg_page_header header;
+    uint64_t pagePos;
+
+    if (!drflac_ogg__probe_page(oggbs, rangeMid, rangeHi, &header, &pagePos)) {
+      rangeHi = rangeMid;
+      continue;
+    }
+
+    if (oggbs->linkFirstPCMFrame + header.granulePosition <= pcmFrameIndex) {
+      *pPagePos = pagePos;
+      rangeLo = oggbs->currentBytePos;
+      hasPage = DRFLAC_TRUE;
+    } else {
+      rangeHi = pagePos;
     }
   }
 
+  return hasPage;
+}
+
+static bool drflac_ogg__seek_to_pcm_frame(drflac* pFlac, uint64_t pcmFrameIndex) {
+  drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
+  drflac_seekpoint startPoint;
+  uint64_t bisectedPagePos;
+  uint64_t originalBytePos;
+  uint64_t previousGranulePosition;
+  uint32_t nextSequenceNumber;
+  uint64_t runningPCMFrameCount;
+  uint32_t iStartPointLink = 0;
+  bool hasStartPoint = DRFLAC_FALSE;
+  bool isPageLoaded;
+
+  DRFLAC_ASSERT(oggbs != NULL);
+
+  DRFLAC_ZERO_OBJECT(&startPoint);
+  originalBytePos = oggbs->currentBytePos; /* For recovery. Points to the OggS identifier. */
+
   /*
-  We found the page that that is closest to the sample, so now we need to find
-  it. The first thing to do is seek to the start of that page. In the loop above
-  we checked that it was a fresh page which means this page is also the start of
-  a new frame. This property means that after we've seeked to the page we can
-  immediately start looping over frames until we find the one containing the
-  target sample.
+  With a chained stream we can go straight to the link the sample is in, as far
+  as we know. Links that haven't been found yet are found by the scan below.
   */
-  if (!drflac_oggbs__seek_physical(oggbs, runningFrameBytePos, drflac_seek_origin_start)) {
-    return DRFLAC_FALSE;
+  drflac_ogg__enter_link(pFlac, drflac_ogg__find_link(oggbs, pcmFrameIndex));
+
+  /*
+  If the page index has an entry before the sample we can go straight to its
+  page. Otherwise we bisect the link for the page before the sample and scan
+  from there. Failing that we start from the first frame, which begins the page
+  following the last header page.
+  */
+  drflac__reset_cache(&pFlac->bs);
+  isPageLoaded = drflac_ogg__goto_indexed_page(pFlac, pcmFrameIndex, &startPoint);
+  if (isPageLoaded) {
+    /* Set up so the entry is found again when the page is looked at below. */
+    previousGranulePosition = (startPoint.pcmFrameCount == 0)
+                                  ? startPoint.firstPCMFrame - oggbs->linkFirstPCMFrame
+                                  : DRFLAC_OGG_NO_GRANULE_POSITION;
+    nextSequenceNumber = oggbs->currentPageHeader.sequenceNumber;
+  } else if (!pFlac->_noBinarySearchSeek &&
+             drflac_ogg__bisect(pFlac, pcmFrameIndex, &bisectedPagePos)) {
+    if (!drflac_oggbs__seek_physical(oggbs, bisectedPagePos, drflac_seek_origin_start)) {
+      return DRFLAC_FALSE;
+    }
+    oggbs->bytesRemainingInPage = 0;
+
+    /* Nothing is known about the page before, so only the page's own start point is found. */
+    previousGranulePosition = DRFLAC_OGG_NO_GRANULE_POSITION;
+    nextSequenceNumber = 0;
+  } else {
+    if (!drflac__seek_to_byte(&pFlac->bs, pFlac->firstFLACFramePosInBytes)) {
+      return DRFLAC_FALSE;
+    }
+    oggbs->bytesRemainingInPage = 0;
+
+    previousGranulePosition = oggbs->currentPageHeader.granulePosition;
+    nextSequenceNumber = oggbs->currentPageHeader.sequenceNumber + 1;
+  }
+
+  /*
+  Now find the last place we can start decoding from that is at or before the
+  sample. Every one we pass is added to the page index so later seeks can skip
+  the scan.
+  */
+  for (;;) {
+    drflac_seekpoint startPoints[2];
+    uint32_t startPointCount;
+    uint32_t iStartPoint;
+    bool isPastSample = DRFLAC_FALSE;
+
+    if (!isPageLoaded &&
+        !drflac_oggbs__goto_next_page(oggbs, drflac_ogg_recover_on_crc_mismatch)) {
+      /* The sample may be in the next link. */
+      if (oggbs->hasNextLink && drflac_ogg__begin_next_link(pFlac, NULL)) {
+        previousGranulePosition = oggbs->currentPageHeader.granulePosition;
+        nextSequenceNumber = oggbs->currentPageHeader.sequenceNumber + 1;
+        continue;
+      }
+
+      drflac_oggbs__seek_physical(oggbs, originalBytePos, drflac_seek_origin_start);
+      return DRFLAC_FALSE; /* Never did find that sample... */
+    }
+    isPageLoaded = DRFLAC_FALSE;
+
+    startPointCount = drflac_ogg__find_start_points_in_current_page(
+        oggbs, previousGranulePosition, nextSequenceNumber, startPoints);
+    for (iStartPoint = 0; iStartPoint < startPointCount; iStartPoint += 1) {
+      if (startPoints[iStartPoint].firstPCMFrame > pcmFrameIndex) {
+        isPastSample = DRFLAC_TRUE;
+        break;
+      }
+
+#if DR_FLAC_SEEK_INDEX_MAX_ENTRIES > 0
+      drflac__insert_seek_index_entry(pFlac, startPoints[iStartPoint].firstPCMFrame,
+                                      startPoints[iStartPoint].flacFrameOffset,
+                                      startPoints[iStartPoint].pcmFrameCount);
+#endif
+
+      startPoint = startPoints[iStartPoint];
+      iStartPointLink = oggbs->iCurrentLink;
+      hasStartPoint = DRFLAC_TRUE;
+    }
+
+    if (isPastSample) { break; /* The sample is somewhere before this start point. */ }
+
+    previousGranulePosition = oggbs->currentPageHeader.granulePosition;
+    nextSequenceNumber = oggbs->currentPageHeader.sequenceNumber + 1;
+
+    if (hasStartPoint && previousGranulePosition != DRFLAC_OGG_NO_GRANULE_POSITION &&
+        oggbs->linkFirstPCMFrame + previousGranulePosition >= pcmFrameIndex) {
+      break; /* The sample is somewhere in this page. */
+    }
   }
-  if (!drflac_oggbs__goto_next_page(oggbs, drflac_ogg_recover_on_crc_mismatch)) {
+
+  if (!hasStartPoint) {
+    drflac_oggbs__seek_physical(oggbs, originalBytePos, drflac_seek_origin_start);
     return DRFLAC_FALSE;
   }
 
+  /*
+  We found the start point that is closest to the sample, so now we need to find
+  it. The start point is the beginning of a frame which means that once we're
+  sitting on it we can immediately start looping over frames until we find the
+  one containing the target sample. Often its page is the one already loaded.
+  */
+  if (iStartPointLink != oggbs->iCurrentLink) {
+    drflac_ogg__enter_link(pFlac, iStartPointLink);
+    oggbs->currentPageHeader.segmentCount = 0; /* Force the page to be loaded again. */
+  }
+  if (oggbs->currentPageHeader.segmentCount == 0 ||
+      drflac_oggbs__get_current_page_pos(oggbs) !=
+          oggbs->firstBytePos + startPoint.flacFrameOffset) {
+    if (!drflac_oggbs__seek_physical(oggbs, oggbs->firstBytePos + startPoint.flacFrameOffset,
+                                     drflac_seek_origin_start)) {
+      return DRFLAC_FALSE;
+    }
+    if (!drflac_oggbs__goto_next_page(oggbs, drflac_ogg_recover_on_crc_mismatch)) {
+      return DRFLAC_FALSE;
+    }
+  }
+  oggbs->bytesRemainingInPage = oggbs->pageDataSize - startPoint.pcmFrameCount;
+
+  runningPCMFrameCount = startPoint.firstPCMFrame;
+
   /*
   At this point we'll be sitting on the first byte of the frame header of the
-  first frame in the page. We just keep looping over these frames until we find
+  frame at the start point. We just keep looping over these frames until we find
   the one containing the sample we're after.
   */
-  runningPCMFrameCount = runningGranulePosition;
   for (;;) {
     /*
     There are two ways to find the sample and seek past irrelevant frames:
@@ -6200,6 +8615,11 @@ static bool drflac_ogg__seek_to_pcm_frame(drflac* pFlac, uint64_t pcmFrameIndex)
 
     if (!drflac__read_next_flac_frame_header(&pFlac->bs, pFlac->bitsPerSample,
                                              &pFlac->currentFLACFrame.header)) {
+      /* The sample may be in the next link. */
+      if (oggbs->hasNextLink && drflac_ogg__begin_next_link(pFlac, NULL)) {
+        runningPCMFrameCount = oggbs->linkFirstPCMFrame;
+        continue;
+      }
       return DRFLAC_FALSE;
     }
 
@@ -6363,6 +8783,7 @@ static bool drflac__init_private__ogg(drflac_init_info* pInit, drflac_read_proc
               pInit->channels = streaminfo.channels;
               pInit->bitsPerSample = streaminfo.bitsPerSample;
               pInit->totalPCMFrameCount = streaminfo.totalPCMFrameCount;
+              DRFLAC_COPY_MEMORY(pInit->md5, streaminfo.md5, sizeof(pInit->md5));
               pInit->maxBlockSizeInPCMFrames = streaminfo.maxBlockSizeInPCMFrames;
               pInit->hasMetadataBlocks = !isLastBlock;
 
@@ -6449,6 +8870,8 @@ static bool drflac__init_private(drflac_init_info* pInit, drflac_read_proc onRea
   pInit->bs.onRead = onRead;
   pInit->bs.onSeek = onSeek;
   pInit->bs.pUserData = pUserData;
+  pInit->bs.cacheL2 = pInit->cacheL2;
+  pInit->bs.cacheL2LineCount = sizeof(pInit->cacheL2) / sizeof(pInit->cacheL2[0]);
   drflac__reset_cache(&pInit->bs);
 
   /* If the container is explicitly defined then we can try opening in relaxed
@@ -6513,6 +8936,24 @@ static bool drflac__init_private(drflac_init_info* pInit, drflac_read_proc onRea
   return DRFLAC_FALSE;
 }
 
+#ifndef DR_FLAC_NO_OGG
+static void drflac__init_oggbs(drflac_oggbs* pOggbs, const drflac_init_info* pInit) {
+  DRFLAC_ZERO_MEMORY(pOggbs, sizeof(*pOggbs));
+  if (pInit->container == drflac_container_ogg) {
+    pOggbs->onRead = pInit->onRead;
+    pOggbs->onSeek = pInit->onSeek;
+    pOggbs->pUserData = pInit->pUserData;
+    pOggbs->currentBytePos = pInit->runningFilePos; /* The bos page has already been read. */
+    pOggbs->firstBytePos = pInit->oggFirstBytePos;
+    pOggbs->linkBytePos = pInit->oggFirstBytePos;
+    pOggbs->linkPCMFrameCount = pInit->totalPCMFrameCount;
+    pOggbs->serialNumber = pInit->oggSerial;
+    pOggbs->bosPageHeader = pInit->oggBosHeader;
+    pOggbs->bytesRemainingInPage = 0;
+  }
+}
+#endif
+
 static void drflac__init_from_info(drflac* pFlac, const drflac_init_info* pInit) {
   DRFLAC_ASSERT(pFlac != NULL);
   DRFLAC_ASSERT(pInit != NULL);
@@ -6527,51 +8968,127 @@ static void drflac__init_from_info(drflac* pFlac, const drflac_init_info* pInit)
   pFlac->bitsPerSample = (uint8_t)pInit->bitsPerSample;
   pFlac->totalPCMFrameCount = pInit->totalPCMFrameCount;
   pFlac->container = pInit->container;
+  DRFLAC_COPY_MEMORY(pFlac->md5, pInit->md5, sizeof(pFlac->md5));
 }
 
-static drflac*
-drflac_open_with_metadata_private(drflac_read_proc onRead, drflac_seek_proc onSeek,
-                                  drflac_meta_proc onMeta, drflac_container container,
-                                  void* pUserData, void* pUserDataMD,
-                                  const drlibs_allocation_callbacks* pAllocationCallbacks) {
-  drflac_init_info init;
-  uint32_t allocationSize;
-  uint32_t wholeSIMDVectorCountPerChannel;
-  uint32_t decodedSamplesAllocationSize;
-#ifndef DR_FLAC_NO_OGG
-  drflac_oggbs oggbs;
-#endif
-  uint64_t firstFramePos;
-  uint64_t seektablePos;
-  uint32_t seektableSize;
-  drlibs_allocation_callbacks allocationCallbacks;
-  drflac* pFlac;
+/*
+Decoders living in caller provided memory are opened with allocation callbacks
+that hand out that memory, one allocation at a time. Metadata blocks are loaded
+into it before the decoder itself. When pMemory is NULL nothing is handed out
+and the size of the last request is recorded instead, along with the size of
+the largest metadata block.
+*/
+typedef struct {
+  void* pMemory;
+  size_t sizeInBytes;
+  size_t lastRequestSize;
+  uint32_t largestMetadataBlockSize;
+  bool isInUse;
+} drflac__preallocation;
+
+static void* drflac__malloc_preallocated(size_t sz, void* pUserData) {
+  drflac__preallocation* pPreallocation = (drflac__preallocation*)pUserData;
+
+  pPreallocation->lastRequestSize = sz;
+  if (pPreallocation->pMemory == NULL || pPreallocation->isInUse ||
+      sz > pPreallocation->sizeInBytes) {
+    return NULL;
+  }
+
+  pPreallocation->isInUse = DRFLAC_TRUE;
+  return pPreallocation->pMemory;
+}
+
+static void drflac__free_preallocated(void* p, void* pUserData) {
+  drflac__preallocation* pPreallocation = (drflac__preallocation*)pUserData;
+  if (p == pPreallocation->pMemory) { pPreallocation->isInUse = DRFLAC_FALSE; }
+}
+
+/* Once opened, a decoder in caller provided memory never allocates again. */
+static void* drflac__malloc_none(size_t sz, void* pUserData) {
+  (void)sz;
+  (void)pUserData;
+  return NULL;
+}
+
+static void drflac__free_none(void* p, void* pUserData) {
+  (void)p;
+  (void)pUserData;
+}
+
+static drflac*
+drflac_open_with_metadata_private(drflac_read_proc onRead, drflac_seek_proc onSeek,
+                                  drflac_meta_proc onMeta, drflac_container container,
+                                  void* pUserData, void* pUserDataMD, size_t bufferSizeInBytes,
+                                  drflac* pReuse,
+                                  const drlibs_allocation_callbacks* pAllocationCallbacks) {
+  drflac_init_info init;
+  uint32_t allocationSize;
+  uint32_t decodedSamplesAllocationSize;
+  uint32_t cacheL2LineCount;
+  uint32_t cacheL2LinesRemaining;
+  uint32_t cacheL2AllocationSize;
+#ifndef DR_FLAC_NO_OGG
+  drflac_oggbs oggbs;
+#endif
+  uint64_t firstFramePos;
+  uint64_t seektablePos;
+  uint32_t seektableSize;
+  drlibs_allocation_callbacks allocationCallbacks;
+  drflac* pFlac;
+  drflac_seekpoint* pSeekIndex;
+  uint32_t seekIndexCapacity;
+  drflac__preallocation reusePreallocation;
+  drlibs_allocation_callbacks reuseAllocationCallbacks;
+
+  /*
+  When pReuse is set its stream has already been released and we own it from
+  here on. It's freed on failure so that the caller only ever has to deal with
+  the returned decoder.
+  */
+
+  /*
+  A decoder in caller provided memory is reopened the same way it was opened,
+  with metadata blocks loaded into its memory before the decoder. It can't have
+  a seek index or extra links, so there's nothing else to keep.
+  */
+  if (pReuse != NULL && pReuse->allocationCallbacks.onMalloc == drflac__malloc_none) {
+    DRFLAC_ZERO_OBJECT(&reusePreallocation);
+    reusePreallocation.pMemory = pReuse;
+    reusePreallocation.sizeInBytes = pReuse->allocationSize;
+    reuseAllocationCallbacks.pUserData = &reusePreallocation;
+    reuseAllocationCallbacks.onMalloc = drflac__malloc_preallocated;
+    reuseAllocationCallbacks.onRealloc = NULL;
+    reuseAllocationCallbacks.onFree = drflac__free_preallocated;
+    pAllocationCallbacks = &reuseAllocationCallbacks;
+    pReuse = NULL;
+  }
 
   /* CPU support first. */
   drflac__init_cpu_caps();
 
+  if (bufferSizeInBytes == 0) { bufferSizeInBytes = DR_FLAC_BUFFER_SIZE; }
+  if (bufferSizeInBytes > DRFLAC_MAX_BUFFER_SIZE) {
+    drflac__free_decoder(pReuse);
+    return NULL;
+  }
+
   if (!drflac__init_private(&init, onRead, onSeek, onMeta, container, pUserData, pUserDataMD)) {
+    drflac__free_decoder(pReuse);
     return NULL;
   }
 
-  if (pAllocationCallbacks != NULL) {
-    allocationCallbacks = *pAllocationCallbacks;
-    if (allocationCallbacks.onFree == NULL ||
-        (allocationCallbacks.onMalloc == NULL && allocationCallbacks.onRealloc == NULL)) {
-      return NULL; /* Invalid allocation callbacks. */
-    }
-  } else {
-    allocationCallbacks.pUserData = NULL;
-    allocationCallbacks.onMalloc = drflac__malloc_default;
-    allocationCallbacks.onRealloc = drflac__realloc_default;
-    allocationCallbacks.onFree = drflac__free_default;
+  if (!drflac__copy_allocation_callbacks_or_defaults(pAllocationCallbacks, &allocationCallbacks)) {
+    drflac__free_decoder(pReuse);
+    return NULL; /* Invalid allocation callbacks. */
   }
 
   /*
   The size of the allocation for the drflac object needs to be large enough to
   fit the following: 1) The main members of the drflac structure 2) A block of
   memory large enough to store the decoded samples of the largest frame in the
-  stream 3) If the container is Ogg, a drflac_oggbs object
+  stream 3) The L2 cache of the bit streamer 4) If the container is Ogg, a
+  drflac_oggbs object
 
   The complicated part of the allocation is making sure there's enough room the
   decoded samples, taking into consideration the different SIMD instruction
@@ -6579,40 +9096,31 @@ drflac_open_with_metadata_private(drflac_read_proc onRead, drflac_seek_proc onSe
   */
   allocationSize = sizeof(drflac);
 
-  /*
-  The allocation size for decoded frames depends on the number of 32-bit
-  integers that fit inside the largest SIMD vector we are supporting.
-  */
-  if ((init.maxBlockSizeInPCMFrames % (DRFLAC_MAX_SIMD_VECTOR_SIZE / sizeof(int32_t))) == 0) {
-    wholeSIMDVectorCountPerChannel =
-        (init.maxBlockSizeInPCMFrames / (DRFLAC_MAX_SIMD_VECTOR_SIZE / sizeof(int32_t)));
-  } else {
-    wholeSIMDVectorCountPerChannel =
-        (init.maxBlockSizeInPCMFrames / (DRFLAC_MAX_SIMD_VECTOR_SIZE / sizeof(int32_t))) + 1;
-  }
-
   decodedSamplesAllocationSize =
-      wholeSIMDVectorCountPerChannel * DRFLAC_MAX_SIMD_VECTOR_SIZE * init.channels;
+      drflac__get_decoded_samples_allocation_size(init.maxBlockSizeInPCMFrames, init.channels);
 
   allocationSize += decodedSamplesAllocationSize;
   allocationSize += DRFLAC_MAX_SIMD_VECTOR_SIZE; /* Allocate extra bytes to ensure we have
                                                     enough for alignment. */
 
+  /*
+  The L2 cache is rounded down to whole cache lines. Relaxed initialization may
+  have already buffered part of the first frame in the temporary L2 cache so we
+  need to make sure there's enough room to carry that over.
+  */
+  cacheL2LineCount = (uint32_t)(bufferSizeInBytes / sizeof(drflac_cache_t));
+  cacheL2LinesRemaining = (uint32_t)DRFLAC_CACHE_L2_LINES_REMAINING(&init.bs);
+  if (cacheL2LineCount < cacheL2LinesRemaining) { cacheL2LineCount = cacheL2LinesRemaining; }
+  if (cacheL2LineCount == 0) { cacheL2LineCount = 1; }
+
+  cacheL2AllocationSize = cacheL2LineCount * sizeof(drflac_cache_t);
+  allocationSize += cacheL2AllocationSize;
+
 #ifndef DR_FLAC_NO_OGG
   /* There's additional data required for Ogg streams. */
   if (init.container == drflac_container_ogg) { allocationSize += sizeof(drflac_oggbs); }
 
-  DRFLAC_ZERO_MEMORY(&oggbs, sizeof(oggbs));
-  if (init.container == drflac_container_ogg) {
-    oggbs.onRead = onRead;
-    oggbs.onSeek = onSeek;
-    oggbs.pUserData = pUserData;
-    oggbs.currentBytePos = init.oggFirstBytePos;
-    oggbs.firstBytePos = init.oggFirstBytePos;
-    oggbs.serialNumber = init.oggSerial;
-    oggbs.bosPageHeader = init.oggBosHeader;
-    oggbs.bytesRemainingInPage = 0;
-  }
+  drflac__init_oggbs(&oggbs, &init);
 #endif
 
   /*
@@ -6628,36 +9136,88 @@ drflac_open_with_metadata_private(drflac_read_proc onRead, drflac_seek_proc onSe
     drflac_read_proc onReadOverride = onRead;
     drflac_seek_proc onSeekOverride = onSeek;
     void* pUserDataOverride = pUserData;
+    uint32_t lazyPictureDataSize = DRFLAC_LAZY_PICTURE_SIZE;
+    uint32_t* pLargestBlockSize = NULL;
+
+    /* Sizing up caller provided memory, which needs to fit each block for a metadata callback. */
+    if (allocationCallbacks.onMalloc == drflac__malloc_preallocated) {
+      pLargestBlockSize =
+          &((drflac__preallocation*)allocationCallbacks.pUserData)->largestMetadataBlockSize;
+    }
 
 #ifndef DR_FLAC_NO_OGG
     if (init.container == drflac_container_ogg) {
       onReadOverride = drflac__on_read_ogg;
       onSeekOverride = drflac__on_seek_ogg;
       pUserDataOverride = (void*)&oggbs;
+
+      /* Picture data can't be found again later in an Ogg stream so it has to be loaded now. */
+      lazyPictureDataSize = 0xFFFFFFFF;
     }
 #endif
 
     if (!drflac__read_and_decode_metadata(onReadOverride, onSeekOverride, onMeta, pUserDataOverride,
                                           pUserDataMD, &firstFramePos, &seektablePos,
-                                          &seektableSize, &allocationCallbacks)) {
+                                          &seektableSize, lazyPictureDataSize, pLargestBlockSize,
+                                          &allocationCallbacks)) {
+      drflac__free_decoder(pReuse);
       return NULL;
     }
 
     allocationSize += seektableSize;
   }
 
-  pFlac = (drflac*)drflac__malloc_from_callbacks(allocationSize, &allocationCallbacks);
-  if (pFlac == NULL) { return NULL; }
+  /*
+  A decoder that's being reused keeps its allocation if the new stream fits,
+  otherwise it's grown. The seek index is kept as well, but emptied.
+  */
+  if (pReuse != NULL) {
+#ifndef DR_FLAC_NO_OGG
+    drflac_ogg__free_links(pReuse);
+#endif
+    pSeekIndex = pReuse->pSeekIndex;
+    seekIndexCapacity = pReuse->seekIndexCapacity;
+
+    if (pReuse->allocationSize >= allocationSize) {
+      allocationSize = pReuse->allocationSize;
+      pFlac = pReuse;
+    } else {
+      pFlac = (drflac*)drflac__realloc_from_callbacks(pReuse, allocationSize, 0,
+                                                      &allocationCallbacks);
+      if (pFlac == NULL) {
+        drflac__free_decoder(pReuse);
+        return NULL;
+      }
+    }
+  } else {
+    pSeekIndex = NULL;
+    seekIndexCapacity = 0;
+
+    pFlac = (drflac*)drflac__malloc_from_callbacks(allocationSize, &allocationCallbacks);
+    if (pFlac == NULL) { return NULL; }
+  }
 
   drflac__init_from_info(pFlac, &init);
   pFlac->allocationCallbacks = allocationCallbacks;
+  pFlac->allocationSize = allocationSize;
+  pFlac->pSeekIndex = pSeekIndex;
+  pFlac->seekIndexCapacity = seekIndexCapacity;
   pFlac->pDecodedSamples =
       (int32_t*)drflac_align((size_t)pFlac->pExtraData, DRFLAC_MAX_SIMD_VECTOR_SIZE);
 
+  /* Move the bit streamer over to its own L2 cache, keeping anything that's still unread. */
+  pFlac->bs.cacheL2 =
+      (drflac_cache_t*)((uint8_t*)pFlac->pDecodedSamples + decodedSamplesAllocationSize);
+  pFlac->bs.cacheL2LineCount = cacheL2LineCount;
+  pFlac->bs.nextL2Line = cacheL2LineCount - cacheL2LinesRemaining;
+  DRFLAC_COPY_MEMORY(pFlac->bs.cacheL2 + pFlac->bs.nextL2Line, init.bs.cacheL2 + init.bs.nextL2Line,
+                     cacheL2LinesRemaining * sizeof(drflac_cache_t));
+
 #ifndef DR_FLAC_NO_OGG
   if (init.container == drflac_container_ogg) {
-    drflac_oggbs* pInternalOggbs = (drflac_oggbs*)((uint8_t*)pFlac->pDecodedSamples +
-                                                   decodedSamplesAllocationSize + seektableSize);
+    drflac_oggbs* pInternalOggbs =
+        (drflac_oggbs*)((uint8_t*)pFlac->pDecodedSamples + decodedSamplesAllocationSize +
+                        cacheL2AllocationSize + seektableSize);
     *pInternalOggbs = oggbs;
 
     /* The Ogg bistream needs to be layered on top of the original bitstream. */
@@ -6684,8 +9244,8 @@ drflac_open_with_metadata_private(drflac_read_proc onRead, drflac_seek_proc onSe
      * to where we were previously. */
     if (seektablePos != 0) {
       pFlac->seekpointCount = seektableSize / sizeof(*pFlac->pSeekpoints);
-      pFlac->pSeekpoints =
-          (drflac_seekpoint*)((uint8_t*)pFlac->pDecodedSamples + decodedSamplesAllocationSize);
+      pFlac->pSeekpoints = (drflac_seekpoint*)((uint8_t*)pFlac->pDecodedSamples +
+                                               decodedSamplesAllocationSize + cacheL2AllocationSize);
 
       DRFLAC_ASSERT(pFlac->bs.onSeek != NULL);
       DRFLAC_ASSERT(pFlac->bs.onRead != NULL);
@@ -6715,7 +9275,7 @@ drflac_open_with_metadata_private(drflac_read_proc onRead, drflac_seek_proc onSe
          * error. */
         if (!pFlac->bs.onSeek(pFlac->bs.pUserData, (int)pFlac->firstFLACFramePosInBytes,
                               drflac_seek_origin_start)) {
-          drflac__free_from_callbacks(pFlac, &allocationCallbacks);
+          drflac__free_decoder(pFlac);
           return NULL;
         }
       } else {
@@ -6727,6 +9287,10 @@ drflac_open_with_metadata_private(drflac_read_proc onRead, drflac_seek_proc onSe
     }
   }
 
+  /* The bit streamer's cache is empty at this point and the client is sitting
+   * on the first frame. */
+  pFlac->bs.clientBytePos = pFlac->firstFLACFramePosInBytes;
+
   /*
   If we get here, but don't have a STREAMINFO block, it means we've opened the
   stream in relaxed mode and need to decode the first frame.
@@ -6741,21 +9305,149 @@ drflac_open_with_metadata_private(drflac_read_proc onRead, drflac_seek_proc onSe
         if (result == DRFLAC_CRC_MISMATCH) {
           if (!drflac__read_next_flac_frame_header(&pFlac->bs, pFlac->bitsPerSample,
                                                    &pFlac->currentFLACFrame.header)) {
-            drflac__free_from_callbacks(pFlac, &allocationCallbacks);
+            drflac__free_decoder(pFlac);
             return NULL;
           }
           continue;
         } else {
-          drflac__free_from_callbacks(pFlac, &allocationCallbacks);
+          drflac__free_decoder(pFlac);
           return NULL;
         }
       }
     }
   }
 
+  /*
+  The whole of the caller provided memory belongs to the decoder, which lets
+  drflac_reopen() make use of all of it. From here on it never allocates.
+  */
+  if (allocationCallbacks.onMalloc == drflac__malloc_preallocated) {
+    size_t memorySizeInBytes =
+        ((drflac__preallocation*)allocationCallbacks.pUserData)->sizeInBytes;
+    pFlac->allocationSize = ((uint64_t)memorySizeInBytes > 0xFFFFFFFF)
+                                ? 0xFFFFFFFF
+                                : (uint32_t)memorySizeInBytes;
+    pFlac->allocationCallbacks.pUserData = NULL;
+    pFlac->allocationCallbacks.onMalloc = drflac__malloc_none;
+    pFlac->allocationCallbacks.onRealloc = NULL;
+    pFlac->allocationCallbacks.onFree = drflac__free_none;
+  }
+
   return pFlac;
 }
 
+typedef struct {
+  drflac_meta_proc onMeta;
+  void* pUserDataMD;
+  drflac_streaminfo streaminfo;
+  bool hasStreamInfo;
+} drflac__probe_context;
+
+static void drflac__on_meta_probe(void* pUserData, drflac_metadata* pMetadata) {
+  drflac__probe_context* pContext = (drflac__probe_context*)pUserData;
+
+  if (pMetadata->type == DRFLAC_METADATA_BLOCK_TYPE_STREAMINFO) {
+    pContext->streaminfo = pMetadata->data.streaminfo;
+    pContext->hasStreamInfo = DRFLAC_TRUE;
+  }
+
+  if (pContext->onMeta != NULL) { pContext->onMeta(pContext->pUserDataMD, pMetadata); }
+}
+
+static bool drflac__probe_private(drflac_read_proc onRead, drflac_seek_proc onSeek,
+                                  drflac_meta_proc onMeta, void* pUserData, void* pUserDataMD,
+                                  drflac_streaminfo* pStreamInfo,
+                                  const drlibs_allocation_callbacks* pAllocationCallbacks) {
+  drflac_init_info init;
+  drflac__probe_context context;
+  drlibs_allocation_callbacks allocationCallbacks;
+  drflac_read_proc onReadOverride = onRead;
+  drflac_seek_proc onSeekOverride = onSeek;
+  void* pUserDataOverride = pUserData;
+  uint64_t firstFramePos;
+  uint64_t seektablePos;
+  uint32_t seektableSize;
+#ifndef DR_FLAC_NO_OGG
+  drflac_oggbs oggbs;
+#endif
+
+  if (pStreamInfo != NULL) { DRFLAC_ZERO_MEMORY(pStreamInfo, sizeof(*pStreamInfo)); }
+
+  if (!drflac__copy_allocation_callbacks_or_defaults(pAllocationCallbacks, &allocationCallbacks)) {
+    return DRFLAC_FALSE;
+  }
+
+  /* The STREAMINFO block is read during initialization. We hook into the metadata callback to grab
+   * all of it rather than just what the decoder needs. */
+  DRFLAC_ZERO_MEMORY(&context, sizeof(context));
+  context.onMeta = onMeta;
+  context.pUserDataMD = pUserDataMD;
+  if (!drflac__init_private(&init, onRead, onSeek, drflac__on_meta_probe, drflac_container_unknown,
+                            pUserData, &context)) {
+    return DRFLAC_FALSE;
+  }
+
+  if (!context.hasStreamInfo) { return DRFLAC_FALSE; }
+
+  /* Nothing is loaded for the remaining blocks unless the caller wants to see them. */
+  if (onMeta != NULL && init.hasMetadataBlocks) {
+#ifndef DR_FLAC_NO_OGG
+    if (init.container == drflac_container_ogg) {
+      drflac__init_oggbs(&oggbs, &init);
+      onReadOverride = drflac__on_read_ogg;
+      onSeekOverride = drflac__on_seek_ogg;
+      pUserDataOverride = (void*)&oggbs;
+    }
+#endif
+
+    if (!drflac__read_and_decode_metadata(onReadOverride, onSeekOverride, onMeta, pUserDataOverride,
+                                          pUserDataMD, &firstFramePos, &seektablePos,
+                                          &seektableSize, 0, NULL, &allocationCallbacks)) {
+      return DRFLAC_FALSE;
+    }
+  }
+
+  if (pStreamInfo != NULL) { *pStreamInfo = context.streaminfo; }
+  return DRFLAC_TRUE;
+}
+
+DRFLAC_API bool drflac_probe(drflac_read_proc onRead, drflac_seek_proc onSeek,
+                             drflac_meta_proc onMeta, void* pUserData,
+                             drflac_streaminfo* pStreamInfo,
+                             const drlibs_allocation_callbacks* pAllocationCallbacks) {
+  return drflac__probe_private(onRead, onSeek, onMeta, pUserData, pUserData, pStreamInfo,
+                               pAllocationCallbacks);
+}
+
+DRFLAC_API size_t drflac_read_picture_data(drflac* pFlac, uint64_t pictureDataOffset,
+                                           void* pBufferOut, size_t bytesToRead) {
+  uint64_t clientBytePos;
+  size_t bytesRead;
+
+  if (pFlac == NULL || pBufferOut == NULL || pictureDataOffset == 0) { return 0; }
+
+#ifndef DR_FLAC_NO_OGG
+  if (pFlac->container == drflac_container_ogg) { return 0; }
+#endif
+
+  /*
+  This goes straight to the client, bypassing the bit streamer. Its cache stays
+  valid so long as the client is put back where it was afterwards.
+  */
+  clientBytePos = pFlac->bs.clientBytePos;
+  if (!drflac__seek_client_to_byte(pFlac->bs.onSeek, pFlac->bs.pUserData, pictureDataOffset)) {
+    return 0;
+  }
+
+  bytesRead = pFlac->bs.onRead(pFlac->bs.pUserData, pBufferOut, bytesToRead);
+
+  if (!drflac__seek_client_to_byte(pFlac->bs.onSeek, pFlac->bs.pUserData, clientBytePos)) {
+    return 0;
+  }
+
+  return bytesRead;
+}
+
 #ifndef DR_FLAC_NO_STDIO
 #include <stdio.h>
 #include <wchar.h> /* For wcslen(), wcsrtombs() */
@@ -7351,8 +10043,8 @@ drflac_open_file_with_metadata(const char* pFileName, drflac_meta_proc onMeta, v
   if (drflac_fopen(&pFile, pFileName, "rb") != DRFLAC_SUCCESS) { return NULL; }
 
   pFlac = drflac_open_with_metadata_private(drflac__on_read_stdio, drflac__on_seek_stdio, onMeta,
-                                            drflac_container_unknown, (void*)pFile, pUserData,
-                                            pAllocationCallbacks);
+                                            drflac_container_unknown, (void*)pFile, pUserData, 0,
+                                            NULL, pAllocationCallbacks);
   if (pFlac == NULL) {
     fclose(pFile);
     return pFlac;
@@ -7371,9 +10063,29 @@ drflac_open_file_with_metadata_w(const wchar_t* pFileName, drflac_meta_proc onMe
     return NULL;
   }
 
+  pFlac = drflac_open_with_metadata_private(drflac__on_read_stdio, drflac__on_seek_stdio, onMeta,
+                                            drflac_container_unknown, (void*)pFile, pUserData, 0,
+                                            NULL, pAllocationCallbacks);
+  if (pFlac == NULL) {
+    fclose(pFile);
+    return pFlac;
+  }
+
+  return pFlac;
+}
+
+DRFLAC_API drflac*
+drflac_open_file_with_buffer_size(const char* pFileName, drflac_meta_proc onMeta, void* pUserData,
+                                  size_t bufferSizeInBytes,
+                                  const drlibs_allocation_callbacks* pAllocationCallbacks) {
+  drflac* pFlac;
+  FILE* pFile;
+
+  if (drflac_fopen(&pFile, pFileName, "rb") != DRFLAC_SUCCESS) { return NULL; }
+
   pFlac = drflac_open_with_metadata_private(drflac__on_read_stdio, drflac__on_seek_stdio, onMeta,
                                             drflac_container_unknown, (void*)pFile, pUserData,
-                                            pAllocationCallbacks);
+                                            bufferSizeInBytes, NULL, pAllocationCallbacks);
   if (pFlac == NULL) {
     fclose(pFile);
     return pFlac;
@@ -7381,6 +10093,23 @@ drflac_open_file_with_metadata_w(const wchar_t* pFileName, drflac_meta_proc onMe
 
   return pFlac;
 }
+
+DRFLAC_API bool drflac_probe_file(const char* pFileName, drflac_meta_proc onMeta, void* pUserData,
+                                  drflac_streaminfo* pStreamInfo,
+                                  const drlibs_allocation_callbacks* pAllocationCallbacks) {
+  FILE* pFile;
+  bool result;
+
+  if (pStreamInfo != NULL) { DRFLAC_ZERO_MEMORY(pStreamInfo, sizeof(*pStreamInfo)); }
+
+  if (drflac_fopen(&pFile, pFileName, "rb") != DRFLAC_SUCCESS) { return DRFLAC_FALSE; }
+
+  result = drflac__probe_private(drflac__on_read_stdio, drflac__on_seek_stdio, onMeta,
+                                 (void*)pFile, pUserData, pStreamInfo, pAllocationCallbacks);
+
+  fclose(pFile);
+  return result;
+}
 #endif /* DR_FLAC_NO_STDIO */
 
 static size_t drflac__on_read_memory(void* pUserData, void* bufferOut, size_t bytesToRead) {
@@ -7427,16 +10156,20 @@ static bool drflac__on_seek_memory(void* pUserData, int offset,
   return DRFLAC_TRUE;
 }
 
-DRFLAC_API drflac* drflac_open_memory(const void* pData, size_t dataSize,
-                                      const drlibs_allocation_callbacks* pAllocationCallbacks) {
+static drflac*
+drflac__open_memory_private(const void* pData, size_t dataSize, drflac_meta_proc onMeta,
+                            void* pUserData, size_t bufferSizeInBytes, drflac* pReuse,
+                            const drlibs_allocation_callbacks* pAllocationCallbacks) {
   drflac__memory_stream memoryStream;
   drflac* pFlac;
 
   memoryStream.data = (const uint8_t*)pData;
   memoryStream.dataSize = dataSize;
   memoryStream.currentReadPos = 0;
-  pFlac = drflac_open(drflac__on_read_memory, drflac__on_seek_memory, &memoryStream,
-                      pAllocationCallbacks);
+  pFlac = drflac_open_with_metadata_private(drflac__on_read_memory, drflac__on_seek_memory, onMeta,
+                                            drflac_container_unknown, &memoryStream,
+                                            (onMeta != NULL) ? pUserData : &memoryStream,
+                                            bufferSizeInBytes, pReuse, pAllocationCallbacks);
   if (pFlac == NULL) { return NULL; }
 
   pFlac->memoryStream = memoryStream;
@@ -7446,56 +10179,175 @@ DRFLAC_API drflac* drflac_open_memory(const void* pData, size_t dataSize,
   if (pFlac->container == drflac_container_ogg) {
     drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
     oggbs->pUserData = &pFlac->memoryStream;
+
+    /*
+    From here on page bodies are used in place so they're copied once, straight
+    into the bit streamer's cache. The current page stays in pageData.
+    */
+    oggbs->pMemoryStream = &pFlac->memoryStream;
   } else
 #endif
   {
     pFlac->bs.pUserData = &pFlac->memoryStream;
+
+    /*
+    Anything already sitting in the L2 cache came from before the current read
+    position so it's safe to switch over to direct reads at this point.
+    */
+    pFlac->bs.pDirectStream = &pFlac->memoryStream;
   }
 
   return pFlac;
 }
 
+DRFLAC_API drflac* drflac_open_memory(const void* pData, size_t dataSize,
+                                      const drlibs_allocation_callbacks* pAllocationCallbacks) {
+  return drflac__open_memory_private(pData, dataSize, NULL, NULL, 0, NULL, pAllocationCallbacks);
+}
+
 DRFLAC_API drflac*
 drflac_open_memory_with_metadata(const void* pData, size_t dataSize, drflac_meta_proc onMeta,
                                  void* pUserData,
                                  const drlibs_allocation_callbacks* pAllocationCallbacks) {
+  return drflac__open_memory_private(pData, dataSize, onMeta, pUserData, 0, NULL,
+                                     pAllocationCallbacks);
+}
+
+DRFLAC_API bool drflac_probe_memory(const void* pData, size_t dataSize, drflac_meta_proc onMeta,
+                                    void* pUserData, drflac_streaminfo* pStreamInfo,
+                                    const drlibs_allocation_callbacks* pAllocationCallbacks) {
   drflac__memory_stream memoryStream;
-  drflac* pFlac;
 
   memoryStream.data = (const uint8_t*)pData;
   memoryStream.dataSize = dataSize;
   memoryStream.currentReadPos = 0;
-  pFlac = drflac_open_with_metadata_private(drflac__on_read_memory, drflac__on_seek_memory, onMeta,
-                                            drflac_container_unknown, &memoryStream, pUserData,
-                                            pAllocationCallbacks);
-  if (pFlac == NULL) { return NULL; }
+  return drflac__probe_private(drflac__on_read_memory, drflac__on_seek_memory, onMeta,
+                               &memoryStream, pUserData, pStreamInfo, pAllocationCallbacks);
+}
 
-  pFlac->memoryStream = memoryStream;
+#if defined(DRFLAC_HAS_MMAP)
+static drflac_result drflac__map_file(const char* pFilePath, const void** ppData,
+                                      size_t* pDataSize) {
+  DRFLAC_ASSERT(ppData != NULL);
+  DRFLAC_ASSERT(pDataSize != NULL);
 
-  /* This is an awful hack... */
-#ifndef DR_FLAC_NO_OGG
-  if (pFlac->container == drflac_container_ogg) {
-    drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
-    oggbs->pUserData = &pFlac->memoryStream;
-  } else
-#endif
+  *ppData = NULL;
+  *pDataSize = 0;
+
+  if (pFilePath == NULL) { return DRFLAC_INVALID_ARGS; }
+
+#if defined(_WIN32)
   {
-    pFlac->bs.pUserData = &pFlac->memoryStream;
+    HANDLE hFile;
+    HANDLE hMapping;
+    LARGE_INTEGER fileSize;
+    void* pData;
+
+    hFile = CreateFileA(pFilePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) { return DRFLAC_DOES_NOT_EXIST; }
+
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0 ||
+        (uint64_t)fileSize.QuadPart > DRFLAC_SIZE_MAX) {
+      CloseHandle(hFile);
+      return DRFLAC_ERROR;
+    }
+
+    hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(hFile);
+    if (hMapping == NULL) { return DRFLAC_ERROR; }
+
+    /* The view holds its own reference to the mapping so the handle can go. */
+    pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(hMapping);
+    if (pData == NULL) { return DRFLAC_ERROR; }
+
+    *ppData = pData;
+    *pDataSize = (size_t)fileSize.QuadPart;
+  }
+#else
+  {
+    int fd;
+    struct stat info;
+    void* pData;
+
+    fd = open(pFilePath, O_RDONLY);
+    if (fd == -1) { return drflac_result_from_errno(errno); }
+
+    if (fstat(fd, &info) != 0 || info.st_size <= 0 || (uint64_t)info.st_size > DRFLAC_SIZE_MAX) {
+      close(fd);
+      return DRFLAC_ERROR;
+    }
+
+    pData = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pData == MAP_FAILED) { return DRFLAC_ERROR; }
+
+#if defined(POSIX_MADV_SEQUENTIAL)
+    posix_madvise(pData, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+
+    *ppData = pData;
+    *pDataSize = (size_t)info.st_size;
+  }
+#endif
+
+  return DRFLAC_SUCCESS;
+}
+
+static void drflac__unmap_file(const void* pData, size_t dataSize) {
+#if defined(_WIN32)
+  (void)dataSize;
+  UnmapViewOfFile(pData);
+#else
+  munmap((void*)pData, dataSize);
+#endif
+}
+#endif
+
+#ifndef DR_FLAC_NO_STDIO
+DRFLAC_API drflac*
+drflac_open_file_mmap_with_metadata(const char* pFileName, drflac_meta_proc onMeta,
+                                    void* pUserData,
+                                    const drlibs_allocation_callbacks* pAllocationCallbacks) {
+#if defined(DRFLAC_HAS_MMAP)
+  drflac* pFlac;
+  const void* pData;
+  size_t dataSize;
+
+  if (drflac__map_file(pFileName, &pData, &dataSize) != DRFLAC_SUCCESS) { return NULL; }
+
+  pFlac = drflac__open_memory_private(pData, dataSize, onMeta, pUserData, 0, NULL,
+                                      pAllocationCallbacks);
+  if (pFlac == NULL) {
+    drflac__unmap_file(pData, dataSize);
+    return NULL;
   }
 
+  pFlac->_isMappedFile = DRFLAC_TRUE;
   return pFlac;
+#else
+  if (onMeta == NULL) { return drflac_open_file(pFileName, pAllocationCallbacks); }
+  return drflac_open_file_with_metadata(pFileName, onMeta, pUserData, pAllocationCallbacks);
+#endif
+}
+
+DRFLAC_API drflac* drflac_open_file_mmap(const char* pFileName,
+                                         const drlibs_allocation_callbacks* pAllocationCallbacks) {
+  return drflac_open_file_mmap_with_metadata(pFileName, NULL, NULL, pAllocationCallbacks);
 }
+#endif
 
 DRFLAC_API drflac* drflac_open(drflac_read_proc onRead, drflac_seek_proc onSeek, void* pUserData,
                                const drlibs_allocation_callbacks* pAllocationCallbacks) {
   return drflac_open_with_metadata_private(onRead, onSeek, NULL, drflac_container_unknown,
-                                           pUserData, pUserData, pAllocationCallbacks);
+                                           pUserData, pUserData, 0, NULL, pAllocationCallbacks);
 }
 DRFLAC_API drflac* drflac_open_relaxed(drflac_read_proc onRead, drflac_seek_proc onSeek,
                                        drflac_container container, void* pUserData,
                                        const drlibs_allocation_callbacks* pAllocationCallbacks) {
   return drflac_open_with_metadata_private(onRead, onSeek, NULL, container, pUserData, pUserData,
-                                           pAllocationCallbacks);
+                                           0, NULL, pAllocationCallbacks);
 }
 
 DRFLAC_API drflac*
@@ -7503,7 +10355,7 @@ drflac_open_with_metadata(drflac_read_proc onRead, drflac_seek_proc onSeek, drfl
                           void* pUserData,
                           const drlibs_allocation_callbacks* pAllocationCallbacks) {
   return drflac_open_with_metadata_private(onRead, onSeek, onMeta, drflac_container_unknown,
-                                           pUserData, pUserData, pAllocationCallbacks);
+                                           pUserData, pUserData, 0, NULL, pAllocationCallbacks);
 }
 DRFLAC_API drflac*
 drflac_open_with_metadata_relaxed(drflac_read_proc onRead, drflac_seek_proc onSeek,
@@ -7511,11 +10363,21 @@ drflac_open_with_metadata_relaxed(drflac_read_proc onRead, drflac_seek_proc onSe
                                   void* pUserData,
                                   const drlibs_allocation_callbacks* pAllocationCallbacks) {
   return drflac_open_with_metadata_private(onRead, onSeek, onMeta, container, pUserData, pUserData,
-                                           pAllocationCallbacks);
+                                           0, NULL, pAllocationCallbacks);
 }
 
-DRFLAC_API void drflac_close(drflac* pFlac) {
-  if (pFlac == NULL) { return; }
+DRFLAC_API drflac*
+drflac_open_with_buffer_size(drflac_read_proc onRead, drflac_seek_proc onSeek,
+                             drflac_meta_proc onMeta, void* pUserData, size_t bufferSizeInBytes,
+                             const drlibs_allocation_callbacks* pAllocationCallbacks) {
+  return drflac_open_with_metadata_private(onRead, onSeek, onMeta, drflac_container_unknown,
+                                           pUserData, pUserData, bufferSizeInBytes,
+                                           NULL, pAllocationCallbacks);
+}
+
+/* Releases whatever the decoder opened itself, such as a file handle, leaving its memory intact. */
+static void drflac__uninit_stream(drflac* pFlac) {
+  DRFLAC_ASSERT(pFlac != NULL);
 
 #ifndef DR_FLAC_NO_STDIO
   /*
@@ -7525,9 +10387,17 @@ DRFLAC_API void drflac_close(drflac* pFlac) {
   */
   if (pFlac->bs.onRead == drflac__on_read_stdio) { fclose((FILE*)pFlac->bs.pUserData); }
 
-#ifndef DR_FLAC_NO_OGG
-  /* Need to clean up Ogg streams a bit differently due to the way the bit
-   * streaming is chained. */
+#if defined(DRFLAC_HAS_MMAP)
+  /* Files opened with drflac_open_file_mmap() are backed by the memory stream.
+   */
+  if (pFlac->_isMappedFile) {
+    drflac__unmap_file(pFlac->memoryStream.data, pFlac->memoryStream.dataSize);
+  }
+#endif
+
+#ifndef DR_FLAC_NO_OGG
+  /* Need to clean up Ogg streams a bit differently due to the way the bit
+   * streaming is chained. */
   if (pFlac->container == drflac_container_ogg) {
     drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
     DRFLAC_ASSERT(pFlac->bs.onRead == drflac__on_read_ogg);
@@ -7535,9 +10405,127 @@ DRFLAC_API void drflac_close(drflac* pFlac) {
     if (oggbs->onRead == drflac__on_read_stdio) { fclose((FILE*)oggbs->pUserData); }
   }
 #endif
+#else
+  (void)pFlac;
 #endif
+}
 
-  drflac__free_from_callbacks(pFlac, &pFlac->allocationCallbacks);
+DRFLAC_API void drflac_close(drflac* pFlac) {
+  if (pFlac == NULL) { return; }
+
+  drflac__uninit_stream(pFlac);
+  drflac__free_decoder(pFlac);
+}
+
+static size_t drflac__get_reuse_buffer_size(const drflac* pFlac) {
+  if (pFlac == NULL) { return 0; }
+  return DRFLAC_CACHE_L2_SIZE_BYTES(&pFlac->bs);
+}
+
+DRFLAC_API drflac* drflac_reopen(drflac* pFlac, drflac_read_proc onRead, drflac_seek_proc onSeek,
+                                 drflac_meta_proc onMeta, void* pUserData) {
+  size_t bufferSizeInBytes = drflac__get_reuse_buffer_size(pFlac);
+
+  if (pFlac == NULL) {
+    return drflac_open_with_metadata_private(onRead, onSeek, onMeta, drflac_container_unknown,
+                                             pUserData, pUserData, 0, NULL, NULL);
+  }
+
+  drflac__uninit_stream(pFlac);
+  return drflac_open_with_metadata_private(onRead, onSeek, onMeta, drflac_container_unknown,
+                                           pUserData, pUserData, bufferSizeInBytes, pFlac,
+                                           &pFlac->allocationCallbacks);
+}
+
+#ifndef DR_FLAC_NO_STDIO
+DRFLAC_API drflac* drflac_reopen_file(drflac* pFlac, const char* pFileName, drflac_meta_proc onMeta,
+                                      void* pUserData) {
+  size_t bufferSizeInBytes = drflac__get_reuse_buffer_size(pFlac);
+  FILE* pFile;
+
+  if (pFlac != NULL) { drflac__uninit_stream(pFlac); }
+
+  if (drflac_fopen(&pFile, pFileName, "rb") != DRFLAC_SUCCESS) {
+    drflac__free_decoder(pFlac);
+    return NULL;
+  }
+
+  pFlac = drflac_open_with_metadata_private(
+      drflac__on_read_stdio, drflac__on_seek_stdio, onMeta, drflac_container_unknown, (void*)pFile,
+      pUserData, bufferSizeInBytes, pFlac, (pFlac != NULL) ? &pFlac->allocationCallbacks : NULL);
+  if (pFlac == NULL) {
+    fclose(pFile);
+    return pFlac;
+  }
+
+  return pFlac;
+}
+#endif
+
+DRFLAC_API drflac* drflac_reopen_memory(drflac* pFlac, const void* pData, size_t dataSize,
+                                        drflac_meta_proc onMeta, void* pUserData) {
+  size_t bufferSizeInBytes = drflac__get_reuse_buffer_size(pFlac);
+
+  if (pFlac != NULL) { drflac__uninit_stream(pFlac); }
+
+  return drflac__open_memory_private(pData, dataSize, onMeta, pUserData, bufferSizeInBytes, pFlac,
+                                     (pFlac != NULL) ? &pFlac->allocationCallbacks : NULL);
+}
+
+DRFLAC_API bool drflac_get_preallocated_size(drflac_read_proc onRead, drflac_seek_proc onSeek,
+                                             drflac_meta_proc onMeta, void* pUserData,
+                                             size_t* pSizeInBytes) {
+  drflac__preallocation preallocation;
+  drlibs_allocation_callbacks allocationCallbacks;
+  drflac* pFlac;
+
+  if (pSizeInBytes == NULL) { return DRFLAC_FALSE; }
+  *pSizeInBytes = 0;
+
+  DRFLAC_ZERO_MEMORY(&preallocation, sizeof(preallocation));
+  allocationCallbacks.pUserData = &preallocation;
+  allocationCallbacks.onMalloc = drflac__malloc_preallocated;
+  allocationCallbacks.onRealloc = NULL;
+  allocationCallbacks.onFree = drflac__free_preallocated;
+
+  /* Without a metadata callback the only allocation is the decoder, which is where this stops. */
+  pFlac = drflac_open_with_metadata_private(onRead, onSeek, NULL, drflac_container_unknown,
+                                            pUserData, pUserData, 0, NULL, &allocationCallbacks);
+  DRFLAC_ASSERT(pFlac == NULL);
+  (void)pFlac;
+
+  if (preallocation.lastRequestSize == 0) { return DRFLAC_FALSE; }
+
+  /* Put the client back at the start so it's ready for drflac_open_preallocated(). */
+  if (!onSeek(pUserData, 0, drflac_seek_origin_start)) { return DRFLAC_FALSE; }
+
+  *pSizeInBytes = preallocation.lastRequestSize;
+  if (onMeta != NULL && *pSizeInBytes < preallocation.largestMetadataBlockSize) {
+    *pSizeInBytes = preallocation.largestMetadataBlockSize;
+  }
+  return DRFLAC_TRUE;
+}
+
+DRFLAC_API drflac* drflac_open_preallocated(drflac_read_proc onRead, drflac_seek_proc onSeek,
+                                            drflac_meta_proc onMeta, void* pUserData,
+                                            void* pMemory, size_t memorySizeInBytes) {
+  drflac__preallocation preallocation;
+  drlibs_allocation_callbacks allocationCallbacks;
+
+  if (pMemory == NULL || ((size_t)pMemory & (DRFLAC_PREALLOCATED_ALIGNMENT - 1)) != 0) {
+    return NULL;
+  }
+
+  DRFLAC_ZERO_MEMORY(&preallocation, sizeof(preallocation));
+  preallocation.pMemory = pMemory;
+  preallocation.sizeInBytes = memorySizeInBytes;
+  allocationCallbacks.pUserData = &preallocation;
+  allocationCallbacks.onMalloc = drflac__malloc_preallocated;
+  allocationCallbacks.onRealloc = NULL;
+  allocationCallbacks.onFree = drflac__free_preallocated;
+
+  return drflac_open_with_metadata_private(onRead, onSeek, onMeta, drflac_container_unknown,
+                                           pUserData, pUserData, 0, NULL, &allocationCallbacks);
 }
 
 #if 0
@@ -8379,7 +11367,7 @@ DRFLAC_API uint64_t drflac_read_pcm_frames_s32(drflac* pFlac, uint64_t framesToR
   while (framesToRead > 0) {
     /* If we've run out of samples in this frame, go to the next. */
     if (pFlac->currentFLACFrame.pcmFramesRemaining == 0) {
-      if (!drflac__read_and_decode_next_flac_frame(pFlac)) {
+      if (!drflac__read_and_decode_next_flac_frame_for_read(pFlac)) {
         break; /* Couldn't read the next frame, so just break from the loop and
                   return. */
       }
@@ -8449,6 +11437,7 @@ DRFLAC_API uint64_t drflac_read_pcm_frames_s32(drflac* pFlac, uint64_t framesToR
     }
   }
 
+  drflac__read_ahead_at_end_of_link(pFlac);
   return framesRead;
 }
 
@@ -9399,7 +12388,7 @@ DRFLAC_API uint64_t drflac_read_pcm_frames_s16(drflac* pFlac, uint64_t framesToR
   while (framesToRead > 0) {
     /* If we've run out of samples in this frame, go to the next. */
     if (pFlac->currentFLACFrame.pcmFramesRemaining == 0) {
-      if (!drflac__read_and_decode_next_flac_frame(pFlac)) {
+      if (!drflac__read_and_decode_next_flac_frame_for_read(pFlac)) {
         break; /* Couldn't read the next frame, so just break from the loop and
                   return. */
       }
@@ -9470,6 +12459,7 @@ DRFLAC_API uint64_t drflac_read_pcm_frames_s16(drflac* pFlac, uint64_t framesToR
     }
   }
 
+  drflac__read_ahead_at_end_of_link(pFlac);
   return framesRead;
 }
 
@@ -9578,6 +12568,78 @@ static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_left_side__sse2(
 }
 #endif
 
+#if defined(DRFLAC_SUPPORT_AVX2)
+/*
+Samples of up to 24 bits convert to float exactly, so scaling by a power of two
+gives the same result as shifting up first. The AVX2 kernels use this to fold
+the shift that comes from the bit depth into the scale, which leaves only the
+difference in wasted bits between the two channels to shift by. With 16-, 20-
+and 24-bit streams that difference is almost always zero.
+*/
+static DRFLAC_INLINE float drflac__get_f32_scale(uint32_t shift) {
+  DRFLAC_ASSERT(shift <= 23);
+  return (float)(1U << shift) / 8388608.0f;
+}
+
+/* The unpacks work within each 128-bit lane so the halves need to be put back in order. */
+static DRFLAC_INLINE void drflac__store_f32_stereo_x8__avx2(float* pOutputSamples, __m256 left,
+                                                            __m256 right) {
+  __m256 lo = _mm256_unpacklo_ps(left, right);
+  __m256 hi = _mm256_unpackhi_ps(left, right);
+
+  _mm256_storeu_ps(pOutputSamples + 0, _mm256_permute2f128_ps(lo, hi, 0x20));
+  _mm256_storeu_ps(pOutputSamples + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_left_side__avx2(
+    drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
+    const int32_t* pInputSamples0, const int32_t* pInputSamples1, float* pOutputSamples) {
+  uint64_t i;
+  uint64_t frameCount8 = frameCount >> 3;
+  const uint32_t* pInputSamples0U32 = (const uint32_t*)pInputSamples0;
+  const uint32_t* pInputSamples1U32 = (const uint32_t*)pInputSamples1;
+  uint32_t shift0 =
+      (unusedBitsPerSample + pFlac->currentFLACFrame.subframes[0].wastedBitsPerSample) - 8;
+  uint32_t shift1 =
+      (unusedBitsPerSample + pFlac->currentFLACFrame.subframes[1].wastedBitsPerSample) - 8;
+  uint32_t shift = (shift0 < shift1) ? shift0 : shift1;
+  float factor;
+  __m256 factor256;
+  __m128i shift0_128;
+  __m128i shift1_128;
+
+  DRFLAC_ASSERT(pFlac->bitsPerSample <= 24);
+
+  shift0 -= shift;
+  shift1 -= shift;
+  factor = drflac__get_f32_scale(shift);
+  factor256 = _mm256_set1_ps(factor);
+  shift0_128 = _mm_cvtsi32_si128((int)shift0);
+  shift1_128 = _mm_cvtsi32_si128((int)shift1);
+
+  for (i = 0; i < frameCount8; ++i) {
+    __m256i left = _mm256_sll_epi32(_mm256_loadu_si256((const __m256i*)pInputSamples0 + i),
+                                    shift0_128);
+    __m256i side = _mm256_sll_epi32(_mm256_loadu_si256((const __m256i*)pInputSamples1 + i),
+                                    shift1_128);
+    __m256i right = _mm256_sub_epi32(left, side);
+
+    drflac__store_f32_stereo_x8__avx2(pOutputSamples + i * 16,
+                                      _mm256_mul_ps(_mm256_cvtepi32_ps(left), factor256),
+                                      _mm256_mul_ps(_mm256_cvtepi32_ps(right), factor256));
+  }
+
+  for (i = (frameCount8 << 3); i < frameCount; ++i) {
+    uint32_t left = pInputSamples0U32[i] << shift0;
+    uint32_t side = pInputSamples1U32[i] << shift1;
+    uint32_t right = left - side;
+
+    pOutputSamples[i * 2 + 0] = (int32_t)left * factor;
+    pOutputSamples[i * 2 + 1] = (int32_t)right * factor;
+  }
+}
+#endif
+
 #if defined(DRFLAC_SUPPORT_NEON)
 static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_left_side__neon(
     drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
@@ -9630,6 +12692,12 @@ static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_left_side__neon(
 static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_left_side(
     drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
     const int32_t* pInputSamples0, const int32_t* pInputSamples1, float* pOutputSamples) {
+#if defined(DRFLAC_SUPPORT_AVX2)
+  if (drflac__gIsAVX2Supported && pFlac->bitsPerSample <= 24) {
+    drflac_read_pcm_frames_f32__decode_left_side__avx2(
+        pFlac, frameCount, unusedBitsPerSample, pInputSamples0, pInputSamples1, pOutputSamples);
+  } else
+#endif
 #if defined(DRFLAC_SUPPORT_SSE2)
   if (drflac__gIsSSE2Supported && pFlac->bitsPerSample <= 24) {
     drflac_read_pcm_frames_f32__decode_left_side__sse2(
@@ -9756,6 +12824,56 @@ static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_right_side__sse2(
 }
 #endif
 
+#if defined(DRFLAC_SUPPORT_AVX2)
+static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_right_side__avx2(
+    drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
+    const int32_t* pInputSamples0, const int32_t* pInputSamples1, float* pOutputSamples) {
+  uint64_t i;
+  uint64_t frameCount8 = frameCount >> 3;
+  const uint32_t* pInputSamples0U32 = (const uint32_t*)pInputSamples0;
+  const uint32_t* pInputSamples1U32 = (const uint32_t*)pInputSamples1;
+  uint32_t shift0 =
+      (unusedBitsPerSample + pFlac->currentFLACFrame.subframes[0].wastedBitsPerSample) - 8;
+  uint32_t shift1 =
+      (unusedBitsPerSample + pFlac->currentFLACFrame.subframes[1].wastedBitsPerSample) - 8;
+  uint32_t shift = (shift0 < shift1) ? shift0 : shift1;
+  float factor;
+  __m256 factor256;
+  __m128i shift0_128;
+  __m128i shift1_128;
+
+  DRFLAC_ASSERT(pFlac->bitsPerSample <= 24);
+
+  shift0 -= shift;
+  shift1 -= shift;
+  factor = drflac__get_f32_scale(shift);
+  factor256 = _mm256_set1_ps(factor);
+  shift0_128 = _mm_cvtsi32_si128((int)shift0);
+  shift1_128 = _mm_cvtsi32_si128((int)shift1);
+
+  for (i = 0; i < frameCount8; ++i) {
+    __m256i side = _mm256_sll_epi32(_mm256_loadu_si256((const __m256i*)pInputSamples0 + i),
+                                    shift0_128);
+    __m256i right = _mm256_sll_epi32(_mm256_loadu_si256((const __m256i*)pInputSamples1 + i),
+                                     shift1_128);
+    __m256i left = _mm256_add_epi32(right, side);
+
+    drflac__store_f32_stereo_x8__avx2(pOutputSamples + i * 16,
+                                      _mm256_mul_ps(_mm256_cvtepi32_ps(left), factor256),
+                                      _mm256_mul_ps(_mm256_cvtepi32_ps(right), factor256));
+  }
+
+  for (i = (frameCount8 << 3); i < frameCount; ++i) {
+    uint32_t side = pInputSamples0U32[i] << shift0;
+    uint32_t right = pInputSamples1U32[i] << shift1;
+    uint32_t left = right + side;
+
+    pOutputSamples[i * 2 + 0] = (int32_t)left * factor;
+    pOutputSamples[i * 2 + 1] = (int32_t)right * factor;
+  }
+}
+#endif
+
 #if defined(DRFLAC_SUPPORT_NEON)
 static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_right_side__neon(
     drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
@@ -9808,6 +12926,12 @@ static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_right_side__neon(
 static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_right_side(
     drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
     const int32_t* pInputSamples0, const int32_t* pInputSamples1, float* pOutputSamples) {
+#if defined(DRFLAC_SUPPORT_AVX2)
+  if (drflac__gIsAVX2Supported && pFlac->bitsPerSample <= 24) {
+    drflac_read_pcm_frames_f32__decode_right_side__avx2(
+        pFlac, frameCount, unusedBitsPerSample, pInputSamples0, pInputSamples1, pOutputSamples);
+  } else
+#endif
 #if defined(DRFLAC_SUPPORT_SSE2)
   if (drflac__gIsSSE2Supported && pFlac->bitsPerSample <= 24) {
     drflac_read_pcm_frames_f32__decode_right_side__sse2(
@@ -10077,6 +13201,60 @@ static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_mid_side__sse2(
 }
 #endif
 
+#if defined(DRFLAC_SUPPORT_AVX2)
+static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_mid_side__avx2(
+    drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
+    const int32_t* pInputSamples0, const int32_t* pInputSamples1, float* pOutputSamples) {
+  uint64_t i;
+  uint64_t frameCount8 = frameCount >> 3;
+  const uint32_t* pInputSamples0U32 = (const uint32_t*)pInputSamples0;
+  const uint32_t* pInputSamples1U32 = (const uint32_t*)pInputSamples1;
+  uint32_t wbps0 = pFlac->currentFLACFrame.subframes[0].wastedBitsPerSample;
+  uint32_t wbps1 = pFlac->currentFLACFrame.subframes[1].wastedBitsPerSample;
+  float factor;
+  __m256 factor256;
+  __m128i wbps0_128;
+  __m128i wbps1_128;
+
+  DRFLAC_ASSERT(pFlac->bitsPerSample <= 24);
+
+  /*
+  mid + side and mid - side are always even, so they're one bit wider than the
+  sample but still convert exactly. Halving them goes into the scale along with
+  the shift, so there's no need for separate paths like the SSE2 kernel.
+  */
+  factor = drflac__get_f32_scale(unusedBitsPerSample - 8) * 0.5f;
+  factor256 = _mm256_set1_ps(factor);
+  wbps0_128 = _mm_cvtsi32_si128((int)wbps0);
+  wbps1_128 = _mm_cvtsi32_si128((int)wbps1);
+
+  for (i = 0; i < frameCount8; ++i) {
+    __m256i mid = _mm256_sll_epi32(_mm256_loadu_si256((const __m256i*)pInputSamples0 + i),
+                                   wbps0_128);
+    __m256i side = _mm256_sll_epi32(_mm256_loadu_si256((const __m256i*)pInputSamples1 + i),
+                                    wbps1_128);
+
+    mid = _mm256_or_si256(_mm256_slli_epi32(mid, 1),
+                          _mm256_and_si256(side, _mm256_set1_epi32(0x01)));
+
+    drflac__store_f32_stereo_x8__avx2(
+        pOutputSamples + i * 16,
+        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(mid, side)), factor256),
+        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(mid, side)), factor256));
+  }
+
+  for (i = (frameCount8 << 3); i < frameCount; ++i) {
+    uint32_t mid = pInputSamples0U32[i] << wbps0;
+    uint32_t side = pInputSamples1U32[i] << wbps1;
+
+    mid = (mid << 1) | (side & 0x01);
+
+    pOutputSamples[i * 2 + 0] = (int32_t)(mid + side) * factor;
+    pOutputSamples[i * 2 + 1] = (int32_t)(mid - side) * factor;
+  }
+}
+#endif
+
 #if defined(DRFLAC_SUPPORT_NEON)
 static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_mid_side__neon(
     drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
@@ -10174,6 +13352,12 @@ static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_mid_side__neon(
 static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_mid_side(
     drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
     const int32_t* pInputSamples0, const int32_t* pInputSamples1, float* pOutputSamples) {
+#if defined(DRFLAC_SUPPORT_AVX2)
+  if (drflac__gIsAVX2Supported && pFlac->bitsPerSample <= 24) {
+    drflac_read_pcm_frames_f32__decode_mid_side__avx2(
+        pFlac, frameCount, unusedBitsPerSample, pInputSamples0, pInputSamples1, pOutputSamples);
+  } else
+#endif
 #if defined(DRFLAC_SUPPORT_SSE2)
   if (drflac__gIsSSE2Supported && pFlac->bitsPerSample <= 24) {
     drflac_read_pcm_frames_f32__decode_mid_side__sse2(
@@ -10285,6 +13469,43 @@ static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_independent_stereo_
 }
 #endif
 
+#if defined(DRFLAC_SUPPORT_AVX2)
+static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_independent_stereo__avx2(
+    drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
+    const int32_t* pInputSamples0, const int32_t* pInputSamples1, float* pOutputSamples) {
+  uint64_t i;
+  uint64_t frameCount8 = frameCount >> 3;
+  float factor0;
+  float factor1;
+  __m256 factor0_256;
+  __m256 factor1_256;
+
+  DRFLAC_ASSERT(pFlac->bitsPerSample <= 24);
+
+  /* The channels aren't combined so the whole shift of each one goes into its scale. */
+  factor0 = drflac__get_f32_scale(
+      (unusedBitsPerSample + pFlac->currentFLACFrame.subframes[0].wastedBitsPerSample) - 8);
+  factor1 = drflac__get_f32_scale(
+      (unusedBitsPerSample + pFlac->currentFLACFrame.subframes[1].wastedBitsPerSample) - 8);
+  factor0_256 = _mm256_set1_ps(factor0);
+  factor1_256 = _mm256_set1_ps(factor1);
+
+  for (i = 0; i < frameCount8; ++i) {
+    __m256i lefti = _mm256_loadu_si256((const __m256i*)pInputSamples0 + i);
+    __m256i righti = _mm256_loadu_si256((const __m256i*)pInputSamples1 + i);
+
+    drflac__store_f32_stereo_x8__avx2(pOutputSamples + i * 16,
+                                      _mm256_mul_ps(_mm256_cvtepi32_ps(lefti), factor0_256),
+                                      _mm256_mul_ps(_mm256_cvtepi32_ps(righti), factor1_256));
+  }
+
+  for (i = (frameCount8 << 3); i < frameCount; ++i) {
+    pOutputSamples[i * 2 + 0] = pInputSamples0[i] * factor0;
+    pOutputSamples[i * 2 + 1] = pInputSamples1[i] * factor1;
+  }
+}
+#endif
+
 #if defined(DRFLAC_SUPPORT_NEON)
 static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_independent_stereo__neon(
     drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
@@ -10328,6 +13549,12 @@ static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_independent_stereo_
 static DRFLAC_INLINE void drflac_read_pcm_frames_f32__decode_independent_stereo(
     drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
     const int32_t* pInputSamples0, const int32_t* pInputSamples1, float* pOutputSamples) {
+#if defined(DRFLAC_SUPPORT_AVX2)
+  if (drflac__gIsAVX2Supported && pFlac->bitsPerSample <= 24) {
+    drflac_read_pcm_frames_f32__decode_independent_stereo__avx2(
+        pFlac, frameCount, unusedBitsPerSample, pInputSamples0, pInputSamples1, pOutputSamples);
+  } else
+#endif
 #if defined(DRFLAC_SUPPORT_SSE2)
   if (drflac__gIsSSE2Supported && pFlac->bitsPerSample <= 24) {
     drflac_read_pcm_frames_f32__decode_independent_stereo__sse2(
@@ -10366,7 +13593,7 @@ DRFLAC_API uint64_t drflac_read_pcm_frames_f32(drflac* pFlac, uint64_t framesToR
   while (framesToRead > 0) {
     /* If we've run out of samples in this frame, go to the next. */
     if (pFlac->currentFLACFrame.pcmFramesRemaining == 0) {
-      if (!drflac__read_and_decode_next_flac_frame(pFlac)) {
+      if (!drflac__read_and_decode_next_flac_frame_for_read(pFlac)) {
         break; /* Couldn't read the next frame, so just break from the loop and
                   return. */
       }
@@ -10437,74 +13664,863 @@ DRFLAC_API uint64_t drflac_read_pcm_frames_f32(drflac* pFlac, uint64_t framesToR
     }
   }
 
+  drflac__read_ahead_at_end_of_link(pFlac);
   return framesRead;
 }
 
-DRFLAC_API bool drflac_seek_to_pcm_frame(drflac* pFlac, uint64_t pcmFrameIndex) {
-  if (pFlac == NULL) { return DRFLAC_FALSE; }
+/*
+Planar output. These write each channel to its own buffer straight out of
+pDecodedSamples, so there's no interleaving step. The stereo decorrelation and
+the conversion to the output format are fused into a single pass. The format is
+always a compile time constant at the call site so the switches below get folded
+away when inlined.
+*/
+#define DRFLAC_PLANAR_FORMAT_S32 0
+#define DRFLAC_PLANAR_FORMAT_S16 1
+#define DRFLAC_PLANAR_FORMAT_F32 2
 
-  /* Don't do anything if we're already on the seek point. */
-  if (pFlac->currentPCMFrame == pcmFrameIndex) { return DRFLAC_TRUE; }
+static DRFLAC_INLINE size_t drflac__get_bytes_per_planar_sample(int format) {
+  switch (format) {
+  case DRFLAC_PLANAR_FORMAT_S16: return sizeof(int16_t);
+  case DRFLAC_PLANAR_FORMAT_F32: return sizeof(float);
+  case DRFLAC_PLANAR_FORMAT_S32:
+  default: return sizeof(int32_t);
+  }
+}
 
-  /*
-  If we don't know where the first frame begins then we can't seek. This will
-  happen when the STREAMINFO block was not present when the decoder was opened.
-  */
-  if (pFlac->firstFLACFramePosInBytes == 0) { return DRFLAC_FALSE; }
+/* The input sample is always left aligned to 32 bits. */
+static DRFLAC_INLINE void drflac__store_planar_sample(void* pOut, uint64_t i, uint32_t sample,
+                                                      int format) {
+  switch (format) {
+  case DRFLAC_PLANAR_FORMAT_S16: ((int16_t*)pOut)[i] = (int16_t)(sample >> 16); break;
+  case DRFLAC_PLANAR_FORMAT_F32:
+    ((float*)pOut)[i] = (int32_t)sample * (1.0f / 2147483648.0f);
+    break;
+  case DRFLAC_PLANAR_FORMAT_S32:
+  default: ((int32_t*)pOut)[i] = (int32_t)sample; break;
+  }
+}
 
-  if (pcmFrameIndex == 0) {
-    pFlac->currentPCMFrame = 0;
-    return drflac__seek_to_first_frame(pFlac);
-  } else {
-    bool wasSuccessful = DRFLAC_FALSE;
-    uint64_t originalPCMFrame = pFlac->currentPCMFrame;
+static DRFLAC_INLINE void drflac__decode_channel_planar__scalar(uint64_t frameCount,
+                                                                uint32_t shift,
+                                                                const int32_t* pInputSamples,
+                                                                void* pOut, int format) {
+  const uint32_t* pInputSamplesU32 = (const uint32_t*)pInputSamples;
+  uint64_t i;
 
-    /* Clamp the sample to the end. */
-    if (pcmFrameIndex > pFlac->totalPCMFrameCount) { pcmFrameIndex = pFlac->totalPCMFrameCount; }
+  for (i = 0; i < frameCount; ++i) {
+    drflac__store_planar_sample(pOut, i, pInputSamplesU32[i] << shift, format);
+  }
+}
 
-    /* If the target sample and the current sample are in the same frame we just
-     * move the position forward. */
-    if (pcmFrameIndex > pFlac->currentPCMFrame) {
-      /* Forward. */
-      uint32_t offset = (uint32_t)(pcmFrameIndex - pFlac->currentPCMFrame);
-      if (pFlac->currentFLACFrame.pcmFramesRemaining > offset) {
-        pFlac->currentFLACFrame.pcmFramesRemaining -= offset;
-        pFlac->currentPCMFrame = pcmFrameIndex;
-        return DRFLAC_TRUE;
-      }
-    } else {
-      /* Backward. */
-      uint32_t offsetAbs = (uint32_t)(pFlac->currentPCMFrame - pcmFrameIndex);
-      uint32_t currentFLACFramePCMFrameCount =
-          pFlac->currentFLACFrame.header.blockSizeInPCMFrames;
-      uint32_t currentFLACFramePCMFramesConsumed =
-          currentFLACFramePCMFrameCount - pFlac->currentFLACFrame.pcmFramesRemaining;
-      if (currentFLACFramePCMFramesConsumed > offsetAbs) {
-        pFlac->currentFLACFrame.pcmFramesRemaining += offsetAbs;
-        pFlac->currentPCMFrame = pcmFrameIndex;
-        return DRFLAC_TRUE;
-      }
+static DRFLAC_INLINE void drflac__decode_stereo_planar__scalar(
+    drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
+    const int32_t* pInputSamples0, const int32_t* pInputSamples1, void* pOut0, void* pOut1,
+    int format) {
+  const uint32_t* pInputSamples0U32 = (const uint32_t*)pInputSamples0;
+  const uint32_t* pInputSamples1U32 = (const uint32_t*)pInputSamples1;
+  uint32_t shift0 =
+      unusedBitsPerSample + pFlac->currentFLACFrame.subframes[0].wastedBitsPerSample;
+  uint32_t shift1 =
+      unusedBitsPerSample + pFlac->currentFLACFrame.subframes[1].wastedBitsPerSample;
+  uint64_t i;
+
+  switch (pFlac->currentFLACFrame.header.channelAssignment) {
+  case DRFLAC_CHANNEL_ASSIGNMENT_LEFT_SIDE: {
+    for (i = 0; i < frameCount; ++i) {
+      uint32_t left = pInputSamples0U32[i] << shift0;
+      uint32_t side = pInputSamples1U32[i] << shift1;
+
+      drflac__store_planar_sample(pOut0, i, left, format);
+      drflac__store_planar_sample(pOut1, i, left - side, format);
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_RIGHT_SIDE: {
+    for (i = 0; i < frameCount; ++i) {
+      uint32_t side = pInputSamples0U32[i] << shift0;
+      uint32_t right = pInputSamples1U32[i] << shift1;
+
+      drflac__store_planar_sample(pOut0, i, side + right, format);
+      drflac__store_planar_sample(pOut1, i, right, format);
     }
+  } break;
 
+  case DRFLAC_CHANNEL_ASSIGNMENT_MID_SIDE: {
     /*
-    Different techniques depending on encapsulation. Using the native FLAC
-    seektable with Ogg encapsulation is a bit awkward so we'll instead use Ogg's
-    natural seeking facility.
+    mid + side is always even, so shifting right by one and then left by the
+    unused bits is the same as what the interleaved kernels do in two branches.
     */
-#ifndef DR_FLAC_NO_OGG
-    if (pFlac->container == drflac_container_ogg) {
-      wasSuccessful = drflac_ogg__seek_to_pcm_frame(pFlac, pcmFrameIndex);
-    } else
-#endif
-    {
-      /* First try seeking via the seek table. If this fails, fall back to a
-       * brute force seek which is much slower. */
-      if (/*!wasSuccessful && */ !pFlac->_noSeekTableSeek) {
-        wasSuccessful = drflac__seek_to_pcm_frame__seek_table(pFlac, pcmFrameIndex);
-      }
+    shift0 -= unusedBitsPerSample;
+    shift1 -= unusedBitsPerSample;
+    for (i = 0; i < frameCount; ++i) {
+      uint32_t mid = pInputSamples0U32[i] << shift0;
+      uint32_t side = pInputSamples1U32[i] << shift1;
 
-#if !defined(DR_FLAC_NO_CRC)
-      /* Fall back to binary search if seek table seeking fails. This requires
+      mid = (mid << 1) | (side & 0x01);
+
+      drflac__store_planar_sample(
+          pOut0, i, (uint32_t)((int32_t)(mid + side) >> 1) << unusedBitsPerSample, format);
+      drflac__store_planar_sample(
+          pOut1, i, (uint32_t)((int32_t)(mid - side) >> 1) << unusedBitsPerSample, format);
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_INDEPENDENT:
+  default: {
+    drflac__decode_channel_planar__scalar(frameCount, shift0, pInputSamples0, pOut0, format);
+    drflac__decode_channel_planar__scalar(frameCount, shift1, pInputSamples1, pOut1, format);
+  } break;
+  }
+}
+
+#if defined(DRFLAC_SUPPORT_SSE2)
+static DRFLAC_INLINE void drflac__store_planar_samples_x4__sse2(void* pOut, uint64_t i,
+                                                                __m128i samples, int format) {
+  switch (format) {
+  case DRFLAC_PLANAR_FORMAT_S16: {
+    __m128i s16 = _mm_srai_epi32(samples, 16);
+    _mm_storel_epi64((__m128i*)((int16_t*)pOut + i), _mm_packs_epi32(s16, s16));
+  } break;
+
+  case DRFLAC_PLANAR_FORMAT_F32: {
+    _mm_storeu_ps((float*)pOut + i,
+                  _mm_mul_ps(_mm_cvtepi32_ps(samples), _mm_set1_ps(1.0f / 2147483648.0f)));
+  } break;
+
+  case DRFLAC_PLANAR_FORMAT_S32:
+  default: {
+    _mm_storeu_si128((__m128i*)((int32_t*)pOut + i), samples);
+  } break;
+  }
+}
+
+static DRFLAC_INLINE void drflac__decode_channel_planar__sse2(uint64_t frameCount,
+                                                              uint32_t shift,
+                                                              const int32_t* pInputSamples,
+                                                              void* pOut, int format) {
+  uint64_t i;
+  uint64_t frameCount4 = frameCount >> 2;
+  const uint32_t* pInputSamplesU32 = (const uint32_t*)pInputSamples;
+
+  for (i = 0; i < frameCount4; ++i) {
+    __m128i samples = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)pInputSamples + i), shift);
+    drflac__store_planar_samples_x4__sse2(pOut, i * 4, samples, format);
+  }
+
+  for (i = (frameCount4 << 2); i < frameCount; ++i) {
+    drflac__store_planar_sample(pOut, i, pInputSamplesU32[i] << shift, format);
+  }
+}
+
+static DRFLAC_INLINE void drflac__decode_stereo_planar__sse2(
+    drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
+    const int32_t* pInputSamples0, const int32_t* pInputSamples1, void* pOut0, void* pOut1,
+    int format) {
+  uint64_t i;
+  uint64_t frameCount4 = frameCount >> 2;
+  uint32_t shift0 =
+      unusedBitsPerSample + pFlac->currentFLACFrame.subframes[0].wastedBitsPerSample;
+  uint32_t shift1 =
+      unusedBitsPerSample + pFlac->currentFLACFrame.subframes[1].wastedBitsPerSample;
+
+  switch (pFlac->currentFLACFrame.header.channelAssignment) {
+  case DRFLAC_CHANNEL_ASSIGNMENT_LEFT_SIDE: {
+    for (i = 0; i < frameCount4; ++i) {
+      __m128i left = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)pInputSamples0 + i), shift0);
+      __m128i side = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)pInputSamples1 + i), shift1);
+
+      drflac__store_planar_samples_x4__sse2(pOut0, i * 4, left, format);
+      drflac__store_planar_samples_x4__sse2(pOut1, i * 4, _mm_sub_epi32(left, side), format);
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_RIGHT_SIDE: {
+    for (i = 0; i < frameCount4; ++i) {
+      __m128i side = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)pInputSamples0 + i), shift0);
+      __m128i right = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)pInputSamples1 + i), shift1);
+
+      drflac__store_planar_samples_x4__sse2(pOut0, i * 4, _mm_add_epi32(side, right), format);
+      drflac__store_planar_samples_x4__sse2(pOut1, i * 4, right, format);
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_MID_SIDE: {
+    shift0 -= unusedBitsPerSample;
+    shift1 -= unusedBitsPerSample;
+    for (i = 0; i < frameCount4; ++i) {
+      __m128i mid = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)pInputSamples0 + i), shift0);
+      __m128i side = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)pInputSamples1 + i), shift1);
+      __m128i left;
+      __m128i right;
+
+      mid = _mm_or_si128(_mm_slli_epi32(mid, 1), _mm_and_si128(side, _mm_set1_epi32(0x01)));
+
+      left = _mm_slli_epi32(_mm_srai_epi32(_mm_add_epi32(mid, side), 1), unusedBitsPerSample);
+      right = _mm_slli_epi32(_mm_srai_epi32(_mm_sub_epi32(mid, side), 1), unusedBitsPerSample);
+
+      drflac__store_planar_samples_x4__sse2(pOut0, i * 4, left, format);
+      drflac__store_planar_samples_x4__sse2(pOut1, i * 4, right, format);
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_INDEPENDENT:
+  default: {
+    drflac__decode_channel_planar__sse2(frameCount, shift0, pInputSamples0, pOut0, format);
+    drflac__decode_channel_planar__sse2(frameCount, shift1, pInputSamples1, pOut1, format);
+    return;
+  }
+  }
+
+  /* The scalar kernel takes care of the tail. */
+  i = frameCount4 << 2;
+  drflac__decode_stereo_planar__scalar(
+      pFlac, frameCount - i, unusedBitsPerSample, pInputSamples0 + i, pInputSamples1 + i,
+      (uint8_t*)pOut0 + i * drflac__get_bytes_per_planar_sample(format),
+      (uint8_t*)pOut1 + i * drflac__get_bytes_per_planar_sample(format), format);
+}
+#endif
+
+#if defined(DRFLAC_SUPPORT_NEON)
+static DRFLAC_INLINE void drflac__store_planar_samples_x4__neon(void* pOut, uint64_t i,
+                                                                uint32x4_t samples, int format) {
+  switch (format) {
+  case DRFLAC_PLANAR_FORMAT_S16: {
+    vst1_s16((int16_t*)pOut + i, vshrn_n_s32(vreinterpretq_s32_u32(samples), 16));
+  } break;
+
+  case DRFLAC_PLANAR_FORMAT_F32: {
+    vst1q_f32((float*)pOut + i,
+              vmulq_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(samples)),
+                        vdupq_n_f32(1.0f / 2147483648.0f)));
+  } break;
+
+  case DRFLAC_PLANAR_FORMAT_S32:
+  default: {
+    vst1q_s32((int32_t*)pOut + i, vreinterpretq_s32_u32(samples));
+  } break;
+  }
+}
+
+static DRFLAC_INLINE void drflac__decode_channel_planar__neon(uint64_t frameCount,
+                                                              uint32_t shift,
+                                                              const int32_t* pInputSamples,
+                                                              void* pOut, int format) {
+  uint64_t i;
+  uint64_t frameCount4 = frameCount >> 2;
+  const uint32_t* pInputSamplesU32 = (const uint32_t*)pInputSamples;
+  int32x4_t shift4 = vdupq_n_s32(shift);
+
+  for (i = 0; i < frameCount4; ++i) {
+    uint32x4_t samples = vshlq_u32(vld1q_u32(pInputSamplesU32 + i * 4), shift4);
+    drflac__store_planar_samples_x4__neon(pOut, i * 4, samples, format);
+  }
+
+  for (i = (frameCount4 << 2); i < frameCount; ++i) {
+    drflac__store_planar_sample(pOut, i, pInputSamplesU32[i] << shift, format);
+  }
+}
+
+static DRFLAC_INLINE void drflac__decode_stereo_planar__neon(
+    drflac* pFlac, uint64_t frameCount, uint32_t unusedBitsPerSample,
+    const int32_t* pInputSamples0, const int32_t* pInputSamples1, void* pOut0, void* pOut1,
+    int format) {
+  uint64_t i;
+  uint64_t frameCount4 = frameCount >> 2;
+  const uint32_t* pInputSamples0U32 = (const uint32_t*)pInputSamples0;
+  const uint32_t* pInputSamples1U32 = (const uint32_t*)pInputSamples1;
+  uint32_t shift0 =
+      unusedBitsPerSample + pFlac->currentFLACFrame.subframes[0].wastedBitsPerSample;
+  uint32_t shift1 =
+      unusedBitsPerSample + pFlac->currentFLACFrame.subframes[1].wastedBitsPerSample;
+  int32x4_t shift0_4;
+  int32x4_t shift1_4;
+
+  switch (pFlac->currentFLACFrame.header.channelAssignment) {
+  case DRFLAC_CHANNEL_ASSIGNMENT_LEFT_SIDE: {
+    shift0_4 = vdupq_n_s32(shift0);
+    shift1_4 = vdupq_n_s32(shift1);
+    for (i = 0; i < frameCount4; ++i) {
+      uint32x4_t left = vshlq_u32(vld1q_u32(pInputSamples0U32 + i * 4), shift0_4);
+      uint32x4_t side = vshlq_u32(vld1q_u32(pInputSamples1U32 + i * 4), shift1_4);
+
+      drflac__store_planar_samples_x4__neon(pOut0, i * 4, left, format);
+      drflac__store_planar_samples_x4__neon(pOut1, i * 4, vsubq_u32(left, side), format);
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_RIGHT_SIDE: {
+    shift0_4 = vdupq_n_s32(shift0);
+    shift1_4 = vdupq_n_s32(shift1);
+    for (i = 0; i < frameCount4; ++i) {
+      uint32x4_t side = vshlq_u32(vld1q_u32(pInputSamples0U32 + i * 4), shift0_4);
+      uint32x4_t right = vshlq_u32(vld1q_u32(pInputSamples1U32 + i * 4), shift1_4);
+
+      drflac__store_planar_samples_x4__neon(pOut0, i * 4, vaddq_u32(side, right), format);
+      drflac__store_planar_samples_x4__neon(pOut1, i * 4, right, format);
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_MID_SIDE: {
+    int32x4_t unusedBitsPerSample4 = vdupq_n_s32(unusedBitsPerSample);
+    uint32x4_t one4 = vdupq_n_u32(1);
+
+    shift0_4 = vdupq_n_s32(shift0 - unusedBitsPerSample);
+    shift1_4 = vdupq_n_s32(shift1 - unusedBitsPerSample);
+    for (i = 0; i < frameCount4; ++i) {
+      uint32x4_t mid = vshlq_u32(vld1q_u32(pInputSamples0U32 + i * 4), shift0_4);
+      uint32x4_t side = vshlq_u32(vld1q_u32(pInputSamples1U32 + i * 4), shift1_4);
+      uint32x4_t left;
+      uint32x4_t right;
+
+      mid = vorrq_u32(vshlq_n_u32(mid, 1), vandq_u32(side, one4));
+
+      left = vshlq_u32(
+          vreinterpretq_u32_s32(vshrq_n_s32(vreinterpretq_s32_u32(vaddq_u32(mid, side)), 1)),
+          unusedBitsPerSample4);
+      right = vshlq_u32(
+          vreinterpretq_u32_s32(vshrq_n_s32(vreinterpretq_s32_u32(vsubq_u32(mid, side)), 1)),
+          unusedBitsPerSample4);
+
+      drflac__store_planar_samples_x4__neon(pOut0, i * 4, left, format);
+      drflac__store_planar_samples_x4__neon(pOut1, i * 4, right, format);
+    }
+  } break;
+
+  case DRFLAC_CHANNEL_ASSIGNMENT_INDEPENDENT:
+  default: {
+    drflac__decode_channel_planar__neon(frameCount, shift0, pInputSamples0, pOut0, format);
+    drflac__decode_channel_planar__neon(frameCount, shift1, pInputSamples1, pOut1, format);
+    return;
+  }
+  }
+
+  /* The scalar kernel takes care of the tail. */
+  i = frameCount4 << 2;
+  drflac__decode_stereo_planar__scalar(
+      pFlac, frameCount - i, unusedBitsPerSample, pInputSamples0 + i, pInputSamples1 + i,
+      (uint8_t*)pOut0 + i * drflac__get_bytes_per_planar_sample(format),
+      (uint8_t*)pOut1 + i * drflac__get_bytes_per_planar_sample(format), format);
+}
+#endif
+
+static DRFLAC_INLINE void drflac__decode_channel_planar(uint64_t frameCount, uint32_t shift,
+                                                        const int32_t* pInputSamples, void* pOut,
+                                                        int format) {
+#if defined(DRFLAC_SUPPORT_SSE2)
+  if (drflac__gIsSSE2Supported) {
+    drflac__decode_channel_planar__sse2(frameCount, shift, pInputSamples, pOut, format);
+  } else
+#elif defined(DRFLAC_SUPPORT_NEON)
+  if (drflac__gIsNEONSupported) {
+    drflac__decode_channel_planar__neon(frameCount, shift, pInputSamples, pOut, format);
+  } else
+#endif
+  {
+    /* Scalar fallback. */
+    drflac__decode_channel_planar__scalar(frameCount, shift, pInputSamples, pOut, format);
+  }
+}
+
+static DRFLAC_INLINE void drflac__decode_stereo_planar(drflac* pFlac, uint64_t frameCount,
+                                                       uint32_t unusedBitsPerSample,
+                                                       const int32_t* pInputSamples0,
+                                                       const int32_t* pInputSamples1, void* pOut0,
+                                                       void* pOut1, int format) {
+#if defined(DRFLAC_SUPPORT_SSE2)
+  if (drflac__gIsSSE2Supported) {
+    drflac__decode_stereo_planar__sse2(pFlac, frameCount, unusedBitsPerSample, pInputSamples0,
+                                       pInputSamples1, pOut0, pOut1, format);
+  } else
+#elif defined(DRFLAC_SUPPORT_NEON)
+  if (drflac__gIsNEONSupported) {
+    drflac__decode_stereo_planar__neon(pFlac, frameCount, unusedBitsPerSample, pInputSamples0,
+                                       pInputSamples1, pOut0, pOut1, format);
+  } else
+#endif
+  {
+    /* Scalar fallback. */
+    drflac__decode_stereo_planar__scalar(pFlac, frameCount, unusedBitsPerSample, pInputSamples0,
+                                         pInputSamples1, pOut0, pOut1, format);
+  }
+}
+
+static DRFLAC_INLINE uint64_t drflac__read_pcm_frames_planar(drflac* pFlac,
+                                                             uint64_t framesToRead,
+                                                             uint8_t** ppBuffersOut,
+                                                             int format) {
+  uint64_t framesRead;
+  uint32_t unusedBitsPerSample;
+  size_t bytesPerSample = drflac__get_bytes_per_planar_sample(format);
+
+  DRFLAC_ASSERT(pFlac->bitsPerSample <= 32);
+  unusedBitsPerSample = 32 - pFlac->bitsPerSample;
+
+  framesRead = 0;
+  while (framesToRead > 0) {
+    /* If we've run out of samples in this frame, go to the next. */
+    if (pFlac->currentFLACFrame.pcmFramesRemaining == 0) {
+      if (!drflac__read_and_decode_next_flac_frame_for_read(pFlac)) {
+        break; /* Couldn't read the next frame, so just break from the loop and
+                  return. */
+      }
+    } else {
+      unsigned int channelCount = drflac__get_channel_count_from_channel_assignment(
+          pFlac->currentFLACFrame.header.channelAssignment);
+      uint64_t iFirstPCMFrame = pFlac->currentFLACFrame.header.blockSizeInPCMFrames -
+                                pFlac->currentFLACFrame.pcmFramesRemaining;
+      uint64_t frameCountThisIteration = framesToRead;
+      size_t outputOffset = (size_t)framesRead * bytesPerSample;
+
+      if (frameCountThisIteration > pFlac->currentFLACFrame.pcmFramesRemaining) {
+        frameCountThisIteration = pFlac->currentFLACFrame.pcmFramesRemaining;
+      }
+
+      if (channelCount == 2) {
+        drflac__decode_stereo_planar(
+            pFlac, frameCountThisIteration, unusedBitsPerSample,
+            pFlac->currentFLACFrame.subframes[0].pSamplesS32 + iFirstPCMFrame,
+            pFlac->currentFLACFrame.subframes[1].pSamplesS32 + iFirstPCMFrame,
+            ppBuffersOut[0] + outputOffset, ppBuffersOut[1] + outputOffset, format);
+      } else {
+        unsigned int j;
+        for (j = 0; j < channelCount; ++j) {
+          drflac__decode_channel_planar(
+              frameCountThisIteration,
+              unusedBitsPerSample + pFlac->currentFLACFrame.subframes[j].wastedBitsPerSample,
+              pFlac->currentFLACFrame.subframes[j].pSamplesS32 + iFirstPCMFrame,
+              ppBuffersOut[j] + outputOffset, format);
+        }
+      }
+
+      framesRead += frameCountThisIteration;
+      framesToRead -= frameCountThisIteration;
+      pFlac->currentPCMFrame += frameCountThisIteration;
+      pFlac->currentFLACFrame.pcmFramesRemaining -= (uint32_t)frameCountThisIteration;
+    }
+  }
+
+  drflac__read_ahead_at_end_of_link(pFlac);
+  return framesRead;
+}
+
+DRFLAC_API uint64_t drflac_read_pcm_frames_s32_planar(drflac* pFlac, uint64_t framesToRead,
+                                                      int32_t** ppBuffersOut) {
+  uint8_t* pBuffersOut[8];
+  uint32_t iChannel;
+
+  if (pFlac == NULL || framesToRead == 0) { return 0; }
+
+  if (ppBuffersOut == NULL) { return drflac__seek_forward_by_pcm_frames(pFlac, framesToRead); }
+
+  for (iChannel = 0; iChannel < pFlac->channels; ++iChannel) {
+    pBuffersOut[iChannel] = (uint8_t*)ppBuffersOut[iChannel];
+  }
+
+  return drflac__read_pcm_frames_planar(pFlac, framesToRead, pBuffersOut,
+                                        DRFLAC_PLANAR_FORMAT_S32);
+}
+
+DRFLAC_API uint64_t drflac_read_pcm_frames_s16_planar(drflac* pFlac, uint64_t framesToRead,
+                                                      int16_t** ppBuffersOut) {
+  uint8_t* pBuffersOut[8];
+  uint32_t iChannel;
+
+  if (pFlac == NULL || framesToRead == 0) { return 0; }
+
+  if (ppBuffersOut == NULL) { return drflac__seek_forward_by_pcm_frames(pFlac, framesToRead); }
+
+  for (iChannel = 0; iChannel < pFlac->channels; ++iChannel) {
+    pBuffersOut[iChannel] = (uint8_t*)ppBuffersOut[iChannel];
+  }
+
+  return drflac__read_pcm_frames_planar(pFlac, framesToRead, pBuffersOut,
+                                        DRFLAC_PLANAR_FORMAT_S16);
+}
+
+DRFLAC_API uint64_t drflac_read_pcm_frames_f32_planar(drflac* pFlac, uint64_t framesToRead,
+                                                      float** ppBuffersOut) {
+  uint8_t* pBuffersOut[8];
+  uint32_t iChannel;
+
+  if (pFlac == NULL || framesToRead == 0) { return 0; }
+
+  if (ppBuffersOut == NULL) { return drflac__seek_forward_by_pcm_frames(pFlac, framesToRead); }
+
+  for (iChannel = 0; iChannel < pFlac->channels; ++iChannel) {
+    pBuffersOut[iChannel] = (uint8_t*)ppBuffersOut[iChannel];
+  }
+
+  return drflac__read_pcm_frames_planar(pFlac, framesToRead, pBuffersOut,
+                                        DRFLAC_PLANAR_FORMAT_F32);
+}
+
+DRFLAC_API bool drflac_read_next_flac_frame(drflac* pFlac, drflac_frame_view* pView) {
+  unsigned int channelCount;
+  unsigned int iChannel;
+  uint32_t unusedBitsPerSample;
+  uint32_t iFirstPCMFrame;
+  uint32_t frameCount;
+
+  if (pView != NULL) { DRFLAC_ZERO_OBJECT(pView); }
+
+  if (pFlac == NULL || pView == NULL) { return DRFLAC_FALSE; }
+
+  /* If the current frame has already been fully consumed we need to decode the next one. */
+  while (pFlac->currentFLACFrame.pcmFramesRemaining == 0) {
+    if (!drflac__read_and_decode_next_flac_frame(pFlac)) { return DRFLAC_FALSE; }
+  }
+
+  DRFLAC_ASSERT(pFlac->bitsPerSample <= 32);
+  unusedBitsPerSample = 32 - pFlac->bitsPerSample;
+
+  channelCount = drflac__get_channel_count_from_channel_assignment(
+      pFlac->currentFLACFrame.header.channelAssignment);
+  iFirstPCMFrame = pFlac->currentFLACFrame.header.blockSizeInPCMFrames -
+                   pFlac->currentFLACFrame.pcmFramesRemaining;
+  frameCount = pFlac->currentFLACFrame.pcmFramesRemaining;
+
+  /*
+  The decoded samples are turned into their final form in place. The frame is
+  marked as consumed below and flagged so that a backwards seek won't try to
+  re-read the raw subframe data from it. Each kernel loads a block from both
+  channels before storing so the stereo cases work in place too.
+  */
+  if (channelCount == 2) {
+    int32_t* pSamples0 = pFlac->currentFLACFrame.subframes[0].pSamplesS32 + iFirstPCMFrame;
+    int32_t* pSamples1 = pFlac->currentFLACFrame.subframes[1].pSamplesS32 + iFirstPCMFrame;
+    drflac__decode_stereo_planar(pFlac, frameCount, unusedBitsPerSample, pSamples0, pSamples1,
+                                 pSamples0, pSamples1, DRFLAC_PLANAR_FORMAT_S32);
+  } else {
+    for (iChannel = 0; iChannel < channelCount; ++iChannel) {
+      int32_t* pSamples = pFlac->currentFLACFrame.subframes[iChannel].pSamplesS32 + iFirstPCMFrame;
+      drflac__decode_channel_planar(
+          frameCount,
+          unusedBitsPerSample + pFlac->currentFLACFrame.subframes[iChannel].wastedBitsPerSample,
+          pSamples, pSamples, DRFLAC_PLANAR_FORMAT_S32);
+    }
+  }
+
+  pView->firstPCMFrame = pFlac->currentPCMFrame;
+  pView->pcmFrameCount = frameCount;
+  pView->channels = channelCount;
+  for (iChannel = 0; iChannel < channelCount; ++iChannel) {
+    pView->ppSamples[iChannel] =
+        pFlac->currentFLACFrame.subframes[iChannel].pSamplesS32 + iFirstPCMFrame;
+  }
+
+  pFlac->currentPCMFrame += frameCount;
+  pFlac->currentFLACFrame.pcmFramesRemaining = 0;
+  pFlac->currentFLACFrame.isConvertedInPlace = DRFLAC_TRUE;
+
+  return DRFLAC_TRUE;
+}
+
+/* Newton's method. Saves linking against libm for one square root per channel
+ * per frame. */
+static double drflac__sqrt_f64(double x) {
+  uint64_t bits;
+  double r;
+  int i;
+
+  if (x <= 0) { return 0; }
+
+  /* Halving the exponent gets within a few percent, then each step doubles the
+   * number of correct bits. */
+  DRFLAC_COPY_MEMORY(&bits, &x, sizeof(bits));
+  bits = (bits >> 1) + ((uint64_t)0x3FF << 51);
+  DRFLAC_COPY_MEMORY(&r, &bits, sizeof(r));
+
+  for (i = 0; i < 5; ++i) { r = 0.5 * (r + x / r); }
+
+  return r;
+}
+
+/* Folds a run of right justified samples into a running minimum, maximum and
+ * sum of squares. A single pass over the samples is quicker than one for each. */
+static void drflac__summarize_samples(const int32_t* pSamples, uint32_t count, int32_t* pMin,
+                                      int32_t* pMax, double* pSumOfSquares) {
+  int32_t lo = *pMin;
+  int32_t hi = *pMax;
+  double sum = 0;
+  uint32_t i;
+
+  for (i = 0; i < count; ++i) {
+    int32_t sample = pSamples[i];
+    lo = (sample < lo) ? sample : lo;
+    hi = (sample > hi) ? sample : hi;
+    sum += (double)sample * (double)sample;
+  }
+
+  *pMin = lo;
+  *pMax = hi;
+  *pSumOfSquares += sum;
+}
+
+DRFLAC_API bool drflac_read_next_flac_frame_summary(drflac* pFlac,
+                                                    drflac_frame_summary* pSummary) {
+  const drflac_frame* pFrame;
+  int32_t minSample[8];
+  int32_t maxSample[8];
+  double sumOfSquares[8];
+  bool isConstant[8];
+  bool isAllConstant;
+  unsigned int channelCount;
+  unsigned int iChannel;
+  uint32_t iFirstPCMFrame;
+  uint32_t frameCount;
+  uint32_t offset;
+  double scale;
+
+  if (pSummary != NULL) { DRFLAC_ZERO_OBJECT(pSummary); }
+
+  if (pFlac == NULL || pSummary == NULL) { return DRFLAC_FALSE; }
+
+  /* If the current frame has already been fully consumed we need to decode the next one. */
+  while (pFlac->currentFLACFrame.pcmFramesRemaining == 0) {
+    if (!drflac__read_and_decode_next_flac_frame(pFlac)) { return DRFLAC_FALSE; }
+  }
+
+  pFrame = &pFlac->currentFLACFrame;
+  channelCount =
+      drflac__get_channel_count_from_channel_assignment(pFrame->header.channelAssignment);
+  iFirstPCMFrame = pFrame->header.blockSizeInPCMFrames - pFrame->pcmFramesRemaining;
+  frameCount = pFrame->pcmFramesRemaining;
+
+  /*
+  A channel is constant when every subframe it's built from is a CONSTANT
+  subframe. With stereo decorrelation that means both of them. Channels excluded
+  with drflac_set_channel_mask() are reported as silence, so they're treated the
+  same way to avoid scanning them.
+  */
+  isAllConstant = DRFLAC_TRUE;
+  for (iChannel = 0; iChannel < channelCount; ++iChannel) {
+    if (pFrame->header.channelAssignment == DRFLAC_CHANNEL_ASSIGNMENT_INDEPENDENT) {
+      isConstant[iChannel] = pFrame->subframes[iChannel].subframeType == DRFLAC_SUBFRAME_CONSTANT;
+    } else {
+      isConstant[iChannel] = pFrame->subframes[0].subframeType == DRFLAC_SUBFRAME_CONSTANT &&
+                             pFrame->subframes[1].subframeType == DRFLAC_SUBFRAME_CONSTANT;
+    }
+
+    if ((pFlac->_skippedChannelMask & (1U << iChannel)) != 0) {
+      isConstant[iChannel] = DRFLAC_TRUE;
+    }
+
+    isAllConstant = isAllConstant && isConstant[iChannel];
+  }
+
+  /* The first sample stands in for the whole of a constant channel. */
+  {
+    int32_t samples[8][DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES];
+    drflac__md5_get_samples(pFrame, channelCount, iFirstPCMFrame, 1, samples);
+    for (iChannel = 0; iChannel < channelCount; ++iChannel) {
+      minSample[iChannel] = samples[iChannel][0];
+      maxSample[iChannel] = samples[iChannel][0];
+      sumOfSquares[iChannel] = 0;
+      if (isConstant[iChannel]) {
+        sumOfSquares[iChannel] =
+            (double)samples[iChannel][0] * (double)samples[iChannel][0] * (double)frameCount;
+      }
+    }
+  }
+
+  if (isAllConstant) {
+    /* Nothing else to do. */
+  } else if (pFrame->header.channelAssignment == DRFLAC_CHANNEL_ASSIGNMENT_INDEPENDENT) {
+    /* Wasted bits are shifted into the results rather than into every sample. */
+    for (iChannel = 0; iChannel < channelCount; ++iChannel) {
+      const int32_t* pSamples = pFrame->subframes[iChannel].pSamplesS32 + iFirstPCMFrame;
+      uint32_t shift = pFrame->subframes[iChannel].wastedBitsPerSample;
+      int32_t lo = pSamples[0];
+      int32_t hi = pSamples[0];
+      double sum = 0;
+
+      if (isConstant[iChannel]) { continue; }
+
+      drflac__summarize_samples(pSamples, frameCount, &lo, &hi, &sum);
+
+      minSample[iChannel] = (int32_t)((uint32_t)lo << shift);
+      maxSample[iChannel] = (int32_t)((uint32_t)hi << shift);
+      sumOfSquares[iChannel] = sum * (double)((uint64_t)1 << (shift * 2));
+    }
+  } else {
+    /* Stereo decorrelation is undone in small chunks on the stack rather than
+     * converting the frame. */
+    for (offset = 0; offset < frameCount; offset += DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES) {
+      int32_t samples[8][DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES];
+      uint32_t count = frameCount - offset;
+
+      if (count > DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES) {
+        count = DRFLAC_MD5_CHUNK_SIZE_IN_PCM_FRAMES;
+      }
+
+      drflac__md5_get_samples(pFrame, channelCount, iFirstPCMFrame + offset, count, samples);
+
+      for (iChannel = 0; iChannel < channelCount; ++iChannel) {
+        drflac__summarize_samples(samples[iChannel], count, &minSample[iChannel],
+                                  &maxSample[iChannel], &sumOfSquares[iChannel]);
+      }
+    }
+  }
+
+  /* Samples are right justified here, whereas the f32 APIs scale by 2^31 after
+   * shifting them up. */
+  scale = 1.0 / (double)((uint64_t)1 << (pFlac->bitsPerSample - 1));
+
+  pSummary->firstPCMFrame = pFlac->currentPCMFrame;
+  pSummary->pcmFrameCount = frameCount;
+  pSummary->channels = channelCount;
+  for (iChannel = 0; iChannel < channelCount; ++iChannel) {
+    /* With left/side and right/side coding a skipped channel holds a copy of
+     * the other one rather than silence. The summary has already been zeroed. */
+    if ((pFlac->_skippedChannelMask & (1U << iChannel)) != 0) { continue; }
+
+    pSummary->minSample[iChannel] = (float)(minSample[iChannel] * scale);
+    pSummary->maxSample[iChannel] = (float)(maxSample[iChannel] * scale);
+    pSummary->rms[iChannel] =
+        (float)(drflac__sqrt_f64(sumOfSquares[iChannel] / frameCount) * scale);
+  }
+
+  pFlac->currentPCMFrame += frameCount;
+  pFlac->currentFLACFrame.pcmFramesRemaining = 0;
+
+  return DRFLAC_TRUE;
+}
+
+static bool drflac__has_md5(const drflac* pFlac) {
+  uint32_t i;
+  for (i = 0; i < sizeof(pFlac->md5); ++i) {
+    if (pFlac->md5[i] != 0) { return DRFLAC_TRUE; }
+  }
+
+  /* An MD5 of all zeros means the encoder didn't compute one. */
+  return DRFLAC_FALSE;
+}
+
+DRFLAC_API bool drflac_enable_md5_verification(drflac* pFlac) {
+  if (pFlac == NULL || !drflac__has_md5(pFlac)) { return DRFLAC_FALSE; }
+
+  drflac__md5_init(&pFlac->md5Context);
+#ifndef DR_FLAC_NO_OGG
+  pFlac->md5NextPCMFrame = drflac_ogg__get_link_first_pcm_frame(pFlac);
+#else
+  pFlac->md5NextPCMFrame = 0;
+#endif
+  pFlac->_isMD5Enabled = DRFLAC_TRUE;
+  pFlac->_isMD5AtEnd = DRFLAC_FALSE;
+  pFlac->_isMD5Mismatched = DRFLAC_FALSE;
+
+  return DRFLAC_TRUE;
+}
+
+DRFLAC_API bool drflac_set_channel_mask(drflac* pFlac, uint32_t channelMask) {
+  if (pFlac == NULL || (channelMask & 0xFF) == 0) { return DRFLAC_FALSE; }
+
+  pFlac->_skippedChannelMask = (uint8_t)~channelMask;
+  return DRFLAC_TRUE;
+}
+
+DRFLAC_API drflac_md5_result drflac_get_md5_result(drflac* pFlac) {
+  uint64_t endPCMFrame;
+  uint64_t pcmFrameCount;
+
+  if (pFlac == NULL || !drflac__has_md5(pFlac)) { return drflac_md5_unavailable; }
+
+  if (!pFlac->_isMD5Enabled) { return drflac_md5_incomplete; }
+
+  /* An earlier link of a chained Ogg stream didn't match. */
+  if (pFlac->_isMD5Mismatched) { return drflac_md5_mismatch; }
+
+  /* The MD5 covers the current link of a chained Ogg stream. */
+  pcmFrameCount = pFlac->totalPCMFrameCount;
+  endPCMFrame = pFlac->totalPCMFrameCount;
+#ifndef DR_FLAC_NO_OGG
+  if (pFlac->container == drflac_container_ogg) {
+    drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
+    pcmFrameCount = oggbs->linkPCMFrameCount;
+    endPCMFrame = oggbs->linkFirstPCMFrame + oggbs->linkPCMFrameCount;
+  }
+#endif
+
+  if (pcmFrameCount > 0) {
+    if (pFlac->md5NextPCMFrame != endPCMFrame) { return drflac_md5_incomplete; }
+  } else {
+    if (!pFlac->_isMD5AtEnd) { return drflac_md5_incomplete; }
+  }
+
+  return drflac__md5_matches(&pFlac->md5Context, pFlac->md5) ? drflac_md5_match
+                                                              : drflac_md5_mismatch;
+}
+
+DRFLAC_API bool drflac_seek_to_pcm_frame(drflac* pFlac, uint64_t pcmFrameIndex) {
+  if (pFlac == NULL) { return DRFLAC_FALSE; }
+
+  /* Don't do anything if we're already on the seek point. */
+  if (pFlac->currentPCMFrame == pcmFrameIndex) { return DRFLAC_TRUE; }
+
+  /*
+  If we don't know where the first frame begins then we can't seek. This will
+  happen when the STREAMINFO block was not present when the decoder was opened.
+  */
+  if (pFlac->firstFLACFramePosInBytes == 0) { return DRFLAC_FALSE; }
+
+  if (pcmFrameIndex == 0) {
+    pFlac->currentPCMFrame = 0;
+    return drflac__seek_to_first_frame(pFlac);
+  } else {
+    bool wasSuccessful = DRFLAC_FALSE;
+    uint64_t originalPCMFrame = pFlac->currentPCMFrame;
+
+    /* Clamp the sample to the end. */
+    if (pcmFrameIndex > pFlac->totalPCMFrameCount) { pcmFrameIndex = pFlac->totalPCMFrameCount; }
+
+    /* If the target sample and the current sample are in the same frame we just
+     * move the position forward. */
+    if (pcmFrameIndex > pFlac->currentPCMFrame) {
+      /* Forward. */
+      uint32_t offset = (uint32_t)(pcmFrameIndex - pFlac->currentPCMFrame);
+      if (pFlac->currentFLACFrame.pcmFramesRemaining > offset) {
+        pFlac->currentFLACFrame.pcmFramesRemaining -= offset;
+        pFlac->currentPCMFrame = pcmFrameIndex;
+        return DRFLAC_TRUE;
+      }
+    } else {
+      /* Backward. */
+      uint32_t offsetAbs = (uint32_t)(pFlac->currentPCMFrame - pcmFrameIndex);
+      uint32_t currentFLACFramePCMFrameCount =
+          pFlac->currentFLACFrame.header.blockSizeInPCMFrames;
+      uint32_t currentFLACFramePCMFramesConsumed =
+          currentFLACFramePCMFrameCount - pFlac->currentFLACFrame.pcmFramesRemaining;
+      if (currentFLACFramePCMFramesConsumed > offsetAbs &&
+          !pFlac->currentFLACFrame.isConvertedInPlace) {
+        pFlac->currentFLACFrame.pcmFramesRemaining += offsetAbs;
+        pFlac->currentPCMFrame = pcmFrameIndex;
+        return DRFLAC_TRUE;
+      }
+    }
+
+    /*
+    Different techniques depending on encapsulation. Using the native FLAC
+    seektable with Ogg encapsulation is a bit awkward so we'll instead use Ogg's
+    natural seeking facility.
+    */
+#ifndef DR_FLAC_NO_OGG
+    if (pFlac->container == drflac_container_ogg) {
+      wasSuccessful = drflac_ogg__seek_to_pcm_frame(pFlac, pcmFrameIndex);
+    } else
+#endif
+    {
+      /* A seek index is exact so it always takes priority. */
+      wasSuccessful = drflac__seek_to_pcm_frame__seek_index(pFlac, pcmFrameIndex);
+
+      /* First try seeking via the seek table. If this fails, fall back to a
+       * brute force seek which is much slower. */
+      if (!wasSuccessful && !pFlac->_noSeekTableSeek) {
+        wasSuccessful = drflac__seek_to_pcm_frame__seek_table(pFlac, pcmFrameIndex);
+      }
+
+#if !defined(DR_FLAC_NO_CRC)
+      /* Fall back to binary search if seek table seeking fails. This requires
        * the length of the stream to be known. */
       if (!wasSuccessful && !pFlac->_noBinarySearchSeek && pFlac->totalPCMFrameCount > 0) {
         wasSuccessful = drflac__seek_to_pcm_frame__binary_search(pFlac, pcmFrameIndex);
@@ -10531,17 +14547,223 @@ DRFLAC_API bool drflac_seek_to_pcm_frame(drflac* pFlac, uint64_t pcmFrameIndex)
   }
 }
 
-/* High Level APIs */
+DRFLAC_API bool drflac_build_seek_index(drflac* pFlac) {
+  uint64_t originalPCMFrame;
+  uint32_t count = 0;
 
-#if defined(SIZE_MAX)
-#define DRFLAC_SIZE_MAX SIZE_MAX
-#else
-#if defined(DRFLAC_64BIT)
-#define DRFLAC_SIZE_MAX ((uint64_t)0xFFFFFFFFFFFFFFFF)
-#else
-#define DRFLAC_SIZE_MAX 0xFFFFFFFF
+  if (pFlac == NULL || !drflac__can_use_seek_index(pFlac)) { return DRFLAC_FALSE; }
+
+  originalPCMFrame = pFlac->currentPCMFrame;
+
+#ifndef DR_FLAC_NO_OGG
+  if (pFlac->container == drflac_container_ogg) {
+    bool result = drflac_ogg__build_page_index(pFlac);
+
+    drflac__seek_to_first_frame(pFlac);
+    if (originalPCMFrame > 0) { drflac_seek_to_pcm_frame(pFlac, originalPCMFrame); }
+
+    return result;
+  }
 #endif
+
+  /* Make a good guess at the size of the index so we don't need to grow it too often. */
+  if (pFlac->totalPCMFrameCount > 0 && pFlac->maxBlockSizeInPCMFrames > 0) {
+    uint64_t expectedCount = (pFlac->totalPCMFrameCount / pFlac->maxBlockSizeInPCMFrames) + 1;
+    if (expectedCount < 0xFFFFFFFF) { drflac__reserve_seek_index(pFlac, (uint32_t)expectedCount); }
+  }
+
+  if (!drflac__seek_to_first_frame(pFlac)) { return DRFLAC_FALSE; }
+
+  /*
+  Frames are only parsed, not decoded, so this is considerably faster than
+  reading the whole stream. Frames with a CRC mismatch are left out of the index.
+  */
+  for (;;) {
+    uint64_t frameBytePos = drflac__get_byte_pos(&pFlac->bs);
+    drflac_result result;
+
+    if (!drflac__read_next_flac_frame_header(&pFlac->bs, pFlac->bitsPerSample,
+                                             &pFlac->currentFLACFrame.header)) {
+      break;
+    }
+
+    result = drflac__seek_to_next_flac_frame(pFlac);
+    if (result == DRFLAC_SUCCESS) {
+      drflac_seekpoint* pEntry;
+      uint64_t firstPCMFrame;
+
+      if (count == pFlac->seekIndexCapacity) {
+        uint32_t newCapacity = (pFlac->seekIndexCapacity > 0) ? pFlac->seekIndexCapacity * 2 : 256;
+        if (!drflac__reserve_seek_index(pFlac, newCapacity)) {
+          drflac__free_seek_index(pFlac);
+          drflac_seek_to_pcm_frame(pFlac, originalPCMFrame);
+          return DRFLAC_FALSE;
+        }
+      }
+
+      /* Seekpoints are packed so we can't pass a pointer to the member. */
+      drflac__get_pcm_frame_range_of_current_flac_frame(pFlac, &firstPCMFrame, NULL);
+
+      pEntry = &pFlac->pSeekIndex[count];
+      pEntry->firstPCMFrame = firstPCMFrame;
+      pEntry->flacFrameOffset = frameBytePos - pFlac->firstFLACFramePosInBytes;
+      pEntry->pcmFrameCount = pFlac->currentFLACFrame.header.blockSizeInPCMFrames;
+      count += 1;
+    } else if (result != DRFLAC_CRC_MISMATCH) {
+      break;
+    }
+  }
+
+  pFlac->seekIndexCount = count;
+
+  /* Move back to where we were, which will use the new index. */
+  drflac__seek_to_first_frame(pFlac);
+  if (originalPCMFrame > 0) { drflac_seek_to_pcm_frame(pFlac, originalPCMFrame); }
+
+  return count > 0;
+}
+
+/*
+The serialized seek index is little-endian and looks like this:
+
+    "drfi" magic, version (u32), container (u32), entry count (u32), first
+    frame position (u64), total PCM frame count (u64), then for each entry the
+    first PCM frame (u64), the byte offset from the first frame (u64) and the
+    PCM frame count (u16).
+
+For Ogg streams the byte offset is that of the page and the PCM frame count
+holds the position of the frame within the page. See
+drflac_ogg__find_start_points_in_current_page(). The entries mean different
+things for each container, so an index is only loaded into a decoder of the
+container it was saved from.
+
+The first frame position and total PCM frame count are used as a cheap check
+that the index belongs to the stream it's being loaded into. With a chained Ogg
+stream they're those of the first link since the total grows as links are found.
+*/
+#define DRFLAC_SEEK_INDEX_VERSION 2
+#define DRFLAC_SEEK_INDEX_HEADER_SIZE 32
+#define DRFLAC_SEEK_INDEX_ENTRY_SIZE 18
+
+static void drflac__write_le(uint8_t* pData, uint64_t value, uint32_t byteCount) {
+  uint32_t i;
+  for (i = 0; i < byteCount; ++i) { pData[i] = (uint8_t)(value >> (i * 8)); }
+}
+
+static uint64_t drflac__read_le(const uint8_t* pData, uint32_t byteCount) {
+  uint64_t value = 0;
+  uint32_t i;
+  for (i = 0; i < byteCount; ++i) { value |= (uint64_t)pData[i] << (i * 8); }
+  return value;
+}
+
+static void drflac__get_seek_index_stream_id(drflac* pFlac, uint64_t* pFirstFramePos,
+                                             uint64_t* pTotalPCMFrameCount) {
+  *pFirstFramePos = pFlac->firstFLACFramePosInBytes;
+  *pTotalPCMFrameCount = pFlac->totalPCMFrameCount;
+
+#ifndef DR_FLAC_NO_OGG
+  if (pFlac->container == drflac_container_ogg) {
+    drflac_oggbs* oggbs = (drflac_oggbs*)pFlac->_oggbs;
+    if (oggbs->linkCount > 0) {
+      *pFirstFramePos = oggbs->pLinks[0].firstFramePos;
+      *pTotalPCMFrameCount = oggbs->pLinks[0].streaminfo.totalPCMFrameCount;
+    }
+  }
 #endif
+}
+
+DRFLAC_API size_t drflac_save_seek_index(drflac* pFlac, void* pData, size_t dataSize) {
+  uint8_t* pRunningData = (uint8_t*)pData;
+  size_t requiredSize;
+  uint64_t firstFramePos;
+  uint64_t totalPCMFrameCount;
+  uint32_t iEntry;
+
+  if (pFlac == NULL || pFlac->pSeekIndex == NULL || pFlac->seekIndexCount == 0) { return 0; }
+
+  requiredSize = DRFLAC_SEEK_INDEX_HEADER_SIZE +
+                 (size_t)pFlac->seekIndexCount * DRFLAC_SEEK_INDEX_ENTRY_SIZE;
+  if (pData == NULL) { return requiredSize; }
+  if (dataSize < requiredSize) { return 0; }
+
+  pRunningData[0] = 'd';
+  pRunningData[1] = 'r';
+  pRunningData[2] = 'f';
+  pRunningData[3] = 'i';
+  drflac__write_le(pRunningData + 4, DRFLAC_SEEK_INDEX_VERSION, 4);
+  drflac__write_le(pRunningData + 8, (uint32_t)pFlac->container, 4);
+  drflac__get_seek_index_stream_id(pFlac, &firstFramePos, &totalPCMFrameCount);
+  drflac__write_le(pRunningData + 12, pFlac->seekIndexCount, 4);
+  drflac__write_le(pRunningData + 16, firstFramePos, 8);
+  drflac__write_le(pRunningData + 24, totalPCMFrameCount, 8);
+  pRunningData += DRFLAC_SEEK_INDEX_HEADER_SIZE;
+
+  for (iEntry = 0; iEntry < pFlac->seekIndexCount; ++iEntry) {
+    drflac__write_le(pRunningData + 0, pFlac->pSeekIndex[iEntry].firstPCMFrame, 8);
+    drflac__write_le(pRunningData + 8, pFlac->pSeekIndex[iEntry].flacFrameOffset, 8);
+    drflac__write_le(pRunningData + 16, pFlac->pSeekIndex[iEntry].pcmFrameCount, 2);
+    pRunningData += DRFLAC_SEEK_INDEX_ENTRY_SIZE;
+  }
+
+  return requiredSize;
+}
+
+DRFLAC_API bool drflac_load_seek_index(drflac* pFlac, const void* pData, size_t dataSize) {
+  const uint8_t* pRunningData = (const uint8_t*)pData;
+  uint64_t firstFramePos;
+  uint64_t totalPCMFrameCount;
+  uint32_t count;
+  uint32_t iEntry;
+
+  if (pFlac == NULL || pData == NULL || dataSize < DRFLAC_SEEK_INDEX_HEADER_SIZE) {
+    return DRFLAC_FALSE;
+  }
+
+  if (!drflac__can_use_seek_index(pFlac)) { return DRFLAC_FALSE; }
+
+  if (pRunningData[0] != 'd' || pRunningData[1] != 'r' || pRunningData[2] != 'f' ||
+      pRunningData[3] != 'i' ||
+      drflac__read_le(pRunningData + 4, 4) != DRFLAC_SEEK_INDEX_VERSION) {
+    return DRFLAC_FALSE;
+  }
+
+  drflac__get_seek_index_stream_id(pFlac, &firstFramePos, &totalPCMFrameCount);
+  if (drflac__read_le(pRunningData + 8, 4) != (uint32_t)pFlac->container ||
+      drflac__read_le(pRunningData + 16, 8) != firstFramePos ||
+      drflac__read_le(pRunningData + 24, 8) != totalPCMFrameCount) {
+    return DRFLAC_FALSE; /* Belongs to a different stream. */
+  }
+
+  count = (uint32_t)drflac__read_le(pRunningData + 12, 4);
+  if (count == 0 ||
+      (dataSize - DRFLAC_SEEK_INDEX_HEADER_SIZE) / DRFLAC_SEEK_INDEX_ENTRY_SIZE < count) {
+    return DRFLAC_FALSE;
+  }
+
+  drflac__free_seek_index(pFlac);
+  if (!drflac__reserve_seek_index(pFlac, count)) { return DRFLAC_FALSE; }
+
+  pRunningData += DRFLAC_SEEK_INDEX_HEADER_SIZE;
+  for (iEntry = 0; iEntry < count; ++iEntry) {
+    drflac_seekpoint* pEntry = &pFlac->pSeekIndex[iEntry];
+    pEntry->firstPCMFrame = drflac__read_le(pRunningData + 0, 8);
+    pEntry->flacFrameOffset = drflac__read_le(pRunningData + 8, 8);
+    pEntry->pcmFrameCount = (uint16_t)drflac__read_le(pRunningData + 16, 2);
+    pRunningData += DRFLAC_SEEK_INDEX_ENTRY_SIZE;
+
+    /* The seek relies on a binary search so the entries must be sorted. */
+    if (iEntry > 0 && pEntry->firstPCMFrame <= pEntry[-1].firstPCMFrame) {
+      drflac__free_seek_index(pFlac);
+      return DRFLAC_FALSE;
+    }
+  }
+
+  pFlac->seekIndexCount = count;
+  return DRFLAC_TRUE;
+}
+
+/* High Level APIs */
 
 /* Using a macro as the definition of the drflac__full_decode_and_close_*() API
  * family. Sue me. */
@@ -10767,6 +14989,327 @@ DRFLAC_API float* drflac_open_memory_and_read_pcm_frames_f32(
   return drflac__full_read_and_close_f32(pFlac, channels, sampleRate, totalPCMFrameCount);
 }
 
+/*
+Parallel decoding. Each job opens its own decoder on the same block of memory,
+seeks to the start of its slice and decodes straight into the shared output
+buffer. Slices never overlap so the only shared state is the read-only input.
+*/
+typedef struct {
+  const void* pData;
+  size_t dataSize;
+  const drlibs_allocation_callbacks* pAllocationCallbacks;
+  uint64_t totalPCMFrameCount;
+  uint32_t channels;
+  uint32_t jobCount;
+  void* pSampleData;
+  bool* pJobResults;
+  uint64_t* pJobPCMFrameCounts;
+} drflac__parallel_decode_context;
+
+static void drflac__get_parallel_decode_slice(const drflac__parallel_decode_context* pContext,
+                                              uint32_t jobIndex, uint64_t* pFirstPCMFrame,
+                                              uint64_t* pPCMFrameCount) {
+  uint64_t baseFrameCount = pContext->totalPCMFrameCount / pContext->jobCount;
+  uint64_t remainder = pContext->totalPCMFrameCount % pContext->jobCount;
+
+  /* The first few slices take one extra frame each to spread out the remainder. */
+  *pFirstPCMFrame = (baseFrameCount * jobIndex) + ((jobIndex < remainder) ? jobIndex : remainder);
+  *pPCMFrameCount = baseFrameCount + ((jobIndex < remainder) ? 1 : 0);
+}
+
+static void drflac__run_jobs_serial(void* pUserData, drflac_job_proc onJob, void* pJobUserData,
+                                    uint32_t jobCount) {
+  uint32_t iJob;
+
+  (void)pUserData;
+
+  for (iJob = 0; iJob < jobCount; iJob += 1) {
+    onJob(pJobUserData, iJob);
+  }
+}
+
+#define DRFLAC_DEFINE_DECODE_PARALLEL(extension, type)                                             \
+  static void drflac__decode_parallel_job_##extension(void* pJobUserData, uint32_t jobIndex) {     \
+    drflac__parallel_decode_context* pContext = (drflac__parallel_decode_context*)pJobUserData;    \
+    uint64_t firstPCMFrame;                                                                        \
+    uint64_t pcmFrameCount;                                                                        \
+    uint64_t pcmFramesRead = 0;                                                                    \
+    bool result = DRFLAC_FALSE;                                                                    \
+    drflac* pFlac;                                                                                 \
+                                                                                                   \
+    drflac__get_parallel_decode_slice(pContext, jobIndex, &firstPCMFrame, &pcmFrameCount);         \
+                                                                                                   \
+    pFlac = drflac_open_memory(pContext->pData, pContext->dataSize,                                \
+                               pContext->pAllocationCallbacks);                                    \
+    if (pFlac != NULL) {                                                                           \
+      /* A slice past the real end of the stream fails to seek and reads nothing. */               \
+      if (drflac_seek_to_pcm_frame(pFlac, firstPCMFrame)) {                                        \
+        type* pOutput = (type*)pContext->pSampleData + (firstPCMFrame * pContext->channels);       \
+        pcmFramesRead = drflac_read_pcm_frames_##extension(pFlac, pcmFrameCount, pOutput);         \
+      }                                                                                            \
+      result = DRFLAC_TRUE;                                                                        \
+      drflac_close(pFlac);                                                                         \
+    }                                                                                              \
+                                                                                                   \
+    pContext->pJobResults[jobIndex] = result;                                                      \
+    pContext->pJobPCMFrameCounts[jobIndex] = pcmFramesRead;                                        \
+  }                                                                                                \
+                                                                                                   \
+  DRFLAC_API type* drflac_decode_parallel_##extension(                                             \
+      const void* pData, size_t dataSize, uint32_t jobCount, drflac_run_jobs_proc onRunJobs,       \
+      void* pUserData, unsigned int* channelsOut, unsigned int* sampleRateOut,                     \
+      uint64_t* totalPCMFrameCountOut, const drlibs_allocation_callbacks* pAllocationCallbacks) {  \
+    drflac__parallel_decode_context context;                                                       \
+    drflac* pFlac;                                                                                 \
+    uint64_t dataSizeInBytes;                                                                      \
+    uint64_t pcmFramesDecoded;                                                                     \
+    bool isStreamShort;                                                                            \
+    uint32_t iJob;                                                                                 \
+                                                                                                   \
+    if (channelsOut) { *channelsOut = 0; }                                                         \
+    if (sampleRateOut) { *sampleRateOut = 0; }                                                     \
+    if (totalPCMFrameCountOut) { *totalPCMFrameCountOut = 0; }                                     \
+                                                                                                   \
+    pFlac = drflac_open_memory(pData, dataSize, pAllocationCallbacks);                             \
+    if (pFlac == NULL) { return NULL; }                                                            \
+                                                                                                   \
+    /* Without a known length or a known first frame there's no way to split the stream. */       \
+    if (pFlac->totalPCMFrameCount == 0 || pFlac->firstFLACFramePosInBytes == 0 || jobCount < 2) {  \
+      return drflac__full_read_and_close_##extension(pFlac, channelsOut, sampleRateOut,            \
+                                                     totalPCMFrameCountOut);                       \
+    }                                                                                              \
+                                                                                                   \
+    DRFLAC_ZERO_OBJECT(&context);                                                                  \
+    context.pData = pData;                                                                         \
+    context.dataSize = dataSize;                                                                   \
+    context.pAllocationCallbacks = pAllocationCallbacks;                                           \
+    context.totalPCMFrameCount = pFlac->totalPCMFrameCount;                                        \
+    context.channels = pFlac->channels;                                                            \
+    context.jobCount = jobCount;                                                                   \
+    if (context.jobCount > context.totalPCMFrameCount) {                                           \
+      context.jobCount = (uint32_t)context.totalPCMFrameCount;                                     \
+    }                                                                                              \
+                                                                                                   \
+    dataSizeInBytes = context.totalPCMFrameCount * context.channels * sizeof(type);                \
+    if (dataSizeInBytes > (uint64_t)DRFLAC_SIZE_MAX) {                                             \
+      drflac_close(pFlac);                                                                         \
+      return NULL; /* The decoded data is too big. */                                              \
+    }                                                                                              \
+                                                                                                   \
+    context.pSampleData =                                                                          \
+        drflac__malloc_from_callbacks((size_t)dataSizeInBytes, &pFlac->allocationCallbacks);       \
+    context.pJobResults = (bool*)drflac__malloc_from_callbacks(                                    \
+        sizeof(*context.pJobResults) * context.jobCount, &pFlac->allocationCallbacks);             \
+    context.pJobPCMFrameCounts = (uint64_t*)drflac__malloc_from_callbacks(                         \
+        sizeof(*context.pJobPCMFrameCounts) * context.jobCount, &pFlac->allocationCallbacks);      \
+    if (context.pSampleData == NULL || context.pJobResults == NULL ||                              \
+        context.pJobPCMFrameCounts == NULL) {                                                      \
+      drflac__free_from_callbacks(context.pSampleData, &pFlac->allocationCallbacks);               \
+      drflac__free_from_callbacks(context.pJobResults, &pFlac->allocationCallbacks);               \
+      drflac__free_from_callbacks(context.pJobPCMFrameCounts, &pFlac->allocationCallbacks);        \
+      drflac_close(pFlac);                                                                         \
+      return NULL;                                                                                 \
+    }                                                                                              \
+                                                                                                   \
+    if (onRunJobs == NULL) { onRunJobs = drflac__run_jobs_serial; }                                \
+    onRunJobs(pUserData, drflac__decode_parallel_job_##extension, &context, context.jobCount);     \
+                                                                                                   \
+    /*                                                                                             \
+    The stream can hold less audio than STREAMINFO says, in which case a slice                     \
+    comes up short. Everything up to that point is returned, the same as a serial                  \
+    read, and the rest of the buffer is silenced.                                                  \
+    */                                                                                             \
+    pcmFramesDecoded = 0;                                                                          \
+    isStreamShort = DRFLAC_FALSE;                                                                  \
+    for (iJob = 0; iJob < context.jobCount; iJob += 1) {                                           \
+      uint64_t firstPCMFrame;                                                                      \
+      uint64_t pcmFrameCount;                                                                      \
+                                                                                                   \
+      if (!context.pJobResults[iJob]) {                                                            \
+        drflac__free_from_callbacks(context.pSampleData, &pFlac->allocationCallbacks);             \
+        context.pSampleData = NULL;                                                                \
+        break;                                                                                     \
+      }                                                                                            \
+                                                                                                   \
+      if (!isStreamShort) {                                                                        \
+        drflac__get_parallel_decode_slice(&context, iJob, &firstPCMFrame, &pcmFrameCount);         \
+        pcmFramesDecoded = firstPCMFrame + context.pJobPCMFrameCounts[iJob];                       \
+        isStreamShort = context.pJobPCMFrameCounts[iJob] < pcmFrameCount;                          \
+      }                                                                                            \
+    }                                                                                              \
+    drflac__free_from_callbacks(context.pJobResults, &pFlac->allocationCallbacks);                 \
+    drflac__free_from_callbacks(context.pJobPCMFrameCounts, &pFlac->allocationCallbacks);          \
+                                                                                                   \
+    if (context.pSampleData != NULL) {                                                             \
+      DRFLAC_ZERO_MEMORY((type*)context.pSampleData + (pcmFramesDecoded * context.channels),       \
+                         (size_t)(dataSizeInBytes -                                                \
+                                  pcmFramesDecoded * context.channels * sizeof(type)));            \
+                                                                                                   \
+      if (sampleRateOut) { *sampleRateOut = pFlac->sampleRate; }                                   \
+      if (channelsOut) { *channelsOut = pFlac->channels; }                                         \
+      if (totalPCMFrameCountOut) { *totalPCMFrameCountOut = pcmFramesDecoded; }                    \
+    }                                                                                              \
+                                                                                                   \
+    drflac_close(pFlac);                                                                           \
+    return (type*)context.pSampleData;                                                             \
+  }
+
+DRFLAC_DEFINE_DECODE_PARALLEL(s32, int32_t)
+DRFLAC_DEFINE_DECODE_PARALLEL(s16, int16_t)
+DRFLAC_DEFINE_DECODE_PARALLEL(f32, float)
+
+/*
+Batch decoding. The streams are laid out in the arena one after the other, and
+each job takes a run of consecutive streams covering its share of the samples.
+A job keeps a single decoder which it reopens for each of its streams.
+*/
+typedef struct {
+  const drflac_batch_input* pInputs;
+  drflac_batch_output* pOutputs;
+  uint32_t inputCount;
+  uint32_t jobCount;
+  uint64_t totalSampleCount;
+  void* pArena;
+  const drlibs_allocation_callbacks* pAllocationCallbacks;
+} drflac__batch_decode_context;
+
+static uint64_t drflac__layout_batch(const drflac_batch_input* pInputs, uint32_t inputCount,
+                                     drflac_batch_output* pOutputs,
+                                     const drlibs_allocation_callbacks* pAllocationCallbacks) {
+  uint64_t offset = 0;
+  uint32_t iInput;
+
+  for (iInput = 0; iInput < inputCount; iInput += 1) {
+    drflac_batch_output* pOutput = &pOutputs[iInput];
+    drflac_streaminfo streaminfo;
+
+    DRFLAC_ZERO_OBJECT(pOutput);
+    pOutput->offset = offset;
+
+    if (drflac_probe_memory(pInputs[iInput].pData, pInputs[iInput].dataSize, NULL, NULL,
+                            &streaminfo, pAllocationCallbacks)) {
+      pOutput->pcmFrameCount = streaminfo.totalPCMFrameCount;
+      pOutput->sampleRate = streaminfo.sampleRate;
+      pOutput->channels = streaminfo.channels;
+      offset += pOutput->pcmFrameCount * pOutput->channels;
+    }
+  }
+
+  return offset;
+}
+
+/* Finds the first stream starting at or after the given sample. */
+static uint32_t drflac__find_batch_input(const drflac__batch_decode_context* pContext,
+                                         uint64_t sampleIndex) {
+  uint32_t lo = 0;
+  uint32_t hi = pContext->inputCount;
+
+  while (lo < hi) {
+    uint32_t mid = lo + ((hi - lo) / 2);
+    if (pContext->pOutputs[mid].offset < sampleIndex) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+static void drflac__get_batch_decode_range(const drflac__batch_decode_context* pContext,
+                                           uint32_t jobIndex, uint32_t* pFirstInput,
+                                           uint32_t* pEndInput) {
+  uint64_t baseSampleCount = pContext->totalSampleCount / pContext->jobCount;
+  uint64_t remainder = pContext->totalSampleCount % pContext->jobCount;
+  uint64_t firstSample;
+  uint64_t endSample;
+
+  firstSample = (baseSampleCount * jobIndex) + ((jobIndex < remainder) ? jobIndex : remainder);
+  endSample = firstSample + baseSampleCount + ((jobIndex < remainder) ? 1 : 0);
+
+  /* The first job also takes any streams that take no space at the start. */
+  *pFirstInput = (jobIndex == 0) ? 0 : drflac__find_batch_input(pContext, firstSample);
+  *pEndInput = (jobIndex + 1 == pContext->jobCount)
+                   ? pContext->inputCount
+                   : drflac__find_batch_input(pContext, endSample);
+}
+
+#define DRFLAC_DEFINE_DECODE_BATCH(extension, type)                                                \
+  static void drflac__decode_batch_job_##extension(void* pJobUserData, uint32_t jobIndex) {        \
+    drflac__batch_decode_context* pContext = (drflac__batch_decode_context*)pJobUserData;          \
+    drflac* pFlac = NULL;                                                                          \
+    uint32_t iInput;                                                                               \
+    uint32_t endInput;                                                                             \
+                                                                                                   \
+    drflac__get_batch_decode_range(pContext, jobIndex, &iInput, &endInput);                        \
+                                                                                                   \
+    for (; iInput < endInput; iInput += 1) {                                                       \
+      const drflac_batch_input* pInput = &pContext->pInputs[iInput];                               \
+      drflac_batch_output* pOutput = &pContext->pOutputs[iInput];                                  \
+      type* pClipOutput = (type*)pContext->pArena + pOutput->offset;                               \
+      uint64_t pcmFrameCount = pOutput->pcmFrameCount;                                             \
+      uint64_t framesRead = 0;                                                                     \
+                                                                                                   \
+      if (pcmFrameCount == 0) { continue; }                                                        \
+                                                                                                   \
+      if (pFlac == NULL) {                                                                         \
+        pFlac = drflac_open_memory(pInput->pData, pInput->dataSize,                                \
+                                   pContext->pAllocationCallbacks);                                \
+      } else {                                                                                     \
+        pFlac = drflac_reopen_memory(pFlac, pInput->pData, pInput->dataSize, NULL, NULL);          \
+      }                                                                                            \
+                                                                                                   \
+      /* The arena was laid out from STREAMINFO so the format can't be any different. */           \
+      if (pFlac != NULL && pFlac->channels == pOutput->channels) {                                 \
+        framesRead = drflac_read_pcm_frames_##extension(pFlac, pcmFrameCount, pClipOutput);        \
+      }                                                                                            \
+                                                                                                   \
+      if (framesRead < pcmFrameCount) {                                                            \
+        DRFLAC_ZERO_MEMORY(pClipOutput + (framesRead * pOutput->channels),                         \
+                           (size_t)((pcmFrameCount - framesRead) * pOutput->channels *             \
+                                    sizeof(type)));                                                \
+        pOutput->pcmFrameCount = framesRead;                                                       \
+      }                                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    drflac_close(pFlac);                                                                           \
+  }                                                                                                \
+                                                                                                   \
+  DRFLAC_API uint64_t drflac_decode_batch_##extension(                                             \
+      const drflac_batch_input* pInputs, uint32_t inputCount, type* pArena,                        \
+      uint64_t arenaSizeInSamples, drflac_batch_output* pOutputs, uint32_t jobCount,               \
+      drflac_run_jobs_proc onRunJobs, void* pUserData,                                             \
+      const drlibs_allocation_callbacks* pAllocationCallbacks) {                                   \
+    drflac__batch_decode_context context;                                                          \
+                                                                                                   \
+    if ((pInputs == NULL && inputCount > 0) || pOutputs == NULL) { return 0; }                     \
+                                                                                                   \
+    DRFLAC_ZERO_OBJECT(&context);                                                                  \
+    context.pInputs = pInputs;                                                                     \
+    context.pOutputs = pOutputs;                                                                   \
+    context.inputCount = inputCount;                                                               \
+    context.pArena = pArena;                                                                       \
+    context.pAllocationCallbacks = pAllocationCallbacks;                                           \
+    context.totalSampleCount =                                                                     \
+        drflac__layout_batch(pInputs, inputCount, pOutputs, pAllocationCallbacks);                 \
+                                                                                                   \
+    if (pArena == NULL || context.totalSampleCount == 0) { return context.totalSampleCount; }      \
+    if (arenaSizeInSamples < context.totalSampleCount) { return 0; }                               \
+                                                                                                   \
+    /* There's no point having more jobs than streams. */                                          \
+    context.jobCount = (jobCount > 0) ? jobCount : 1;                                              \
+    if (context.jobCount > inputCount) { context.jobCount = inputCount; }                          \
+                                                                                                   \
+    if (onRunJobs == NULL) { onRunJobs = drflac__run_jobs_serial; }                                \
+    onRunJobs(pUserData, drflac__decode_batch_job_##extension, &context, context.jobCount);        \
+                                                                                                   \
+    return context.totalSampleCount;                                                               \
+  }
+
+DRFLAC_DEFINE_DECODE_BATCH(s32, int32_t)
+DRFLAC_DEFINE_DECODE_BATCH(s16, int16_t)
+DRFLAC_DEFINE_DECODE_BATCH(f32, float)
+
 DRFLAC_API void drflac_free(void* p, const drlibs_allocation_callbacks* pAllocationCallbacks) {
   if (pAllocationCallbacks != NULL) {
     drflac__free_from_callbacks(p, pAllocationCallbacks);
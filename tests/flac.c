@@ -0,0 +1,1803 @@
+#include <dr_libs/dr_flac.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Behaviour tests for dr_flac. Every stream is generated in memory using verbatim
+subframes, so the expected output is known exactly and no test files are needed.
+*/
+
+static int g_failureCount = 0;
+
+#define TEST_CHECK(condition)                                                                      \
+  do {                                                                                             \
+    if (!(condition)) {                                                                            \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);                         \
+      g_failureCount += 1;                                                                         \
+    }                                                                                              \
+  } while (0)
+
+/* Stream writing */
+
+typedef struct {
+  uint8_t* pData;
+  size_t size;
+  size_t capacity;
+  uint8_t bitCache;
+  uint32_t bitCount;
+} test_stream;
+
+static void test_stream_uninit(test_stream* pStream) {
+  free(pStream->pData);
+  memset(pStream, 0, sizeof(*pStream));
+}
+
+static void test_write_byte(test_stream* pStream, uint8_t value) {
+  if (pStream->size == pStream->capacity) {
+    size_t newCapacity = pStream->capacity == 0 ? 4096 : pStream->capacity * 2;
+    uint8_t* pNewData = (uint8_t*)realloc(pStream->pData, newCapacity);
+    if (pNewData == NULL) {
+      printf("out of memory\n");
+      exit(1);
+    }
+    pStream->pData = pNewData;
+    pStream->capacity = newCapacity;
+  }
+  pStream->pData[pStream->size++] = value;
+}
+
+static void test_write_bytes(test_stream* pStream, const void* pData, size_t size) {
+  size_t i;
+  for (i = 0; i < size; i += 1) { test_write_byte(pStream, ((const uint8_t*)pData)[i]); }
+}
+
+/* Writes the low bitCount bits of value, most significant bit first. */
+static void test_write_bits(test_stream* pStream, uint64_t value, uint32_t bitCount) {
+  while (bitCount > 0) {
+    bitCount -= 1;
+    pStream->bitCache = (uint8_t)((pStream->bitCache << 1) | ((value >> bitCount) & 1));
+    pStream->bitCount += 1;
+    if (pStream->bitCount == 8) {
+      test_write_byte(pStream, pStream->bitCache);
+      pStream->bitCache = 0;
+      pStream->bitCount = 0;
+    }
+  }
+}
+
+static void test_write_u32_be(test_stream* pStream, uint32_t value) {
+  test_write_bits(pStream, value, 32);
+}
+
+static uint8_t test_crc8(const uint8_t* pData, size_t size) {
+  uint8_t crc = 0;
+  size_t i;
+  int iBit;
+  for (i = 0; i < size; i += 1) {
+    crc ^= pData[i];
+    for (iBit = 0; iBit < 8; iBit += 1) {
+      crc = (uint8_t)((crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1));
+    }
+  }
+  return crc;
+}
+
+static uint16_t test_crc16(const uint8_t* pData, size_t size) {
+  uint16_t crc = 0;
+  size_t i;
+  int iBit;
+  for (i = 0; i < size; i += 1) {
+    crc ^= (uint16_t)(pData[i] << 8);
+    for (iBit = 0; iBit < 8; iBit += 1) {
+      crc = (uint16_t)((crc & 0x8000) ? (crc << 1) ^ 0x8005 : (crc << 1));
+    }
+  }
+  return crc;
+}
+
+/* MD5, as in RFC 1321. Only used to put a correct hash in STREAMINFO. */
+
+static void test_md5_block(uint32_t state[4], const uint8_t* pBlock) {
+  static const uint32_t k[64] = {
+      0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613,
+      0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193,
+      0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d,
+      0x02441453, 0xd8a1e681, 0xe7d3fbc8, 0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+      0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122,
+      0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+      0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665, 0xf4292244,
+      0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+      0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb,
+      0xeb86d391};
+  static const uint8_t r[16] = {7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21};
+  uint32_t m[16];
+  uint32_t a = state[0];
+  uint32_t b = state[1];
+  uint32_t c = state[2];
+  uint32_t d = state[3];
+  uint32_t i;
+
+  for (i = 0; i < 16; i += 1) {
+    m[i] = (uint32_t)pBlock[i * 4 + 0] | ((uint32_t)pBlock[i * 4 + 1] << 8) |
+           ((uint32_t)pBlock[i * 4 + 2] << 16) | ((uint32_t)pBlock[i * 4 + 3] << 24);
+  }
+
+  for (i = 0; i < 64; i += 1) {
+    uint32_t f;
+    uint32_t g;
+    uint32_t temp;
+
+    if (i < 16) {
+      f = (b & c) | (~b & d);
+      g = i;
+    } else if (i < 32) {
+      f = (d & b) | (~d & c);
+      g = (5 * i + 1) % 16;
+    } else if (i < 48) {
+      f = b ^ c ^ d;
+      g = (3 * i + 5) % 16;
+    } else {
+      f = c ^ (b | ~d);
+      g = (7 * i) % 16;
+    }
+
+    temp = a + f + k[i] + m[g];
+    a = d;
+    d = c;
+    c = b;
+    b += (temp << r[(i / 16) * 4 + (i % 4)]) | (temp >> (32 - r[(i / 16) * 4 + (i % 4)]));
+  }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+}
+
+static void test_md5(const uint8_t* pData, size_t size, uint8_t digest[16]) {
+  uint32_t state[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+  uint8_t tail[128];
+  size_t tailSize;
+  size_t i;
+
+  for (i = 0; i + 64 <= size; i += 64) { test_md5_block(state, pData + i); }
+
+  tailSize = size - i;
+  memset(tail, 0, sizeof(tail));
+  memcpy(tail, pData + i, tailSize);
+  tail[tailSize] = 0x80;
+  tailSize = (tailSize + 1 + 8 <= 64) ? 64 : 128;
+  for (i = 0; i < 8; i += 1) {
+    tail[tailSize - 8 + i] = (uint8_t)(((uint64_t)size * 8) >> (i * 8));
+  }
+  for (i = 0; i < tailSize; i += 64) { test_md5_block(state, tail + i); }
+
+  for (i = 0; i < 16; i += 1) { digest[i] = (uint8_t)(state[i / 4] >> ((i % 4) * 8)); }
+}
+
+/* Test audio */
+
+typedef struct {
+  uint32_t sampleRate;
+  uint32_t channels;
+  uint32_t blockSize;
+  uint64_t totalPCMFrameCount;
+  int16_t* pSamples; /* Interleaved. */
+  uint8_t md5[16];
+} test_audio;
+
+static void test_audio_init(test_audio* pAudio, uint32_t sampleRate, uint32_t channels,
+                            uint32_t blockSize, uint64_t totalPCMFrameCount, uint32_t seed) {
+  size_t sampleCount = (size_t)totalPCMFrameCount * channels;
+  uint8_t* pBytes;
+  size_t i;
+
+  pAudio->sampleRate = sampleRate;
+  pAudio->channels = channels;
+  pAudio->blockSize = blockSize;
+  pAudio->totalPCMFrameCount = totalPCMFrameCount;
+  pAudio->pSamples = (int16_t*)malloc(sampleCount * sizeof(int16_t));
+  pBytes = (uint8_t*)malloc(sampleCount * 2);
+  if (pAudio->pSamples == NULL || pBytes == NULL) {
+    printf("out of memory\n");
+    exit(1);
+  }
+
+  /* Noise, so every sample is distinct enough to catch misplaced audio. */
+  for (i = 0; i < sampleCount; i += 1) {
+    seed = seed * 1664525 + 1013904223;
+    pAudio->pSamples[i] = (int16_t)(seed >> 16);
+    pBytes[i * 2 + 0] = (uint8_t)((uint16_t)pAudio->pSamples[i] >> 0);
+    pBytes[i * 2 + 1] = (uint8_t)((uint16_t)pAudio->pSamples[i] >> 8);
+  }
+
+  test_md5(pBytes, sampleCount * 2, pAudio->md5);
+  free(pBytes);
+}
+
+static void test_audio_uninit(test_audio* pAudio) { free(pAudio->pSamples); }
+
+static bool test_audio_equal(const test_audio* pAudio, uint64_t firstPCMFrame,
+                             const int32_t* pSamples, uint64_t pcmFrameCount) {
+  size_t first = (size_t)firstPCMFrame * pAudio->channels;
+  size_t i;
+
+  if (firstPCMFrame + pcmFrameCount > pAudio->totalPCMFrameCount) { return DRFLAC_FALSE; }
+
+  for (i = 0; i < (size_t)pcmFrameCount * pAudio->channels; i += 1) {
+    if (pSamples[i] != (int32_t)pAudio->pSamples[first + i] * 65536) { return DRFLAC_FALSE; }
+  }
+  return DRFLAC_TRUE;
+}
+
+/* FLAC encoding */
+
+static void test_write_block_header(test_stream* pStream, bool isLast, uint8_t blockType,
+                                    uint32_t blockSize) {
+  test_write_bits(pStream, isLast ? 1 : 0, 1);
+  test_write_bits(pStream, blockType, 7);
+  test_write_bits(pStream, blockSize, 24);
+}
+
+static void test_write_streaminfo(test_stream* pStream, const test_audio* pAudio) {
+  test_write_bits(pStream, pAudio->blockSize, 16);
+  test_write_bits(pStream, pAudio->blockSize, 16);
+  test_write_bits(pStream, 0, 24);
+  test_write_bits(pStream, 0, 24);
+  test_write_bits(pStream, pAudio->sampleRate, 20);
+  test_write_bits(pStream, pAudio->channels - 1, 3);
+  test_write_bits(pStream, 16 - 1, 5);
+  test_write_bits(pStream, pAudio->totalPCMFrameCount, 36);
+  test_write_bytes(pStream, pAudio->md5, sizeof(pAudio->md5));
+}
+
+/* Writes a FLAC frame with a verbatim subframe for each channel. */
+static void test_write_frame(test_stream* pStream, const test_audio* pAudio,
+                             uint32_t frameIndex) {
+  uint64_t firstPCMFrame = (uint64_t)frameIndex * pAudio->blockSize;
+  uint32_t blockSize = pAudio->blockSize;
+  size_t frameStart = pStream->size;
+  uint32_t iChannel;
+  uint32_t iSample;
+  uint16_t crc16;
+
+  if (firstPCMFrame + blockSize > pAudio->totalPCMFrameCount) {
+    blockSize = (uint32_t)(pAudio->totalPCMFrameCount - firstPCMFrame);
+  }
+
+  test_write_bits(pStream, 0xFFF8, 16); /* Sync code and a fixed block size. */
+  test_write_bits(pStream, 7, 4);       /* Block size is stored as 16 bits at the end. */
+  test_write_bits(pStream, 0, 4);       /* Sample rate is taken from STREAMINFO. */
+  test_write_bits(pStream, pAudio->channels - 1, 4); /* Independent channels. */
+  test_write_bits(pStream, 4, 3);                    /* 16 bits per sample. */
+  test_write_bits(pStream, 0, 1);
+
+  /* The frame number, coded like UTF-8. */
+  if (frameIndex < 0x80) {
+    test_write_bits(pStream, frameIndex, 8);
+  } else if (frameIndex < 0x800) {
+    test_write_bits(pStream, 0xC0 | (frameIndex >> 6), 8);
+    test_write_bits(pStream, 0x80 | (frameIndex & 0x3F), 8);
+  } else {
+    test_write_bits(pStream, 0xE0 | (frameIndex >> 12), 8);
+    test_write_bits(pStream, 0x80 | ((frameIndex >> 6) & 0x3F), 8);
+    test_write_bits(pStream, 0x80 | (frameIndex & 0x3F), 8);
+  }
+
+  test_write_bits(pStream, blockSize - 1, 16);
+  test_write_byte(pStream, test_crc8(pStream->pData + frameStart, pStream->size - frameStart));
+
+  for (iChannel = 0; iChannel < pAudio->channels; iChannel += 1) {
+    test_write_bits(pStream, 0x02, 8); /* Verbatim, no wasted bits. */
+    for (iSample = 0; iSample < blockSize; iSample += 1) {
+      size_t index = (size_t)(firstPCMFrame + iSample) * pAudio->channels + iChannel;
+      test_write_bits(pStream, (uint16_t)pAudio->pSamples[index], 16);
+    }
+  }
+
+  crc16 = test_crc16(pStream->pData + frameStart, pStream->size - frameStart);
+  test_write_bits(pStream, crc16, 16);
+}
+
+static uint32_t test_get_frame_count(const test_audio* pAudio) {
+  return (uint32_t)((pAudio->totalPCMFrameCount + pAudio->blockSize - 1) / pAudio->blockSize);
+}
+
+static void test_write_native_header(test_stream* pStream, const test_audio* pAudio,
+                                    bool isLastBlock) {
+  test_write_bytes(pStream, "fLaC", 4);
+  test_write_block_header(pStream, isLastBlock, DRFLAC_METADATA_BLOCK_TYPE_STREAMINFO, 34);
+  test_write_streaminfo(pStream, pAudio);
+}
+
+static void test_write_frames(test_stream* pStream, const test_audio* pAudio) {
+  uint32_t frameCount = test_get_frame_count(pAudio);
+  uint32_t iFrame;
+
+  for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+    test_write_frame(pStream, pAudio, iFrame);
+  }
+}
+
+/* Writes a native FLAC stream with no metadata other than STREAMINFO. */
+static void test_encode_native(test_stream* pStream, const test_audio* pAudio) {
+  test_write_native_header(pStream, pAudio, DRFLAC_TRUE);
+  test_write_frames(pStream, pAudio);
+}
+
+/* An APPLICATION block larger than a decoder for the test audio. */
+#define TEST_APPLICATION_ID 0x74657374
+#define TEST_APPLICATION_DATA_SIZE 30000
+
+static uint8_t test_get_application_byte(uint32_t index) { return (uint8_t)(index * 5 + 1); }
+
+static void test_write_application(test_stream* pStream, bool isLastBlock) {
+  uint32_t i;
+
+  test_write_block_header(pStream, isLastBlock, DRFLAC_METADATA_BLOCK_TYPE_APPLICATION,
+                          4 + TEST_APPLICATION_DATA_SIZE);
+  test_write_u32_be(pStream, TEST_APPLICATION_ID);
+  for (i = 0; i < TEST_APPLICATION_DATA_SIZE; i += 1) {
+    test_write_byte(pStream, test_get_application_byte(i));
+  }
+}
+
+/* A PICTURE block, also larger than a decoder for the test audio. */
+#define TEST_PICTURE_MIME "image/png"
+#define TEST_PICTURE_DESCRIPTION "cover"
+#define TEST_PICTURE_DATA_SIZE 30000
+
+static uint8_t test_get_picture_byte(uint32_t index) { return (uint8_t)(index * 7 + 3); }
+
+static void test_write_picture(test_stream* pStream, bool isLastBlock) {
+  uint32_t i;
+
+  test_write_block_header(pStream, isLastBlock, DRFLAC_METADATA_BLOCK_TYPE_PICTURE,
+                          32 + (uint32_t)strlen(TEST_PICTURE_MIME) +
+                              (uint32_t)strlen(TEST_PICTURE_DESCRIPTION) +
+                              TEST_PICTURE_DATA_SIZE);
+  test_write_u32_be(pStream, 3); /* Front cover. */
+  test_write_u32_be(pStream, (uint32_t)strlen(TEST_PICTURE_MIME));
+  test_write_bytes(pStream, TEST_PICTURE_MIME, strlen(TEST_PICTURE_MIME));
+  test_write_u32_be(pStream, (uint32_t)strlen(TEST_PICTURE_DESCRIPTION));
+  test_write_bytes(pStream, TEST_PICTURE_DESCRIPTION, strlen(TEST_PICTURE_DESCRIPTION));
+  test_write_u32_be(pStream, 64);
+  test_write_u32_be(pStream, 48);
+  test_write_u32_be(pStream, 24);
+  test_write_u32_be(pStream, 0);
+  test_write_u32_be(pStream, TEST_PICTURE_DATA_SIZE);
+  for (i = 0; i < TEST_PICTURE_DATA_SIZE; i += 1) {
+    test_write_byte(pStream, test_get_picture_byte(i));
+  }
+}
+
+static bool test_picture_data_equal(const uint8_t* pData) {
+  uint32_t i;
+
+  for (i = 0; i < TEST_PICTURE_DATA_SIZE; i += 1) {
+    if (pData[i] != test_get_picture_byte(i)) { return DRFLAC_FALSE; }
+  }
+  return DRFLAC_TRUE;
+}
+
+/* Ogg encoding */
+
+#ifndef DR_FLAC_NO_OGG
+static void test_write_u32_le(test_stream* pStream, uint32_t value) {
+  test_write_byte(pStream, (uint8_t)(value >> 0));
+  test_write_byte(pStream, (uint8_t)(value >> 8));
+  test_write_byte(pStream, (uint8_t)(value >> 16));
+  test_write_byte(pStream, (uint8_t)(value >> 24));
+}
+
+static uint32_t test_crc32_ogg(const uint8_t* pData, size_t size) {
+  uint32_t crc = 0;
+  size_t i;
+  int iBit;
+  for (i = 0; i < size; i += 1) {
+    crc ^= (uint32_t)pData[i] << 24;
+    for (iBit = 0; iBit < 8; iBit += 1) {
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+/* Writes a page holding a single packet. */
+static void test_write_ogg_page(test_stream* pStream, uint8_t headerType, uint64_t granulePos,
+                                uint32_t serialNumber, uint32_t sequenceNumber,
+                                const uint8_t* pPacket, size_t packetSize) {
+  size_t pageStart = pStream->size;
+  size_t segmentCount = packetSize / 255 + 1;
+  uint32_t crc32;
+  size_t i;
+
+  test_write_bytes(pStream, "OggS", 4);
+  test_write_byte(pStream, 0);
+  test_write_byte(pStream, headerType);
+  test_write_u32_le(pStream, (uint32_t)granulePos);
+  test_write_u32_le(pStream, (uint32_t)(granulePos >> 32));
+  test_write_u32_le(pStream, serialNumber);
+  test_write_u32_le(pStream, sequenceNumber);
+  test_write_u32_le(pStream, 0); /* The checksum, filled in below. */
+  test_write_byte(pStream, (uint8_t)segmentCount);
+  for (i = 0; i + 1 < segmentCount; i += 1) { test_write_byte(pStream, 255); }
+  test_write_byte(pStream, (uint8_t)(packetSize % 255));
+  test_write_bytes(pStream, pPacket, packetSize);
+
+  crc32 = test_crc32_ogg(pStream->pData + pageStart, pStream->size - pageStart);
+  for (i = 0; i < 4; i += 1) { pStream->pData[pageStart + 22 + i] = (uint8_t)(crc32 >> (i * 8)); }
+}
+
+/* Appends one link of an Ogg FLAC stream, with one FLAC frame on each page. */
+static void test_encode_ogg_link(test_stream* pStream, const test_audio* pAudio,
+                                 uint32_t serialNumber) {
+  uint32_t frameCount = test_get_frame_count(pAudio);
+  uint32_t sequenceNumber = 0;
+  test_stream packet;
+  uint32_t iFrame;
+
+  memset(&packet, 0, sizeof(packet));
+
+  /* The mapping header and STREAMINFO. */
+  test_write_byte(&packet, 0x7F);
+  test_write_bytes(&packet, "FLAC", 4);
+  test_write_byte(&packet, 1);
+  test_write_byte(&packet, 0);
+  test_write_bits(&packet, 1, 16); /* One more header packet follows. */
+  test_write_bytes(&packet, "fLaC", 4);
+  test_write_block_header(&packet, DRFLAC_FALSE, DRFLAC_METADATA_BLOCK_TYPE_STREAMINFO, 34);
+  test_write_streaminfo(&packet, pAudio);
+  test_write_ogg_page(pStream, 0x02, 0, serialNumber, sequenceNumber++, packet.pData,
+                      packet.size);
+
+  /* An empty VORBIS_COMMENT block. */
+  packet.size = 0;
+  test_write_block_header(&packet, DRFLAC_TRUE, DRFLAC_METADATA_BLOCK_TYPE_VORBIS_COMMENT, 8);
+  test_write_u32_le(&packet, 0);
+  test_write_u32_le(&packet, 0);
+  test_write_ogg_page(pStream, 0x00, 0, serialNumber, sequenceNumber++, packet.pData,
+                      packet.size);
+
+  for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+    uint64_t granulePos = (uint64_t)(iFrame + 1) * pAudio->blockSize;
+    if (granulePos > pAudio->totalPCMFrameCount) { granulePos = pAudio->totalPCMFrameCount; }
+
+    packet.size = 0;
+    test_write_frame(&packet, pAudio, iFrame);
+    test_write_ogg_page(pStream, (iFrame + 1 == frameCount) ? 0x04 : 0x00, granulePos,
+                        serialNumber, sequenceNumber++, packet.pData, packet.size);
+  }
+
+  test_stream_uninit(&packet);
+}
+#endif
+
+/* Reading through callbacks */
+
+typedef struct {
+  const uint8_t* pData;
+  size_t size;
+  size_t cursor;
+} test_reader;
+
+static size_t test_on_read(void* pUserData, void* pBufferOut, size_t bytesToRead) {
+  test_reader* pReader = (test_reader*)pUserData;
+  size_t bytesRemaining = pReader->size - pReader->cursor;
+
+  if (bytesToRead > bytesRemaining) { bytesToRead = bytesRemaining; }
+  memcpy(pBufferOut, pReader->pData + pReader->cursor, bytesToRead);
+  pReader->cursor += bytesToRead;
+  return bytesToRead;
+}
+
+static bool test_on_seek(void* pUserData, int offset, drflac_seek_origin origin) {
+  test_reader* pReader = (test_reader*)pUserData;
+  long long newCursor = (long long)offset;
+
+  if (origin == drflac_seek_origin_current) { newCursor += (long long)pReader->cursor; }
+  if (newCursor < 0 || newCursor > (long long)pReader->size) { return DRFLAC_FALSE; }
+
+  pReader->cursor = (size_t)newCursor;
+  return DRFLAC_TRUE;
+}
+
+/* Reads the rest of the stream and checks it against the expected audio. */
+static void test_read_and_compare(drflac* pFlac, const test_audio* pAudio,
+                                  uint64_t firstPCMFrame) {
+  uint64_t pcmFrameCount = pAudio->totalPCMFrameCount - firstPCMFrame;
+  int32_t* pSamples = (int32_t*)malloc((size_t)pcmFrameCount * pAudio->channels * 4 + 4);
+
+  TEST_CHECK(pSamples != NULL);
+  if (pSamples == NULL) { return; }
+
+  TEST_CHECK(drflac_read_pcm_frames_s32(pFlac, pcmFrameCount + 1, pSamples) == pcmFrameCount);
+  TEST_CHECK(test_audio_equal(pAudio, firstPCMFrame, pSamples, pcmFrameCount));
+  free(pSamples);
+}
+
+/* Tests */
+
+/* The same user data is passed to every callback, so the reader comes first. */
+typedef struct {
+  test_reader reader;
+  uint32_t applicationCount;
+  bool isApplicationCorrect;
+} test_application_result;
+
+static void test_on_meta_application(void* pUserData, drflac_metadata* pMetadata) {
+  test_application_result* pResult = (test_application_result*)pUserData;
+  const uint8_t* pData = (const uint8_t*)pMetadata->data.application.pData;
+  uint32_t i;
+
+  if (pMetadata->type != DRFLAC_METADATA_BLOCK_TYPE_APPLICATION) { return; }
+
+  pResult->applicationCount += 1;
+  pResult->isApplicationCorrect = pMetadata->data.application.id == TEST_APPLICATION_ID &&
+                                  pMetadata->data.application.dataSize ==
+                                      TEST_APPLICATION_DATA_SIZE;
+  for (i = 0; pResult->isApplicationCorrect && i < TEST_APPLICATION_DATA_SIZE; i += 1) {
+    if (pData[i] != test_get_application_byte(i)) { pResult->isApplicationCorrect = DRFLAC_FALSE; }
+  }
+}
+
+static void* test_align_16(void* p) { return (void*)(((uintptr_t)p + 15) & ~(uintptr_t)15); }
+
+static void test_preallocated(void) {
+  test_audio audio;
+  test_stream stream;
+  test_stream bigStream;
+  test_application_result result;
+  size_t decoderSize;
+  size_t memorySize;
+  void* pAllocation;
+  void* pMemory;
+  drflac* pFlac;
+  uint32_t i;
+
+  test_audio_init(&audio, 44100, 2, 1024, 10000, 1);
+  memset(&stream, 0, sizeof(stream));
+  test_write_native_header(&stream, &audio, DRFLAC_FALSE);
+  test_write_application(&stream, DRFLAC_TRUE);
+  test_write_frames(&stream, &audio);
+
+  /* The same audio with a larger block of metadata in front of it. */
+  memset(&bigStream, 0, sizeof(bigStream));
+  test_write_native_header(&bigStream, &audio, DRFLAC_FALSE);
+  test_write_application(&bigStream, DRFLAC_FALSE);
+  test_write_application(&bigStream, DRFLAC_FALSE);
+  test_write_block_header(&bigStream, DRFLAC_TRUE, 100, 2 * TEST_APPLICATION_DATA_SIZE);
+  for (i = 0; i < 2 * TEST_APPLICATION_DATA_SIZE; i += 1) { test_write_byte(&bigStream, 0); }
+  test_write_frames(&bigStream, &audio);
+
+  /* Only a metadata callback needs room for the APPLICATION block. */
+  memset(&result, 0, sizeof(result));
+  result.reader.pData = stream.pData;
+  result.reader.size = stream.size;
+  TEST_CHECK(drflac_get_preallocated_size(test_on_read, test_on_seek, NULL, &result, &decoderSize));
+  TEST_CHECK(result.reader.cursor == 0);
+  TEST_CHECK(drflac_get_preallocated_size(test_on_read, test_on_seek, test_on_meta_application,
+                                          &result, &memorySize));
+  TEST_CHECK(decoderSize < 4 + TEST_APPLICATION_DATA_SIZE);
+  TEST_CHECK(memorySize == 4 + TEST_APPLICATION_DATA_SIZE);
+  TEST_CHECK(result.applicationCount == 0);
+
+  pAllocation = malloc(memorySize + 16);
+  TEST_CHECK(pAllocation != NULL);
+  if (pAllocation == NULL) { return; }
+  pMemory = test_align_16(pAllocation);
+
+  /* Too small for the metadata, which fails without touching anything outside the memory. */
+  pFlac = drflac_open_preallocated(test_on_read, test_on_seek, test_on_meta_application, &result,
+                                   pMemory, decoderSize);
+  TEST_CHECK(pFlac == NULL);
+
+  result.reader.cursor = 0;
+  pFlac = drflac_open_preallocated(test_on_read, test_on_seek, NULL, &result, pMemory,
+                                   decoderSize);
+  TEST_CHECK(pFlac == pMemory);
+  if (pFlac != NULL) {
+    test_read_and_compare(pFlac, &audio, 0);
+
+    /* Nothing can be allocated. */
+    TEST_CHECK(!drflac_build_seek_index(pFlac));
+    drflac_close(pFlac);
+  }
+
+  result.reader.cursor = 0;
+  pFlac = drflac_open_preallocated(test_on_read, test_on_seek, test_on_meta_application, &result,
+                                   pMemory, memorySize);
+  TEST_CHECK(pFlac == pMemory);
+  TEST_CHECK(result.applicationCount == 1);
+  TEST_CHECK(result.isApplicationCorrect);
+  if (pFlac != NULL) {
+    test_read_and_compare(pFlac, &audio, 0);
+
+    /* Reopening loads the metadata into the same memory again. */
+    memset(&result, 0, sizeof(result));
+    result.reader.pData = stream.pData;
+    result.reader.size = stream.size;
+    pFlac = drflac_reopen(pFlac, test_on_read, test_on_seek, test_on_meta_application, &result);
+    TEST_CHECK(pFlac == pMemory);
+    TEST_CHECK(result.applicationCount == 1);
+    TEST_CHECK(result.isApplicationCorrect);
+  }
+  if (pFlac != NULL) {
+    test_read_and_compare(pFlac, &audio, 0);
+
+    result.applicationCount = 0;
+    pFlac = drflac_reopen_memory(pFlac, stream.pData, stream.size, test_on_meta_application,
+                                 &result);
+    TEST_CHECK(pFlac == pMemory);
+    TEST_CHECK(result.applicationCount == 1);
+    TEST_CHECK(result.isApplicationCorrect);
+  }
+  if (pFlac != NULL) {
+    test_read_and_compare(pFlac, &audio, 0);
+
+    /* A stream with a block that doesn't fit fails, leaving nothing to close. */
+    pFlac = drflac_reopen_memory(pFlac, bigStream.pData, bigStream.size,
+                                 test_on_meta_application, &result);
+    TEST_CHECK(pFlac == NULL);
+  }
+
+  free(pAllocation);
+  test_stream_uninit(&stream);
+  test_stream_uninit(&bigStream);
+  test_audio_uninit(&audio);
+}
+
+/* Runs the jobs last to first, which no job may depend on. */
+static void test_run_jobs_backwards(void* pUserData, drflac_job_proc onJob, void* pJobUserData,
+                                    uint32_t jobCount) {
+  uint32_t* pRunCount = (uint32_t*)pUserData;
+
+  while (jobCount > 0) {
+    jobCount -= 1;
+    onJob(pJobUserData, jobCount);
+    *pRunCount += 1;
+  }
+}
+
+static void test_decode_parallel(void) {
+  test_audio audio;
+  test_stream stream;
+  unsigned int channels = 0;
+  unsigned int sampleRate = 0;
+  uint64_t pcmFrameCount = 0;
+  uint64_t serialPCMFrameCount = 0;
+  uint32_t runCount = 0;
+  int32_t* pSamplesS32;
+  int16_t* pSamplesS16;
+  float* pSamplesF32;
+  size_t i;
+
+  test_audio_init(&audio, 44100, 2, 1024, 20000, 2);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_native(&stream, &audio);
+
+  pSamplesS32 = drflac_decode_parallel_s32(stream.pData, stream.size, 4, test_run_jobs_backwards,
+                                           &runCount, &channels, &sampleRate, &pcmFrameCount,
+                                           NULL);
+  TEST_CHECK(pSamplesS32 != NULL);
+  TEST_CHECK(runCount == 4);
+  TEST_CHECK(channels == 2 && sampleRate == 44100);
+  TEST_CHECK(pcmFrameCount == audio.totalPCMFrameCount);
+  if (pSamplesS32 != NULL) {
+    TEST_CHECK(test_audio_equal(&audio, 0, pSamplesS32, pcmFrameCount));
+    drflac_free(pSamplesS32, NULL);
+  }
+
+  /* More jobs than frames, run on the calling thread. */
+  pcmFrameCount = 0;
+  pSamplesS16 = drflac_decode_parallel_s16(stream.pData, stream.size, 64, NULL, NULL, NULL, NULL,
+                                           &pcmFrameCount, NULL);
+  TEST_CHECK(pSamplesS16 != NULL);
+  TEST_CHECK(pcmFrameCount == audio.totalPCMFrameCount);
+  if (pSamplesS16 != NULL) {
+    TEST_CHECK(memcmp(pSamplesS16, audio.pSamples, (size_t)pcmFrameCount * 2 * 2) == 0);
+    drflac_free(pSamplesS16, NULL);
+  }
+
+  pcmFrameCount = 0;
+  pSamplesF32 = drflac_decode_parallel_f32(stream.pData, stream.size, 3, NULL, NULL, NULL, NULL,
+                                           &pcmFrameCount, NULL);
+  TEST_CHECK(pSamplesF32 != NULL);
+  TEST_CHECK(pcmFrameCount == audio.totalPCMFrameCount);
+  if (pSamplesF32 != NULL) {
+    for (i = 0; i < (size_t)pcmFrameCount * 2; i += 1) {
+      if (pSamplesF32[i] != audio.pSamples[i] / 32768.0f) { break; }
+    }
+    TEST_CHECK(i == (size_t)pcmFrameCount * 2);
+    drflac_free(pSamplesF32, NULL);
+  }
+
+  /* A stream cut short of STREAMINFO's total gives what the serial path gives. */
+  pSamplesS32 = drflac_open_memory_and_read_pcm_frames_s32(
+      stream.pData, stream.size * 2 / 3, NULL, NULL, &serialPCMFrameCount, NULL);
+  TEST_CHECK(pSamplesS32 != NULL);
+  TEST_CHECK(serialPCMFrameCount > 0 && serialPCMFrameCount < audio.totalPCMFrameCount);
+  drflac_free(pSamplesS32, NULL);
+
+  pcmFrameCount = 0;
+  pSamplesS32 = drflac_decode_parallel_s32(stream.pData, stream.size * 2 / 3, 4, NULL, NULL, NULL,
+                                           NULL, &pcmFrameCount, NULL);
+  TEST_CHECK(pSamplesS32 != NULL);
+  TEST_CHECK(pcmFrameCount == serialPCMFrameCount);
+  if (pSamplesS32 != NULL) {
+    TEST_CHECK(test_audio_equal(&audio, 0, pSamplesS32, pcmFrameCount));
+    drflac_free(pSamplesS32, NULL);
+  }
+
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+
+#ifndef DR_FLAC_NO_STDIO
+#define TEST_FILE_NAME "dr_flac_test.flac"
+
+static bool test_write_file(const char* pFileName, const test_stream* pStream) {
+  FILE* pFile = fopen(pFileName, "wb");
+  bool result;
+
+  if (pFile == NULL) { return DRFLAC_FALSE; }
+  result = fwrite(pStream->pData, 1, pStream->size, pFile) == pStream->size;
+  return fclose(pFile) == 0 && result;
+}
+
+static void test_open_file_mmap(void) {
+  test_audio audio;
+  test_stream stream;
+  test_application_result result;
+  drflac* pFlac;
+
+  test_audio_init(&audio, 48000, 2, 1024, 12000, 3);
+  memset(&stream, 0, sizeof(stream));
+  test_write_native_header(&stream, &audio, DRFLAC_FALSE);
+  test_write_application(&stream, DRFLAC_TRUE);
+  test_write_frames(&stream, &audio);
+  TEST_CHECK(test_write_file(TEST_FILE_NAME, &stream));
+
+  pFlac = drflac_open_file_mmap(TEST_FILE_NAME, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL) {
+    test_read_and_compare(pFlac, &audio, 0);
+    TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 5000));
+    test_read_and_compare(pFlac, &audio, 5000);
+    drflac_close(pFlac);
+  }
+
+  memset(&result, 0, sizeof(result));
+  pFlac = drflac_open_file_mmap_with_metadata(TEST_FILE_NAME, test_on_meta_application, &result,
+                                              NULL);
+  TEST_CHECK(pFlac != NULL);
+  TEST_CHECK(result.applicationCount == 1);
+  TEST_CHECK(result.isApplicationCorrect);
+  if (pFlac != NULL) {
+    test_read_and_compare(pFlac, &audio, 0);
+    drflac_close(pFlac);
+  }
+
+  TEST_CHECK(remove(TEST_FILE_NAME) == 0);
+  TEST_CHECK(drflac_open_file_mmap(TEST_FILE_NAME, NULL) == NULL);
+
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+#endif
+
+static void test_read_planar(void) {
+  test_audio audio;
+  test_stream stream;
+  drflac* pFlac;
+  int32_t samplesS32[2][1500];
+  int16_t samplesS16[2][1500];
+  float samplesF32[2][1500];
+  int32_t* ppSamplesS32[2];
+  int16_t* ppSamplesS16[2];
+  float* ppSamplesF32[2];
+  bool isEqual = DRFLAC_TRUE;
+  uint32_t iChannel;
+  uint32_t i;
+
+  test_audio_init(&audio, 44100, 2, 1024, 5000, 4);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_native(&stream, &audio);
+  for (iChannel = 0; iChannel < 2; iChannel += 1) {
+    ppSamplesS32[iChannel] = samplesS32[iChannel];
+    ppSamplesS16[iChannel] = samplesS16[iChannel];
+    ppSamplesF32[iChannel] = samplesF32[iChannel];
+  }
+
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac == NULL) { return; }
+
+  /* Each read crosses a FLAC frame boundary. */
+  TEST_CHECK(drflac_read_pcm_frames_s32_planar(pFlac, 1500, ppSamplesS32) == 1500);
+  TEST_CHECK(drflac_read_pcm_frames_s16_planar(pFlac, 1500, ppSamplesS16) == 1500);
+  TEST_CHECK(drflac_read_pcm_frames_s32_planar(pFlac, 500, NULL) == 500);
+  TEST_CHECK(drflac_read_pcm_frames_f32_planar(pFlac, 1500, ppSamplesF32) == 1500);
+  for (iChannel = 0; iChannel < 2; iChannel += 1) {
+    for (i = 0; i < 1500; i += 1) {
+      int16_t sample = audio.pSamples[i * 2 + iChannel];
+      if (samplesS32[iChannel][i] != sample * 65536) { isEqual = DRFLAC_FALSE; }
+
+      sample = audio.pSamples[(1500 + i) * 2 + iChannel];
+      if (samplesS16[iChannel][i] != sample) { isEqual = DRFLAC_FALSE; }
+
+      sample = audio.pSamples[(3500 + i) * 2 + iChannel];
+      if (samplesF32[iChannel][i] != sample / 32768.0f) { isEqual = DRFLAC_FALSE; }
+    }
+  }
+  TEST_CHECK(isEqual);
+
+  /* The end of the stream. */
+  TEST_CHECK(drflac_read_pcm_frames_s32_planar(pFlac, 1500, ppSamplesS32) == 0);
+  drflac_close(pFlac);
+
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+
+static void test_read_next_flac_frame(void) {
+  test_audio audio;
+  test_stream stream;
+  drflac* pFlac;
+  drflac_frame_view view;
+  int32_t samples[100 * 2];
+  uint64_t nextPCMFrame = 100;
+  bool isEqual = DRFLAC_TRUE;
+  uint32_t iChannel;
+  uint32_t i;
+
+  test_audio_init(&audio, 44100, 2, 1024, 5000, 5);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_native(&stream, &audio);
+
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac == NULL) { return; }
+
+  /* Only the rest of a partially read frame is returned. */
+  TEST_CHECK(drflac_read_pcm_frames_s32(pFlac, 100, samples) == 100);
+  while (drflac_read_next_flac_frame(pFlac, &view)) {
+    TEST_CHECK(view.firstPCMFrame == nextPCMFrame);
+    TEST_CHECK(view.pcmFrameCount == 1024 - nextPCMFrame % 1024 ||
+               view.firstPCMFrame + view.pcmFrameCount == audio.totalPCMFrameCount);
+    TEST_CHECK(view.channels == 2);
+    for (iChannel = 0; iChannel < 2; iChannel += 1) {
+      for (i = 0; i < view.pcmFrameCount; i += 1) {
+        int16_t sample = audio.pSamples[(view.firstPCMFrame + i) * 2 + iChannel];
+        if (view.ppSamples[iChannel][i] != sample * 65536) { isEqual = DRFLAC_FALSE; }
+      }
+    }
+    nextPCMFrame = view.firstPCMFrame + view.pcmFrameCount;
+  }
+  TEST_CHECK(isEqual);
+  TEST_CHECK(nextPCMFrame == audio.totalPCMFrameCount);
+
+  /* Seeking works the same as with the other reading APIs. */
+  TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 2048));
+  TEST_CHECK(drflac_read_next_flac_frame(pFlac, &view));
+  TEST_CHECK(view.firstPCMFrame == 2048 && view.pcmFrameCount == 1024);
+  drflac_close(pFlac);
+
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+
+/* Seeks to each target and checks the audio that follows. */
+static void test_seek_and_compare(drflac* pFlac, const test_audio* pAudio,
+                                  const uint64_t* pTargets, size_t targetCount) {
+  size_t iTarget;
+
+  for (iTarget = 0; iTarget < targetCount; iTarget += 1) {
+    int32_t samples[64 * 8];
+    uint64_t pcmFrameCount = pAudio->totalPCMFrameCount - pTargets[iTarget];
+    if (pcmFrameCount > 64) { pcmFrameCount = 64; }
+
+    TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, pTargets[iTarget]));
+    TEST_CHECK(drflac_read_pcm_frames_s32(pFlac, pcmFrameCount, samples) == pcmFrameCount);
+    TEST_CHECK(test_audio_equal(pAudio, pTargets[iTarget], samples, pcmFrameCount));
+  }
+}
+
+static void test_seek_index(void) {
+  static const uint64_t targets[] = {0, 1, 1023, 1024, 5000, 12345, 19999, 8000, 3};
+  test_audio audio;
+  test_stream stream;
+  drflac* pFlac;
+  void* pIndex = NULL;
+  size_t indexSize = 0;
+
+  test_audio_init(&audio, 44100, 2, 1024, 20000, 6);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_native(&stream, &audio);
+
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL) {
+    TEST_CHECK(drflac_save_seek_index(pFlac, NULL, 0) == 0);
+    TEST_CHECK(drflac_build_seek_index(pFlac));
+    test_seek_and_compare(pFlac, &audio, targets, sizeof(targets) / sizeof(targets[0]));
+
+    indexSize = drflac_save_seek_index(pFlac, NULL, 0);
+    pIndex = malloc(indexSize);
+    TEST_CHECK(indexSize > 0 && pIndex != NULL);
+    if (pIndex != NULL) {
+      TEST_CHECK(drflac_save_seek_index(pFlac, pIndex, indexSize - 1) == 0);
+      TEST_CHECK(drflac_save_seek_index(pFlac, pIndex, indexSize) == indexSize);
+    }
+    drflac_close(pFlac);
+  }
+
+  /* A saved index is used by a new decoder for the same stream. */
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL && pIndex != NULL) {
+    TEST_CHECK(!drflac_load_seek_index(pFlac, pIndex, indexSize - 1));
+    TEST_CHECK(drflac_load_seek_index(pFlac, pIndex, indexSize));
+    pFlac->_noBinarySearchSeek = DRFLAC_TRUE;
+    pFlac->_noBruteForceSeek = DRFLAC_TRUE;
+    test_seek_and_compare(pFlac, &audio, targets, sizeof(targets) / sizeof(targets[0]));
+  }
+  drflac_close(pFlac);
+
+  free(pIndex);
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+
+static void test_seek_index_fallback(bool noBinarySearchSeek) {
+  static const uint64_t targets[] = {0, 1, 999, 1000, 1024, 4095, 5000, 12345, 19999, 8000, 3};
+  test_audio audioA;
+  test_audio audioB;
+  test_stream streamA;
+  test_stream streamB;
+  drflac* pFlac;
+  void* pIndex = NULL;
+  size_t indexSize = 0;
+
+  /*
+  Same metadata and length, so an index of one passes the checks in
+  drflac_load_seek_index() for the other, but the frames are in different places.
+  */
+  test_audio_init(&audioA, 44100, 2, 1024, 20000, 3);
+  test_audio_init(&audioB, 44100, 2, 1000, 20000, 4);
+  memset(&streamA, 0, sizeof(streamA));
+  memset(&streamB, 0, sizeof(streamB));
+  test_encode_native(&streamA, &audioA);
+  test_encode_native(&streamB, &audioB);
+
+  pFlac = drflac_open_memory(streamA.pData, streamA.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL) {
+    TEST_CHECK(drflac_build_seek_index(pFlac));
+    indexSize = drflac_save_seek_index(pFlac, NULL, 0);
+    pIndex = malloc(indexSize);
+    TEST_CHECK(indexSize > 0 && pIndex != NULL);
+    if (pIndex != NULL) {
+      TEST_CHECK(drflac_save_seek_index(pFlac, pIndex, indexSize) == indexSize);
+    }
+    drflac_close(pFlac);
+  }
+
+  pFlac = drflac_open_memory(streamB.pData, streamB.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL && pIndex != NULL) {
+    TEST_CHECK(drflac_load_seek_index(pFlac, pIndex, indexSize));
+    pFlac->_noBinarySearchSeek = noBinarySearchSeek; /* Fall back to a brute force seek. */
+
+    /* Every seek lands on the wrong frame, if any, and needs to fall back. */
+    test_seek_and_compare(pFlac, &audioB, targets, sizeof(targets) / sizeof(targets[0]));
+
+    TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 0));
+    test_read_and_compare(pFlac, &audioB, 0);
+  }
+  drflac_close(pFlac);
+
+  free(pIndex);
+  test_stream_uninit(&streamA);
+  test_stream_uninit(&streamB);
+  test_audio_uninit(&audioA);
+  test_audio_uninit(&audioB);
+}
+
+/* The offset of the MD5 in a stream written by test_write_native_header(). */
+#define TEST_MD5_OFFSET (4 + 4 + 18)
+
+static drflac_md5_result test_decode_and_verify(const test_stream* pStream,
+                                                uint64_t firstPCMFrame) {
+  drflac_md5_result result;
+  drflac* pFlac;
+
+  pFlac = drflac_open_memory(pStream->pData, pStream->size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac == NULL) { return drflac_md5_incomplete; }
+
+  if (drflac_enable_md5_verification(pFlac)) {
+    TEST_CHECK(drflac_get_md5_result(pFlac) == drflac_md5_incomplete);
+    TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, firstPCMFrame));
+    while (drflac_read_pcm_frames_s16(pFlac, 700, NULL) > 0) {}
+  }
+
+  result = drflac_get_md5_result(pFlac);
+  drflac_close(pFlac);
+  return result;
+}
+
+static void test_md5_verification(void) {
+  test_audio audio;
+  test_stream stream;
+  drflac* pFlac;
+
+  test_audio_init(&audio, 44100, 2, 1024, 10000, 7);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_native(&stream, &audio);
+
+  TEST_CHECK(test_decode_and_verify(&stream, 0) == drflac_md5_match);
+  TEST_CHECK(test_decode_and_verify(&stream, 3000) == drflac_md5_incomplete);
+
+  /* Filling in skipped frames completes the hash. */
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL) {
+    TEST_CHECK(drflac_enable_md5_verification(pFlac));
+    TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 3000));
+    test_read_and_compare(pFlac, &audio, 3000);
+    TEST_CHECK(drflac_get_md5_result(pFlac) == drflac_md5_incomplete);
+    TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 0));
+    test_read_and_compare(pFlac, &audio, 0);
+    TEST_CHECK(drflac_get_md5_result(pFlac) == drflac_md5_match);
+    drflac_close(pFlac);
+  }
+
+  stream.pData[TEST_MD5_OFFSET + 5] ^= 0x01;
+  TEST_CHECK(test_decode_and_verify(&stream, 0) == drflac_md5_mismatch);
+
+  /* An MD5 of zero means the encoder didn't store one. */
+  memset(stream.pData + TEST_MD5_OFFSET, 0, 16);
+  TEST_CHECK(test_decode_and_verify(&stream, 0) == drflac_md5_unavailable);
+
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+
+/* Records the size of each read once the decoder is open. */
+typedef struct {
+  test_reader reader;
+  size_t readCount;
+  size_t largestRead;
+  size_t bytesRead;
+} test_counting_reader;
+
+static size_t test_on_read_counting(void* pUserData, void* pBufferOut, size_t bytesToRead) {
+  test_counting_reader* pReader = (test_counting_reader*)pUserData;
+
+  pReader->readCount += 1;
+  if (pReader->largestRead < bytesToRead) { pReader->largestRead = bytesToRead; }
+  bytesToRead = test_on_read(pUserData, pBufferOut, bytesToRead);
+  pReader->bytesRead += bytesToRead;
+  return bytesToRead;
+}
+
+static void test_open_with_buffer_size(void) {
+  static const size_t bufferSizes[] = {0, 20, 1000, 1024 * 1024};
+  test_audio audio;
+  test_stream stream;
+  test_counting_reader reader;
+  drflac* pFlac;
+  size_t iBufferSize;
+
+  test_audio_init(&audio, 44100, 2, 1024, 10000, 8);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_native(&stream, &audio);
+
+  for (iBufferSize = 0; iBufferSize < sizeof(bufferSizes) / sizeof(bufferSizes[0]);
+       iBufferSize += 1) {
+    size_t bufferSize = bufferSizes[iBufferSize];
+
+    memset(&reader, 0, sizeof(reader));
+    reader.reader.pData = stream.pData;
+    reader.reader.size = stream.size;
+    pFlac = drflac_open_with_buffer_size(test_on_read_counting, test_on_seek, NULL, &reader,
+                                         bufferSize, NULL);
+    TEST_CHECK(pFlac != NULL);
+    if (pFlac == NULL) { continue; }
+
+    reader.readCount = 0;
+    reader.largestRead = 0;
+    test_read_and_compare(pFlac, &audio, 0);
+    if (bufferSize == 0) {
+      TEST_CHECK(reader.largestRead == DR_FLAC_BUFFER_SIZE);
+    } else {
+      TEST_CHECK(reader.largestRead ==
+                 bufferSize / sizeof(drflac_cache_t) * sizeof(drflac_cache_t));
+    }
+
+    /* The whole stream fits in the largest buffer. */
+    if (bufferSize > stream.size) { TEST_CHECK(reader.readCount <= 2); }
+    drflac_close(pFlac);
+  }
+
+  memset(&reader, 0, sizeof(reader));
+  reader.reader.pData = stream.pData;
+  reader.reader.size = stream.size;
+  TEST_CHECK(drflac_open_with_buffer_size(test_on_read_counting, test_on_seek, NULL, &reader,
+                                          (size_t)1024 * 1024 * 1024 + 64, NULL) == NULL);
+
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+
+static void test_reopen(void) {
+  test_audio audioA;
+  test_audio audioB;
+  test_stream streamA;
+  test_stream streamB;
+  drflac* pFlac;
+  drflac* pLargerFlac;
+  test_reader reader;
+  uint8_t garbage[64];
+
+  /* B needs a larger decoder than A. */
+  test_audio_init(&audioA, 22050, 1, 576, 3000, 9);
+  test_audio_init(&audioB, 48000, 2, 4096, 20000, 10);
+  memset(&streamA, 0, sizeof(streamA));
+  memset(&streamB, 0, sizeof(streamB));
+  test_encode_native(&streamA, &audioA);
+  test_encode_native(&streamB, &audioB);
+  memset(garbage, 0x55, sizeof(garbage));
+
+  pFlac = drflac_open_memory(streamA.pData, streamA.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL) {
+    TEST_CHECK(drflac_read_pcm_frames_s32(pFlac, 1000, NULL) == 1000);
+    test_read_and_compare(pFlac, &audioA, 1000);
+    pFlac = drflac_reopen_memory(pFlac, streamB.pData, streamB.size, NULL, NULL);
+    TEST_CHECK(pFlac != NULL);
+  }
+  if (pFlac != NULL) {
+    TEST_CHECK(pFlac->channels == 2 && pFlac->sampleRate == 48000);
+    TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 5000));
+    test_read_and_compare(pFlac, &audioB, 5000);
+
+    /* A smaller stream is decoded in the same allocation. */
+    pLargerFlac = pFlac;
+    pFlac = drflac_reopen_memory(pFlac, streamA.pData, streamA.size, NULL, NULL);
+    TEST_CHECK(pFlac == pLargerFlac);
+  }
+  if (pFlac != NULL) {
+    test_read_and_compare(pFlac, &audioA, 0);
+
+    memset(&reader, 0, sizeof(reader));
+    reader.pData = streamB.pData;
+    reader.size = streamB.size;
+    pFlac = drflac_reopen(pFlac, test_on_read, test_on_seek, NULL, &reader);
+    TEST_CHECK(pFlac != NULL);
+  }
+  if (pFlac != NULL) {
+    test_read_and_compare(pFlac, &audioB, 0);
+
+    /* A failure frees the decoder. */
+    pFlac = drflac_reopen_memory(pFlac, garbage, sizeof(garbage), NULL, NULL);
+    TEST_CHECK(pFlac == NULL);
+  }
+
+#ifndef DR_FLAC_NO_STDIO
+  TEST_CHECK(test_write_file(TEST_FILE_NAME, &streamA));
+  pFlac = drflac_reopen_file(NULL, TEST_FILE_NAME, NULL, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL) {
+    test_read_and_compare(pFlac, &audioA, 0);
+    pFlac = drflac_reopen_file(pFlac, TEST_FILE_NAME, NULL, NULL);
+    TEST_CHECK(pFlac != NULL);
+  }
+  if (pFlac != NULL) {
+    test_read_and_compare(pFlac, &audioA, 0);
+    drflac_close(pFlac);
+  }
+  TEST_CHECK(remove(TEST_FILE_NAME) == 0);
+#endif
+
+  test_stream_uninit(&streamA);
+  test_stream_uninit(&streamB);
+  test_audio_uninit(&audioA);
+  test_audio_uninit(&audioB);
+}
+
+static bool test_streaminfo_equal(const drflac_streaminfo* pStreamInfo, const test_audio* pAudio) {
+  return pStreamInfo->minBlockSizeInPCMFrames == pAudio->blockSize &&
+         pStreamInfo->maxBlockSizeInPCMFrames == pAudio->blockSize &&
+         pStreamInfo->sampleRate == pAudio->sampleRate &&
+         pStreamInfo->channels == pAudio->channels && pStreamInfo->bitsPerSample == 16 &&
+         pStreamInfo->totalPCMFrameCount == pAudio->totalPCMFrameCount &&
+         memcmp(pStreamInfo->md5, pAudio->md5, 16) == 0;
+}
+
+static void test_probe(void) {
+  test_audio audio;
+  test_stream stream;
+  test_application_result result;
+  drflac_streaminfo streamInfo;
+  uint8_t garbage[64];
+
+  test_audio_init(&audio, 96000, 2, 2048, 30000, 11);
+  memset(&stream, 0, sizeof(stream));
+  test_write_native_header(&stream, &audio, DRFLAC_FALSE);
+  test_write_application(&stream, DRFLAC_TRUE);
+  test_write_frames(&stream, &audio);
+  memset(garbage, 0x55, sizeof(garbage));
+
+  /* None of the audio is read. */
+  memset(&result, 0, sizeof(result));
+  result.reader.pData = stream.pData;
+  result.reader.size = stream.size;
+  memset(&streamInfo, 0, sizeof(streamInfo));
+  TEST_CHECK(drflac_probe(test_on_read, test_on_seek, test_on_meta_application, &result,
+                          &streamInfo, NULL));
+  TEST_CHECK(test_streaminfo_equal(&streamInfo, &audio));
+  TEST_CHECK(result.applicationCount == 1);
+  TEST_CHECK(result.isApplicationCorrect);
+  TEST_CHECK(result.reader.cursor <= 4 + 4 + 34 + 4 + 4 + TEST_APPLICATION_DATA_SIZE);
+
+  memset(&result, 0, sizeof(result));
+  memset(&streamInfo, 0, sizeof(streamInfo));
+  TEST_CHECK(drflac_probe_memory(stream.pData, stream.size, test_on_meta_application, &result,
+                                 &streamInfo, NULL));
+  TEST_CHECK(test_streaminfo_equal(&streamInfo, &audio));
+  TEST_CHECK(result.applicationCount == 1);
+  TEST_CHECK(result.isApplicationCorrect);
+
+  TEST_CHECK(!drflac_probe_memory(garbage, sizeof(garbage), NULL, NULL, &streamInfo, NULL));
+
+#ifndef DR_FLAC_NO_STDIO
+  TEST_CHECK(test_write_file(TEST_FILE_NAME, &stream));
+  memset(&streamInfo, 0, sizeof(streamInfo));
+  TEST_CHECK(drflac_probe_file(TEST_FILE_NAME, NULL, NULL, &streamInfo, NULL));
+  TEST_CHECK(test_streaminfo_equal(&streamInfo, &audio));
+  TEST_CHECK(remove(TEST_FILE_NAME) == 0);
+  TEST_CHECK(!drflac_probe_file(TEST_FILE_NAME, NULL, NULL, &streamInfo, NULL));
+#endif
+
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+
+typedef struct {
+  test_reader reader;
+  uint32_t pictureCount;
+  bool isPictureCorrect;
+  bool isPictureDataLoaded;
+  uint64_t pictureDataOffset;
+} test_picture_result;
+
+/* The picture data is checked when it was loaded, and otherwise just located. */
+static void test_on_meta_picture(void* pUserData, drflac_metadata* pMetadata) {
+  test_picture_result* pResult = (test_picture_result*)pUserData;
+
+  if (pMetadata->type != DRFLAC_METADATA_BLOCK_TYPE_PICTURE) { return; }
+
+  pResult->pictureCount += 1;
+  pResult->isPictureCorrect =
+      pMetadata->data.picture.mimeLength == strlen(TEST_PICTURE_MIME) &&
+      memcmp(pMetadata->data.picture.mime, TEST_PICTURE_MIME, strlen(TEST_PICTURE_MIME)) == 0 &&
+      pMetadata->data.picture.descriptionLength == strlen(TEST_PICTURE_DESCRIPTION) &&
+      memcmp(pMetadata->data.picture.description, TEST_PICTURE_DESCRIPTION,
+             strlen(TEST_PICTURE_DESCRIPTION)) == 0 &&
+      pMetadata->data.picture.width == 64 && pMetadata->data.picture.height == 48 &&
+      pMetadata->data.picture.pictureDataSize == TEST_PICTURE_DATA_SIZE;
+  pResult->isPictureDataLoaded = pMetadata->data.picture.pPictureData != NULL;
+  pResult->pictureDataOffset = pMetadata->data.picture.pictureDataOffset;
+
+  if (pResult->isPictureCorrect && pResult->isPictureDataLoaded) {
+    pResult->isPictureCorrect = test_picture_data_equal(pMetadata->data.picture.pPictureData);
+  }
+}
+
+static void test_check_picture_data(drflac* pFlac, const test_picture_result* pResult) {
+  uint8_t* pData = (uint8_t*)malloc(TEST_PICTURE_DATA_SIZE);
+
+  TEST_CHECK(pData != NULL);
+  if (pData == NULL) { return; }
+
+  TEST_CHECK(drflac_read_picture_data(pFlac, pResult->pictureDataOffset, pData,
+                                      TEST_PICTURE_DATA_SIZE) == TEST_PICTURE_DATA_SIZE);
+  TEST_CHECK(test_picture_data_equal(pData));
+  free(pData);
+}
+
+static void test_picture(void) {
+  test_audio audio;
+  test_stream stream;
+  test_picture_result result;
+  drflac_streaminfo streamInfo;
+  size_t memorySize;
+  void* pAllocation;
+  drflac* pFlac;
+
+  test_audio_init(&audio, 44100, 2, 1024, 10000, 12);
+  memset(&stream, 0, sizeof(stream));
+  test_write_native_header(&stream, &audio, DRFLAC_FALSE);
+  test_write_picture(&stream, DRFLAC_TRUE);
+  test_write_frames(&stream, &audio);
+
+  /* The picture data is only loaded when it's below the lazy size. */
+  memset(&result, 0, sizeof(result));
+  pFlac = drflac_open_memory_with_metadata(stream.pData, stream.size, test_on_meta_picture,
+                                           &result, NULL);
+  TEST_CHECK(pFlac != NULL);
+  TEST_CHECK(result.pictureCount == 1);
+  TEST_CHECK(result.isPictureCorrect);
+  TEST_CHECK(result.isPictureDataLoaded == (DR_FLAC_LAZY_PICTURE_SIZE == 0 ||
+                                            TEST_PICTURE_DATA_SIZE < DR_FLAC_LAZY_PICTURE_SIZE));
+  if (pFlac != NULL) {
+    /* Reading the picture data doesn't move the decoder. */
+    TEST_CHECK(drflac_read_pcm_frames_s32(pFlac, 1500, NULL) == 1500);
+    test_check_picture_data(pFlac, &result);
+    test_read_and_compare(pFlac, &audio, 1500);
+    drflac_close(pFlac);
+  }
+
+  /* Probing never loads the picture data. */
+  memset(&result, 0, sizeof(result));
+  TEST_CHECK(drflac_probe_memory(stream.pData, stream.size, test_on_meta_picture, &result,
+                                 &streamInfo, NULL));
+  TEST_CHECK(result.pictureCount == 1);
+  TEST_CHECK(result.isPictureCorrect);
+  TEST_CHECK(!result.isPictureDataLoaded);
+  TEST_CHECK(result.pictureDataOffset + TEST_PICTURE_DATA_SIZE <= stream.size);
+  if (result.pictureDataOffset + TEST_PICTURE_DATA_SIZE <= stream.size) {
+    TEST_CHECK(test_picture_data_equal(stream.pData + result.pictureDataOffset));
+  }
+
+  /* A PICTURE block in caller provided memory. */
+  memset(&result, 0, sizeof(result));
+  result.reader.pData = stream.pData;
+  result.reader.size = stream.size;
+  TEST_CHECK(drflac_get_preallocated_size(test_on_read, test_on_seek, test_on_meta_picture,
+                                          &result, &memorySize));
+  pAllocation = malloc(memorySize);
+  TEST_CHECK(pAllocation != NULL);
+  if (pAllocation != NULL) {
+    result.reader.cursor = 0;
+    pFlac = drflac_open_preallocated(test_on_read, test_on_seek, test_on_meta_picture, &result,
+                                     pAllocation, memorySize);
+    TEST_CHECK(pFlac == pAllocation);
+    TEST_CHECK(result.pictureCount == 1);
+    TEST_CHECK(result.isPictureCorrect);
+    if (pFlac != NULL) {
+      test_check_picture_data(pFlac, &result);
+      test_read_and_compare(pFlac, &audio, 0);
+      drflac_close(pFlac);
+    }
+    free(pAllocation);
+  }
+
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+
+#ifndef DR_FLAC_NO_OGG
+static void test_ogg_seek_index(void) {
+  static const uint64_t targets[] = {0, 1, 1023, 1024, 5000, 12345, 19999, 8000, 3};
+  test_audio audio;
+  test_stream stream;
+  drflac* pFlac;
+  uint8_t* pIndex = NULL;
+  size_t indexSize = 0;
+
+  test_audio_init(&audio, 44100, 2, 1024, 20000, 13);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_ogg_link(&stream, &audio, 5678);
+
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL) {
+    TEST_CHECK(pFlac->container == drflac_container_ogg);
+    TEST_CHECK(drflac_build_seek_index(pFlac));
+    test_seek_and_compare(pFlac, &audio, targets, sizeof(targets) / sizeof(targets[0]));
+
+    indexSize = drflac_save_seek_index(pFlac, NULL, 0);
+    pIndex = (uint8_t*)malloc(indexSize);
+    TEST_CHECK(indexSize > 0 && pIndex != NULL);
+    if (pIndex != NULL) {
+      TEST_CHECK(drflac_save_seek_index(pFlac, pIndex, indexSize) == indexSize);
+    }
+    drflac_close(pFlac);
+  }
+
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL && pIndex != NULL) {
+    /* The entries of an index from another container mean something else. */
+    pIndex[8] = (uint8_t)drflac_container_native;
+    TEST_CHECK(!drflac_load_seek_index(pFlac, pIndex, indexSize));
+    pIndex[8] = (uint8_t)drflac_container_ogg;
+
+    TEST_CHECK(drflac_load_seek_index(pFlac, pIndex, indexSize));
+    pFlac->_noBinarySearchSeek = DRFLAC_TRUE;
+    pFlac->_noBruteForceSeek = DRFLAC_TRUE;
+    test_seek_and_compare(pFlac, &audio, targets, sizeof(targets) / sizeof(targets[0]));
+  }
+  drflac_close(pFlac);
+
+  free(pIndex);
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+#endif
+
+#ifndef DR_FLAC_NO_OGG
+static void test_chained_ogg(void) {
+  test_audio audioA;
+  test_audio audioB;
+  test_stream stream;
+  test_reader reader;
+  drflac* pFlac;
+  int32_t* pSamples;
+  size_t memorySize;
+  void* pAllocation;
+
+  /* The second link has a different format and reuses the serial number. */
+  test_audio_init(&audioA, 44100, 2, 1024, 6000, 14);
+  test_audio_init(&audioB, 22050, 1, 576, 4000, 15);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_ogg_link(&stream, &audioA, 1234);
+  test_encode_ogg_link(&stream, &audioB, 1234);
+  pSamples = (int32_t*)malloc((size_t)audioA.totalPCMFrameCount * audioA.channels * 4);
+  TEST_CHECK(pSamples != NULL);
+  if (pSamples == NULL) { return; }
+
+  /* Reading stops at the change of format, then continues into the second link. */
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL) {
+    TEST_CHECK(pFlac->container == drflac_container_ogg);
+    TEST_CHECK(drflac_enable_md5_verification(pFlac));
+    TEST_CHECK(pFlac->channels == 2 && pFlac->sampleRate == 44100);
+    TEST_CHECK(drflac_read_pcm_frames_s32(pFlac, audioA.totalPCMFrameCount + 100, pSamples) ==
+               audioA.totalPCMFrameCount);
+    TEST_CHECK(test_audio_equal(&audioA, 0, pSamples, audioA.totalPCMFrameCount));
+
+    TEST_CHECK(pFlac->channels == 1 && pFlac->sampleRate == 22050);
+    test_read_and_compare(pFlac, &audioB, 0);
+    TEST_CHECK(drflac_get_md5_result(pFlac) == drflac_md5_match);
+    TEST_CHECK(pFlac->totalPCMFrameCount ==
+               audioA.totalPCMFrameCount + audioB.totalPCMFrameCount);
+    drflac_close(pFlac);
+  }
+
+  /* Seeking into the second link once the seek index has found it. */
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL) {
+    TEST_CHECK(drflac_build_seek_index(pFlac));
+    TEST_CHECK(pFlac->totalPCMFrameCount ==
+               audioA.totalPCMFrameCount + audioB.totalPCMFrameCount);
+    TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, audioA.totalPCMFrameCount + 1500));
+    TEST_CHECK(pFlac->channels == 1 && pFlac->sampleRate == 22050);
+    test_read_and_compare(pFlac, &audioB, 1500);
+
+    TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 100));
+    TEST_CHECK(pFlac->channels == 2 && pFlac->sampleRate == 44100);
+    test_read_and_compare(pFlac, &audioA, 100);
+    drflac_close(pFlac);
+  }
+
+  /* A preallocated decoder can't add links, so it ends after the first one. */
+  reader.pData = stream.pData;
+  reader.size = stream.size;
+  reader.cursor = 0;
+  TEST_CHECK(drflac_get_preallocated_size(test_on_read, test_on_seek, NULL, &reader, &memorySize));
+  pAllocation = malloc(memorySize);
+  TEST_CHECK(pAllocation != NULL);
+  if (pAllocation != NULL) {
+    reader.cursor = 0;
+    pFlac = drflac_open_preallocated(test_on_read, test_on_seek, NULL, &reader, pAllocation,
+                                     memorySize);
+    TEST_CHECK(pFlac == pAllocation);
+    if (pFlac != NULL) {
+      test_read_and_compare(pFlac, &audioA, 0);
+      drflac_close(pFlac);
+    }
+    free(pAllocation);
+  }
+
+  free(pSamples);
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audioA);
+  test_audio_uninit(&audioB);
+}
+#endif
+
+static void test_decode_batch(void) {
+  test_audio audio[3];
+  test_stream streams[3];
+  drflac_batch_input inputs[4];
+  drflac_batch_output outputs[4];
+  uint8_t garbage[64];
+  uint64_t arenaSize;
+  uint64_t expectedArenaSize = 0;
+  uint32_t runCount = 0;
+  int32_t* pArenaS32;
+  int16_t* pArenaS16;
+  uint64_t i;
+  uint32_t iStream;
+
+  /* The last stream is cut short of the length in its STREAMINFO block. */
+  test_audio_init(&audio[0], 44100, 2, 1024, 3000, 16);
+  test_audio_init(&audio[1], 22050, 1, 576, 2000, 17);
+  test_audio_init(&audio[2], 48000, 2, 1024, 4000, 18);
+  for (iStream = 0; iStream < 3; iStream += 1) {
+    memset(&streams[iStream], 0, sizeof(streams[iStream]));
+    test_encode_native(&streams[iStream], &audio[iStream]);
+    expectedArenaSize += audio[iStream].totalPCMFrameCount * audio[iStream].channels;
+  }
+  memset(garbage, 0x55, sizeof(garbage));
+  inputs[0].pData = streams[0].pData;
+  inputs[0].dataSize = streams[0].size;
+  inputs[1].pData = streams[1].pData;
+  inputs[1].dataSize = streams[1].size;
+  inputs[2].pData = garbage;
+  inputs[2].dataSize = sizeof(garbage);
+  inputs[3].pData = streams[2].pData;
+  inputs[3].dataSize = streams[2].size / 2;
+
+  arenaSize = drflac_decode_batch_s32(inputs, 4, NULL, 0, outputs, 1, NULL, NULL, NULL);
+  TEST_CHECK(arenaSize == expectedArenaSize);
+  TEST_CHECK(outputs[2].channels == 0 && outputs[2].pcmFrameCount == 0);
+  TEST_CHECK(outputs[3].offset == arenaSize - audio[2].totalPCMFrameCount * 2);
+
+  pArenaS32 = (int32_t*)malloc((size_t)arenaSize * sizeof(int32_t));
+  pArenaS16 = (int16_t*)malloc((size_t)arenaSize * sizeof(int16_t));
+  TEST_CHECK(pArenaS32 != NULL && pArenaS16 != NULL);
+  if (pArenaS32 != NULL && pArenaS16 != NULL) {
+    TEST_CHECK(drflac_decode_batch_s32(inputs, 4, pArenaS32, arenaSize - 1, outputs, 1, NULL,
+                                       NULL, NULL) == 0);
+
+    TEST_CHECK(drflac_decode_batch_s32(inputs, 4, pArenaS32, arenaSize, outputs, 3,
+                                       test_run_jobs_backwards, &runCount, NULL) == arenaSize);
+    TEST_CHECK(runCount == 3);
+    for (iStream = 0; iStream < 2; iStream += 1) {
+      TEST_CHECK(outputs[iStream].sampleRate == audio[iStream].sampleRate);
+      TEST_CHECK(outputs[iStream].channels == audio[iStream].channels);
+      TEST_CHECK(outputs[iStream].pcmFrameCount == audio[iStream].totalPCMFrameCount);
+      TEST_CHECK(test_audio_equal(&audio[iStream], 0, pArenaS32 + outputs[iStream].offset,
+                                  outputs[iStream].pcmFrameCount));
+    }
+
+    /* The decoded part of the short stream, followed by silence. */
+    TEST_CHECK(outputs[3].pcmFrameCount > 0 &&
+               outputs[3].pcmFrameCount < audio[2].totalPCMFrameCount);
+    TEST_CHECK(test_audio_equal(&audio[2], 0, pArenaS32 + outputs[3].offset,
+                                outputs[3].pcmFrameCount));
+    for (i = outputs[3].offset + outputs[3].pcmFrameCount * 2; i < arenaSize; i += 1) {
+      if (pArenaS32[i] != 0) { break; }
+    }
+    TEST_CHECK(i == arenaSize);
+
+    TEST_CHECK(drflac_decode_batch_s16(inputs, 4, pArenaS16, arenaSize, outputs, 2, NULL, NULL,
+                                       NULL) == arenaSize);
+    TEST_CHECK(memcmp(pArenaS16 + outputs[1].offset, audio[1].pSamples,
+                      (size_t)audio[1].totalPCMFrameCount * 2) == 0);
+  }
+
+  free(pArenaS32);
+  free(pArenaS16);
+  for (iStream = 0; iStream < 3; iStream += 1) {
+    test_stream_uninit(&streams[iStream]);
+    test_audio_uninit(&audio[iStream]);
+  }
+}
+
+#ifndef DR_FLAC_NO_OGG
+static void test_ogg_bisection_seek(void) {
+  static const uint64_t targets[] = {49000, 0, 25000, 25001, 255, 256, 49999, 12345, 3};
+  test_audio audio;
+  test_stream stream;
+  test_counting_reader reader;
+  drflac* pFlac;
+
+  /* Enough pages that scanning them one by one would read most of the stream. */
+  test_audio_init(&audio, 44100, 2, 256, 50000, 19);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_ogg_link(&stream, &audio, 4321);
+
+  memset(&reader, 0, sizeof(reader));
+  reader.reader.pData = stream.pData;
+  reader.reader.size = stream.size;
+  pFlac = drflac_open(test_on_read_counting, test_on_seek, &reader, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac == NULL) { return; }
+
+  reader.bytesRead = 0;
+  TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 49000));
+  TEST_CHECK(reader.bytesRead < stream.size / 2);
+
+  test_seek_and_compare(pFlac, &audio, targets, sizeof(targets) / sizeof(targets[0]));
+  TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 30000));
+  test_read_and_compare(pFlac, &audio, 30000);
+  drflac_close(pFlac);
+
+  /* Scanning instead of bisecting reads nearly all of the stream. */
+  reader.reader.cursor = 0;
+  pFlac = drflac_open(test_on_read_counting, test_on_seek, &reader, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL) {
+    pFlac->_noBinarySearchSeek = DRFLAC_TRUE;
+    reader.bytesRead = 0;
+    TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 49000));
+    TEST_CHECK(reader.bytesRead > stream.size / 2);
+    test_read_and_compare(pFlac, &audio, 49000);
+    drflac_close(pFlac);
+  }
+
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+#endif
+
+static void test_channel_mask(void) {
+  static const uint32_t fullMasks[] = {0x3, 0xFF, 0xFFFFFFFF};
+  test_audio audio;
+  test_stream stream;
+  drflac* pFlac;
+  int32_t* pSamples;
+  uint64_t iFrame;
+  size_t iMask;
+  bool isChannelCorrect;
+
+  test_audio_init(&audio, 44100, 2, 1024, 5000, 20);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_native(&stream, &audio);
+  pSamples = (int32_t*)malloc((size_t)audio.totalPCMFrameCount * audio.channels * 4);
+  TEST_CHECK(pSamples != NULL);
+
+  /* Only the second channel, which must still be decoded correctly. */
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac != NULL && pSamples != NULL) {
+    TEST_CHECK(drflac_enable_md5_verification(pFlac));
+    TEST_CHECK(drflac_set_channel_mask(pFlac, 0x2));
+    TEST_CHECK(drflac_read_pcm_frames_s32(pFlac, audio.totalPCMFrameCount, pSamples) ==
+               audio.totalPCMFrameCount);
+
+    isChannelCorrect = DRFLAC_TRUE;
+    for (iFrame = 0; iFrame < audio.totalPCMFrameCount; iFrame += 1) {
+      if (pSamples[iFrame * 2 + 1] != (int32_t)audio.pSamples[iFrame * 2 + 1] * 65536) {
+        isChannelCorrect = DRFLAC_FALSE;
+      }
+    }
+    TEST_CHECK(isChannelCorrect);
+    TEST_CHECK(drflac_get_md5_result(pFlac) == drflac_md5_incomplete);
+  }
+  drflac_close(pFlac);
+
+  /* Any mask covering every channel the stream has decodes everything. */
+  for (iMask = 0; iMask < sizeof(fullMasks) / sizeof(fullMasks[0]); iMask += 1) {
+    pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+    TEST_CHECK(pFlac != NULL);
+    if (pFlac != NULL) {
+      TEST_CHECK(drflac_enable_md5_verification(pFlac));
+      TEST_CHECK(drflac_set_channel_mask(pFlac, fullMasks[iMask]));
+      test_read_and_compare(pFlac, &audio, 0);
+      TEST_CHECK(drflac_get_md5_result(pFlac) == drflac_md5_match);
+      drflac_close(pFlac);
+    }
+  }
+
+  /* A mask without any of the 8 channels is rejected. */
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  TEST_CHECK(!drflac_set_channel_mask(pFlac, 0xFFFFFF00));
+  drflac_close(pFlac);
+
+  free(pSamples);
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+
+static void test_read_next_flac_frame_summary(void) {
+  test_audio audio;
+  test_stream stream;
+  drflac* pFlac;
+  drflac_frame_summary summary;
+  uint64_t nextPCMFrame = 0;
+  bool isCorrect = DRFLAC_TRUE;
+  bool isSilent = DRFLAC_TRUE;
+  uint32_t iChannel;
+  uint32_t i;
+
+  test_audio_init(&audio, 44100, 2, 1024, 5000, 21);
+  memset(&stream, 0, sizeof(stream));
+  test_encode_native(&stream, &audio);
+
+  pFlac = drflac_open_memory(stream.pData, stream.size, NULL);
+  TEST_CHECK(pFlac != NULL);
+  if (pFlac == NULL) { return; }
+
+  while (drflac_read_next_flac_frame_summary(pFlac, &summary)) {
+    TEST_CHECK(summary.firstPCMFrame == nextPCMFrame);
+    TEST_CHECK(summary.channels == 2);
+    for (iChannel = 0; iChannel < 2; iChannel += 1) {
+      int16_t minSample = 32767;
+      int16_t maxSample = -32768;
+      double sumOfSquares = 0;
+      double meanSquareDifference;
+
+      for (i = 0; i < summary.pcmFrameCount; i += 1) {
+        int16_t sample = audio.pSamples[(summary.firstPCMFrame + i) * 2 + iChannel];
+        if (minSample > sample) { minSample = sample; }
+        if (maxSample < sample) { maxSample = sample; }
+        sumOfSquares += (sample / 32768.0) * (sample / 32768.0);
+      }
+      /* Squared so there's no need for libm. */
+      meanSquareDifference = (double)summary.rms[iChannel] * summary.rms[iChannel] -
+                        sumOfSquares / summary.pcmFrameCount;
+
+      if (summary.minSample[iChannel] != minSample / 32768.0f ||
+          summary.maxSample[iChannel] != maxSample / 32768.0f || meanSquareDifference > 1e-5 ||
+          meanSquareDifference < -1e-5) {
+        isCorrect = DRFLAC_FALSE;
+      }
+    }
+    nextPCMFrame = summary.firstPCMFrame + summary.pcmFrameCount;
+  }
+  TEST_CHECK(isCorrect);
+  TEST_CHECK(nextPCMFrame == audio.totalPCMFrameCount);
+
+  /* Channels outside the mask are silent. */
+  TEST_CHECK(drflac_seek_to_pcm_frame(pFlac, 0));
+  TEST_CHECK(drflac_set_channel_mask(pFlac, 0x2));
+  while (drflac_read_next_flac_frame_summary(pFlac, &summary)) {
+    if (summary.minSample[0] != 0 || summary.maxSample[0] != 0 || summary.rms[0] != 0 ||
+        summary.rms[1] == 0) {
+      isSilent = DRFLAC_FALSE;
+    }
+  }
+  TEST_CHECK(isSilent);
+  drflac_close(pFlac);
+
+  test_stream_uninit(&stream);
+  test_audio_uninit(&audio);
+}
+
+int main(void) {
+  test_decode_parallel();
+#ifndef DR_FLAC_NO_STDIO
+  test_open_file_mmap();
+#endif
+  test_read_planar();
+  test_read_next_flac_frame();
+  test_seek_index();
+  test_seek_index_fallback(DRFLAC_FALSE);
+  test_seek_index_fallback(DRFLAC_TRUE);
+  test_md5_verification();
+  test_open_with_buffer_size();
+  test_reopen();
+  test_probe();
+  test_picture();
+#ifndef DR_FLAC_NO_OGG
+  test_ogg_seek_index();
+  test_chained_ogg();
+#endif
+  test_decode_batch();
+#ifndef DR_FLAC_NO_OGG
+  test_ogg_bisection_seek();
+#endif
+  test_channel_mask();
+  test_read_next_flac_frame_summary();
+  test_preallocated();
+
+  if (g_failureCount > 0) {
+    printf("%d check(s) failed\n", g_failureCount);
+    return 1;
+  }
+
+  printf("all checks passed\n");
+  return 0;
+}